@@ -63,7 +63,7 @@ AggregateType::AggregateType(AggregateTag initTag) :
     defaultValue = gNil;
   }
 
-  gAggregateTypes.add(this);
+  registerNode(gAggregateTypes, this);
 }
 
 
@@ -36,7 +36,7 @@ CatchStmt::CatchStmt(Expr* expr, BlockStmt* body) : Stmt(E_CatchStmt) {
 
   _body->insertAtTail(body);
 
-  gCatchStmts.add(this);
+  registerNode(gCatchStmts, this);
 }
 
 CatchStmt::~CatchStmt() {
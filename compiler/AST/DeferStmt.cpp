@@ -35,7 +35,7 @@ DeferStmt::DeferStmt(BlockStmt* body)
   : Stmt(E_DeferStmt),
    _body(body) {
 
-  gDeferStmts.add(this);
+  registerNode(gDeferStmts, this);
 }
 
 DeferStmt::~DeferStmt() {
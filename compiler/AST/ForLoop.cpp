@@ -313,6 +313,7 @@ ForLoop* ForLoop::copy(SymbolMap* mapRef, bool internal)
   retval->mBreakLabel       = mBreakLabel;
   retval->mContinueLabel    = mContinueLabel;
   retval->mOrderIndependent = mOrderIndependent;
+  retval->mVectorizable     = mVectorizable;
 
   retval->mIndex            = mIndex->copy(map, true),
   retval->mIterator         = mIterator->copy(map, true);
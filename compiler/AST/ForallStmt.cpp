@@ -40,7 +40,7 @@ ForallIntent::ForallIntent(TFITag intent, Expr* var, Expr* reduceExpr):
   fiVar(var),
   riSpec(reduceExpr)
 {
-  gForallIntents.add(this);
+  registerNode(gForallIntents, this);
 }
 
 ForallIntent* ForallIntent::copyInner(SymbolMap* map) {
@@ -114,7 +114,7 @@ ForallStmt::ForallStmt(bool zippered, BlockStmt* body):
   fIterExprs.parent = this;
   fIntentVars.parent = this;
   fFIntents.parent = this;
-  gForallStmts.add(this);
+  registerNode(gForallStmts, this);
 }
 
 ForallStmt* ForallStmt::copyInner(SymbolMap* map) {
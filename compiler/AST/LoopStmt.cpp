@@ -24,6 +24,7 @@ LoopStmt::LoopStmt(BlockStmt* initBody) : BlockStmt(initBody)
   mBreakLabel       = 0;
   mContinueLabel    = 0;
   mOrderIndependent = false;
+  mVectorizable     = false;
 }
 
 LoopStmt::~LoopStmt()
@@ -66,6 +67,18 @@ void LoopStmt::orderIndependentSet(bool orderIndependent)
   mOrderIndependent = orderIndependent;
 }
 
+// Set by findVectorizableLoops() for order independent loops that carry
+// no dependence from one iteration to another
+bool LoopStmt::isVectorizable() const
+{
+  return mVectorizable;
+}
+
+void LoopStmt::vectorizableSet(bool vectorizable)
+{
+  mVectorizable = vectorizable;
+}
+
 LoopStmt* LoopStmt::findEnclosingLoop(Expr* expr)
 {
   LoopStmt* retval = NULL;
@@ -220,7 +220,7 @@ ModuleSymbol::ModuleSymbol(const char* iName,
 
   registerModule(this);
 
-  gModuleSymbols.add(this);
+  registerNode(gModuleSymbols, this);
 }
 
 
@@ -52,7 +52,7 @@ TryStmt::TryStmt(bool tryBang, BlockStmt* body, BlockStmt* catches) : Stmt(E_Try
     }
   }
 
-  gTryStmts.add(this);
+  registerNode(gTryStmts, this);
 }
 
 TryStmt::~TryStmt() {
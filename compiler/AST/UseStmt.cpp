@@ -41,7 +41,7 @@ UseStmt::UseStmt(BaseAST* source) : Stmt(E_UseStmt) {
     INT_FATAL(this, "Bad mod in UseStmt constructor");
   }
 
-  gUseStmts.add(this);
+  registerNode(gUseStmts, this);
 }
 
 UseStmt::UseStmt(BaseAST*                            source,
@@ -81,7 +81,7 @@ UseStmt::UseStmt(BaseAST*                            source,
     }
   }
 
-  gUseStmts.add(this);
+  registerNode(gUseStmts, this);
 }
 
 UseStmt* UseStmt::copyInner(SymbolMap* map) {
@@ -54,6 +54,7 @@ void WhileStmt::copyShare(const WhileStmt& ref,
   mBreakLabel       = ref.mBreakLabel;
   mContinueLabel    = ref.mContinueLabel;
   mOrderIndependent = ref.mOrderIndependent;
+  mVectorizable     = ref.mVectorizable;
 
   if (condExpr != 0)
     mCondExpr = condExpr->copy(map, true);
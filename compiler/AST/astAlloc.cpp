@@ -0,0 +1,370 @@
+/*
+ * Copyright 2004-2017 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "astAlloc.h"
+
+#include "AggregateType.h"
+#include "baseAST.h"
+#include "CatchStmt.h"
+#include "compilerThreads.h"
+#include "DeferStmt.h"
+#include "expr.h"
+#include "ForallStmt.h"
+#include "misc.h"
+#include "ModuleSymbol.h"
+#include "stmt.h"
+#include "symbol.h"
+#include "TryStmt.h"
+#include "type.h"
+#include "UseStmt.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+//
+// Slabs are kSlabSize bytes and aligned to kSlabSize so that the slab
+// owning any node can be found by masking the node's address.  The
+// slab header lives at the start of the slab.
+//
+static const size_t kSlabSize     = 64 * 1024;
+static const size_t kGranularity  = 16;
+static const size_t kMaxNodeSize  = 2048;
+static const size_t kNumClasses   = kMaxNodeSize / kGranularity;
+
+struct Slab {
+  Slab*  prev;          // links in the size class's list of
+  Slab*  next;          //   slabs that have room
+  void*  freeList;      // nodes returned to this slab
+  char*  bump;          // never-used space starts here
+  char*  end;
+  size_t nodeSize;
+  int    live;          // nodes currently allocated from this slab
+  bool   onList;
+};
+
+struct SizeClass {
+  Slab*  avail;         // slabs with at least one free node
+  int    numSlabs;
+
+  size_t allocs;        // cumulative node allocations
+  size_t frees;         // cumulative node frees
+};
+
+static SizeClass sizeClasses[kNumClasses + 1];
+
+static size_t    numSlabs          = 0;
+static size_t    maxSlabs          = 0;
+static size_t    slabsReclaimed    = 0;
+static size_t    largeAllocs       = 0;
+static size_t    largeLiveBytes    = 0;
+
+static size_t    createdByTag[E_AggregateType + 1];
+static size_t    destroyedByTag[E_AggregateType + 1];
+
+// taken while compiler threads are running
+static CompilerMutex slabMutex;
+
+static inline size_t sizeClassOf(size_t size) {
+  return (size + kGranularity - 1) / kGranularity;
+}
+
+static inline Slab* slabOf(void* ptr) {
+  return (Slab*) ((uintptr_t) ptr & ~(uintptr_t) (kSlabSize - 1));
+}
+
+static inline size_t headerSize() {
+  return (sizeof(Slab) + kGranularity - 1) & ~(kGranularity - 1);
+}
+
+static void slabListAdd(SizeClass* sc, Slab* slab) {
+  slab->prev   = NULL;
+  slab->next   = sc->avail;
+  slab->onList = true;
+
+  if (sc->avail != NULL)
+    sc->avail->prev = slab;
+
+  sc->avail = slab;
+}
+
+static void slabListRemove(SizeClass* sc, Slab* slab) {
+  if (slab->prev != NULL)
+    slab->prev->next = slab->next;
+  else
+    sc->avail = slab->next;
+
+  if (slab->next != NULL)
+    slab->next->prev = slab->prev;
+
+  slab->prev   = NULL;
+  slab->next   = NULL;
+  slab->onList = false;
+}
+
+static Slab* newSlab(size_t nodeSize) {
+  void* mem = NULL;
+
+  if (posix_memalign(&mem, kSlabSize, kSlabSize) != 0 || mem == NULL)
+    throw std::bad_alloc();
+
+  Slab* slab     = (Slab*) mem;
+
+  slab->prev     = NULL;
+  slab->next     = NULL;
+  slab->freeList = NULL;
+  slab->bump     = (char*) mem + headerSize();
+  slab->end      = (char*) mem + kSlabSize;
+  slab->nodeSize = nodeSize;
+  slab->live     = 0;
+  slab->onList   = false;
+
+  numSlabs++;
+
+  if (numSlabs > maxSlabs)
+    maxSlabs = numSlabs;
+
+  return slab;
+}
+
+static inline bool slabIsFull(Slab* slab) {
+  return slab->freeList == NULL && slab->bump + slab->nodeSize > slab->end;
+}
+
+void* astArenaAlloc(size_t size) {
+#ifdef CHPL_NO_AST_ARENA
+  void* ptr = malloc(size);
+
+  if (ptr == NULL)
+    throw std::bad_alloc();
+
+  return ptr;
+#else
+  ParallelLockGuard guard(slabMutex);
+
+  if (size > kMaxNodeSize) {
+    void* ptr = malloc(size);
+
+    if (ptr == NULL)
+      throw std::bad_alloc();
+
+    largeAllocs++;
+    largeLiveBytes += size;
+
+    return ptr;
+  }
+
+  size_t     cls  = sizeClassOf(size);
+  SizeClass* sc   = &sizeClasses[cls];
+  Slab*      slab = sc->avail;
+  void*      ptr  = NULL;
+
+  if (slab == NULL) {
+    slab = newSlab(cls * kGranularity);
+    sc->numSlabs++;
+    slabListAdd(sc, slab);
+  }
+
+  if (slab->freeList != NULL) {
+    ptr            = slab->freeList;
+    slab->freeList = *(void**) ptr;
+  } else {
+    ptr            = slab->bump;
+    slab->bump    += slab->nodeSize;
+  }
+
+  slab->live++;
+  sc->allocs++;
+
+  if (slabIsFull(slab))
+    slabListRemove(sc, slab);
+
+  return ptr;
+#endif
+}
+
+void astArenaFree(void* ptr, size_t size) {
+  if (ptr == NULL)
+    return;
+
+#ifdef CHPL_NO_AST_ARENA
+  free(ptr);
+#else
+  ParallelLockGuard guard(slabMutex);
+
+  if (size > kMaxNodeSize) {
+    largeLiveBytes -= size;
+    free(ptr);
+    return;
+  }
+
+  size_t     cls  = sizeClassOf(size);
+  SizeClass* sc   = &sizeClasses[cls];
+  Slab*      slab = slabOf(ptr);
+
+  INT_ASSERT(slab->nodeSize == cls * kGranularity);
+
+  *(void**) ptr  = slab->freeList;
+  slab->freeList = ptr;
+  slab->live--;
+  sc->frees++;
+
+  if (slab->onList == false)
+    slabListAdd(sc, slab);
+#endif
+}
+
+//
+// Hand empty slabs back to the system.  One empty slab is kept per
+// size class so that the next pass does not immediately reallocate it.
+//
+void astArenaReclaim() {
+  for (size_t cls = 1; cls <= kNumClasses; cls++) {
+    SizeClass* sc        = &sizeClasses[cls];
+    bool       keptEmpty = false;
+    Slab*      slab      = sc->avail;
+
+    while (slab != NULL) {
+      Slab* next = slab->next;
+
+      if (slab->live == 0) {
+        if (keptEmpty == false) {
+          keptEmpty = true;
+        } else {
+          slabListRemove(sc, slab);
+          free(slab);
+          sc->numSlabs--;
+          numSlabs--;
+          slabsReclaimed++;
+        }
+      }
+
+      slab = next;
+    }
+  }
+}
+
+//
+// Called once all AST nodes have been deleted at compiler exit.
+//
+void astArenaDestroy() {
+  astArenaReclaim();
+
+  for (size_t cls = 1; cls <= kNumClasses; cls++) {
+    SizeClass* sc   = &sizeClasses[cls];
+    Slab*      slab = sc->avail;
+
+    while (slab != NULL) {
+      Slab* next = slab->next;
+
+      if (slab->live == 0) {
+        slabListRemove(sc, slab);
+        free(slab);
+        sc->numSlabs--;
+        numSlabs--;
+      }
+
+      slab = next;
+    }
+  }
+}
+
+void astArenaNoteCreate(int astTag) {
+  createdByTag[astTag]++;
+}
+
+void astArenaNoteDestroy(int astTag) {
+  destroyedByTag[astTag]++;
+}
+
+//
+// Node sizes by tag.  Subclasses that share a tag (e.g. the loop
+// statements, which are all E_BlockStmt) are reported at the size of
+// the tag's class.
+//
+static size_t nodeSizeOfTag(int astTag) {
+  switch (astTag) {
+#define size_case(type) case E_##type: return sizeof(type)
+    foreach_ast(size_case);
+#undef size_case
+  }
+
+  return 0;
+}
+
+void astArenaPrintStatistics() {
+  size_t liveNodes = 0;
+  size_t slabBytes = numSlabs * kSlabSize;
+
+  fprintf(stderr, "AST arena: %lu slabs (%luK) live, %lu max (%luK), "
+                  "%lu reclaimed\n",
+          (unsigned long) numSlabs,
+          (unsigned long) (slabBytes / 1024),
+          (unsigned long) maxSlabs,
+          (unsigned long) (maxSlabs * kSlabSize / 1024),
+          (unsigned long) slabsReclaimed);
+
+  fprintf(stderr, "  %-18s %10s %10s %10s %12s\n",
+          "node type", "created", "deleted", "live", "bytes alloc");
+
+#define print_tag(type)                                                   \
+  if (createdByTag[E_##type] != 0) {                                      \
+    size_t live = createdByTag[E_##type] - destroyedByTag[E_##type];      \
+                                                                          \
+    liveNodes += live;                                                    \
+                                                                          \
+    fprintf(stderr, "  %-18s %10lu %10lu %10lu %11luK\n",                 \
+            #type,                                                        \
+            (unsigned long) createdByTag[E_##type],                       \
+            (unsigned long) destroyedByTag[E_##type],                     \
+            (unsigned long) live,                                         \
+            (unsigned long) (createdByTag[E_##type] *                     \
+                             nodeSizeOfTag(E_##type) / 1024));            \
+  }
+
+  foreach_ast(print_tag);
+
+#undef print_tag
+
+  fprintf(stderr, "  %-18s %10s %10s %10lu\n", "total", "", "",
+          (unsigned long) liveNodes);
+
+  fprintf(stderr, "  %-18s %10s %10s %10s %12s\n",
+          "size class", "allocs", "frees", "slabs", "slab bytes");
+
+  for (size_t cls = 1; cls <= kNumClasses; cls++) {
+    SizeClass* sc = &sizeClasses[cls];
+
+    if (sc->allocs != 0) {
+      fprintf(stderr, "  %-18lu %10lu %10lu %10d %11luK\n",
+              (unsigned long) (cls * kGranularity),
+              (unsigned long) sc->allocs,
+              (unsigned long) sc->frees,
+              sc->numSlabs,
+              (unsigned long) (sc->numSlabs * kSlabSize / 1024));
+    }
+  }
+
+  if (largeAllocs != 0) {
+    fprintf(stderr, "  %-18s %10lu %10s %10s %11luK\n",
+            "large (malloc)",
+            (unsigned long) largeAllocs, "", "",
+            (unsigned long) (largeLiveBytes / 1024));
+  }
+}
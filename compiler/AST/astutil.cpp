@@ -26,6 +26,7 @@
 #include "ForallStmt.h"
 #include "ForLoop.h"
 #include "expr.h"
+#include "fnNodeIndex.h"
 #include "passes.h"
 #include "ParamForLoop.h"
 #include "stlUtil.h"
@@ -560,6 +561,7 @@ void insert_help(BaseAST* ast,
         symbol->addSymExpr(se);
       }
     }
+    FnNodeIndex::reparent(expr, parentSymbol);
     expr->parentSymbol = parentSymbol;
     expr->parentExpr = parentExpr;
     parentExpr = expr;
@@ -580,6 +582,7 @@ void remove_help(BaseAST* ast, int trace_flag) {
         symbol->removeSymExpr(se);
       }
     }
+    FnNodeIndex::reparent(expr, NULL);
     expr->parentSymbol = NULL;
     expr->parentExpr = NULL;
   } else if (LabelSymbol* labsym = toLabelSymbol(ast)) {
@@ -969,13 +972,13 @@ Symbol* getSvecSymbol(CallExpr* call) {
   AggregateType* tuple = toAggregateType(type);
   SymExpr* fieldVal = toSymExpr(call->get(2));
   VarSymbol* fieldSym = toVarSymbol(fieldVal->symbol());
-  if (fieldSym) {
+  if (fieldSym && fieldSym->immediate) {
     int immediateVal = fieldSym->immediate->int_value();
 
     INT_ASSERT(immediateVal >= 1 && immediateVal <= tuple->fields.length);
     return tuple->getField(immediateVal);
   } else {
-    // GET_SVEC_MEMBER(p, i), where p is a star tuple
+    // GET_SVEC_MEMBER(p, i), where p is a star tuple and i is not a param
     return NULL;
   }
 }
@@ -19,12 +19,14 @@
 
 #include "baseAST.h"
 
+#include "astAlloc.h"
 #include "astutil.h"
 #include "CForLoop.h"
 #include "CatchStmt.h"
 #include "DeferStmt.h"
 #include "driver.h"
 #include "expr.h"
+#include "fnNodeIndex.h"
 #include "ForallStmt.h"
 #include "ForLoop.h"
 #include "log.h"
@@ -52,6 +54,8 @@ foreach_ast(decl_gvecs);
 
 static int uid = 1;
 
+CompilerMutex gvecsMutex;
+
 #define decl_counters(type)                                             \
   int n##type = g##type##s.n, k##type = n##type*sizeof(type)/1024
 
@@ -87,6 +91,9 @@ void printStatistics(const char* pass) {
       fprintf(stderr, "Maximum # of ASTS: %d\n", maxN);
       fprintf(stderr, "Maximum Size (KB): %d\n", maxK);
     }
+
+    if (strstr(fPrintStatistics, "a"))
+      astArenaPrintStatistics();
   }
 
   int nasts = foreach_ast_sep(sum_gvecs, +);
@@ -249,16 +256,28 @@ void cleanAst() {
   // clean global vectors and delete dead ast instances
   //
   foreach_ast(clean_gvec);
+
+  //
+  // the dead instances went back to their slabs; release empty slabs
+  //
+  astArenaReclaim();
 }
 
 
 void destroyAst() {
+  // the indices point at nodes that may be deleted before their function
+  forv_Vec(FnSymbol, fn, gFnSymbols) {
+    FnNodeIndex::destroy(fn);
+  }
+
   #define destroy_gvec(type)                    \
     forv_Vec(type, ast, g##type##s) {           \
       trace_remove(ast, 'z');                   \
       delete ast;                               \
     }
   foreach_ast(destroy_gvec);
+
+  astArenaDestroy();
 }
 
 
@@ -297,9 +316,18 @@ static void checkid(int id) {
 }
 
 
+static int newNodeID(AstTag type) {
+  ParallelLockGuard guard(gvecsMutex);
+
+  astArenaNoteCreate(type);
+
+  return uid++;
+}
+
+
 BaseAST::BaseAST(AstTag type) :
   astTag(type),
-  id(uid++),
+  id(newNodeID(type)),
   astloc(yystartlineno, yyfilename)
 {
   checkid(id);
@@ -320,6 +348,17 @@ const std::string BaseAST::tabText = "   ";
 
 
 BaseAST::~BaseAST() {
+  astArenaNoteDestroy(astTag);
+}
+
+
+void* BaseAST::operator new(size_t size) {
+  return astArenaAlloc(size);
+}
+
+
+void BaseAST::operator delete(void* ptr, size_t size) {
+  astArenaFree(ptr, size);
 }
 
 int BaseAST::linenum() const {
@@ -590,7 +629,7 @@ void BaseAST::printDocsDescription(const char *doc, std::ostream *file, unsigned
 }
 
 
-astlocT currentAstLoc(0,NULL);
+CHPL_THREAD_LOCAL astlocT currentAstLoc(0,NULL);
 
 void registerModule(ModuleSymbol* mod) {
   switch (mod->modTag) {
@@ -33,10 +33,13 @@
 #include <queue>
 
 
-int                                          BasicBlock::nextID     = 0;
-BasicBlock*                                  BasicBlock::basicBlock = NULL;
-Map<LabelSymbol*, std::vector<BasicBlock*>*> BasicBlock::gotoMaps;
-Map<LabelSymbol*, BasicBlock*>               BasicBlock::labelMaps;
+CHPL_THREAD_LOCAL int         BasicBlock::nextID     = 0;
+CHPL_THREAD_LOCAL BasicBlock* BasicBlock::basicBlock = NULL;
+
+CHPL_THREAD_LOCAL Map<LabelSymbol*, std::vector<BasicBlock*>*>
+                              BasicBlock::gotoMaps;
+CHPL_THREAD_LOCAL Map<LabelSymbol*, BasicBlock*>
+                              BasicBlock::labelMaps;
 
 BasicBlock::BasicBlock() {
   id = nextID++;
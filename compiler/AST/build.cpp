@@ -27,6 +27,7 @@
 #include "expr.h"
 #include "files.h"
 #include "ForLoop.h"
+#include "moduleCache.h"
 #include "ParamForLoop.h"
 #include "parser.h"
 #include "stmt.h"
@@ -38,6 +39,8 @@
 #include <map>
 #include <utility>
 
+int parseNameCounters[NUM_PARSE_NAME_COUNTERS] = { 1, 1, 1, 1, 1, 1 };
+
 static BlockStmt* findStmtWithTag(PrimitiveTag tag, BlockStmt* blockStmt);
 static void buildSerialIteratorFn(FnSymbol* fn, const char* iteratorName,
                                   Expr* expr, Expr* cond, Expr* indices,
@@ -398,6 +401,7 @@ bool processStringInRequireStmt(const char* str, bool parseTime) {
   } else {
     if (isChplSource(str)) {
       if (parseTime) {
+        moduleCacheNoteUncacheable();
         addSourceFile(str);
         return true;
       } else {
@@ -705,15 +709,14 @@ CallExpr* buildPrimitiveExpr(CallExpr* exprs) {
 
 
 FnSymbol* buildIfExpr(Expr* e, Expr* e1, Expr* e2) {
-  static int uid = 1;
-
   // MPF: as of 2017-03 this error is never reached because
   // it's a syntax error in the parser to not have an else clause
   // on an if-expr.
   if (!e2)
     USR_FATAL("if-then expressions currently require an else-clause");
 
-  FnSymbol* ifFn = new FnSymbol(astr("_if_fn", istr(uid++)));
+  FnSymbol* ifFn = new FnSymbol(astr("_if_fn",
+                                      istr(parseNameCounters[PNC_IF_FN]++)));
   ifFn->addFlag(FLAG_COMPILER_NESTED_FUNCTION);
   ifFn->addFlag(FLAG_IF_EXPR_FN);
   ifFn->addFlag(FLAG_INLINE);
@@ -740,8 +743,8 @@ FnSymbol* buildIfExpr(Expr* e, Expr* e1, Expr* e2) {
 
 
 CallExpr* buildLetExpr(BlockStmt* decls, Expr* expr) {
-  static int uid = 1;
-  FnSymbol* fn = new FnSymbol(astr("_let_fn", istr(uid++)));
+  FnSymbol* fn = new FnSymbol(astr("_let_fn",
+                                    istr(parseNameCounters[PNC_LET_FN]++)));
   fn->addFlag(FLAG_COMPILER_NESTED_FUNCTION);
   fn->addFlag(FLAG_INLINE);
   fn->insertAtTail(decls);
@@ -907,12 +910,11 @@ handleArrayTypeCase(FnSymbol* fn, Expr* indices, ArgSymbol* iteratorExprArg, Exp
 }
 
 
-static int loopexpr_uid = 1;
-
 // builds body of for expression iterator
 CallExpr*
 buildForLoopExpr(Expr* indices, Expr* iteratorExpr, Expr* expr, Expr* cond, bool maybeArrayType, bool zippered) {
-  FnSymbol* fn = new FnSymbol(astr("_seqloopexpr", istr(loopexpr_uid++)));
+  FnSymbol* fn = new FnSymbol(astr("_seqloopexpr",
+                                    istr(parseNameCounters[PNC_LOOPEXPR]++)));
   fn->addFlag(FLAG_COMPILER_NESTED_FUNCTION);
 
   // See comment in buildForallLoopExpr()
@@ -932,7 +934,8 @@ buildForLoopExpr(Expr* indices, Expr* iteratorExpr, Expr* expr, Expr* cond, bool
   iterator->addFlag(FLAG_MAYBE_REF);
   block->insertAtTail(new DefExpr(iterator));
   block->insertAtTail(new CallExpr(PRIM_MOVE, iterator, iteratorExprArg));
-  const char* iteratorName = astr("_iterator_for_loopexpr", istr(loopexpr_uid-1));
+  const char* iteratorName = astr("_iterator_for_loopexpr",
+                                  istr(parseNameCounters[PNC_LOOPEXPR] - 1));
   block->insertAtTail(new CallExpr(PRIM_RETURN, new CallExpr(iteratorName, iterator)));
 
   Expr* stmt = NULL; // Initialized by buildSerialIteratorFn
@@ -1061,7 +1064,8 @@ static CallExpr* buildForallLoopExprFromForallExpr(ForallExpr* faExpr) {
   bool  maybeArrayType = faExpr->maybeArrayType;
   bool  zippered       = faExpr->zippered;
 
-  FnSymbol* fn = new FnSymbol(astr("_parloopexpr", istr(loopexpr_uid++)));
+  FnSymbol* fn = new FnSymbol(astr("_parloopexpr",
+                                    istr(parseNameCounters[PNC_LOOPEXPR]++)));
   fn->addFlag(FLAG_COMPILER_NESTED_FUNCTION);
   fn->addFlag(FLAG_MAYBE_ARRAY_TYPE);
 
@@ -1088,7 +1092,8 @@ static CallExpr* buildForallLoopExprFromForallExpr(ForallExpr* faExpr) {
   iterator->addFlag(FLAG_MAYBE_REF);
   block->insertAtTail(new DefExpr(iterator));
   block->insertAtTail(new CallExpr(PRIM_MOVE, iterator, iteratorExprArg));
-  const char* iteratorName = astr("_iterator_for_loopexpr", istr(loopexpr_uid-1));
+  const char* iteratorName = astr("_iterator_for_loopexpr",
+                                  istr(parseNameCounters[PNC_LOOPEXPR] - 1));
   block->insertAtTail(new CallExpr(PRIM_RETURN, new CallExpr(iteratorName, iterator)));
 
   Expr* stmt = NULL; // Initialized by buildSerialIteratorFn.
@@ -2046,9 +2051,8 @@ buildReduceScanPreface2(FnSymbol* fn, Symbol* eltType, Symbol* globalOp,
 }
 
 CallExpr* buildReduceExpr(Expr* opExpr, Expr* dataExpr, bool zippered) {
-  static int uid = 1;
-
-  FnSymbol* fn = new FnSymbol(astr("chpl__reduce", istr(uid++)));
+  FnSymbol* fn = new FnSymbol(astr("chpl__reduce",
+                                    istr(parseNameCounters[PNC_REDUCE]++)));
   fn->addFlag(FLAG_COMPILER_NESTED_FUNCTION);
   fn->addFlag(FLAG_DONT_DISABLE_REMOTE_VALUE_FORWARDING);
   fn->addFlag(FLAG_INLINE);
@@ -2144,9 +2148,8 @@ CallExpr* buildReduceExpr(Expr* opExpr, Expr* dataExpr, bool zippered) {
 
 
 CallExpr* buildScanExpr(Expr* opExpr, Expr* dataExpr, bool zippered) {
-  static int uid = 1;
-
-  FnSymbol* fn = new FnSymbol(astr("chpl__scan", istr(uid++)));
+  FnSymbol* fn = new FnSymbol(astr("chpl__scan",
+                                    istr(parseNameCounters[PNC_SCAN]++)));
   fn->addFlag(FLAG_COMPILER_NESTED_FUNCTION);
 
   // data will hold the reduce-d expression as an argument
@@ -2269,6 +2272,26 @@ BlockStmt* buildVarDecls(BlockStmt* stmts, std::set<Flag> flags, const char* doc
 }
 
 
+// Hook the string type in the modules
+// to avoid duplication with dtString created in initPrimitiveTypes().
+// gatherWellKnownTypes runs too late to help.
+AggregateType* adoptStringType(AggregateType* ct) {
+  *dtString = *ct;
+
+  // These fields get overwritten with `ct` by the assignment.
+  // These fields are set to `this` by the AggregateType constructor
+  // so they should still be `dtString`. Fix them back up.
+  dtString->fields.parent   = dtString;
+  dtString->inherits.parent = dtString;
+
+  gAggregateTypes.remove(gAggregateTypes.index(ct));
+
+  delete ct;
+
+  return dtString;
+}
+
+
 DefExpr* buildClassDefExpr(const char*  name,
                            const char*  cname,
                            AggregateTag tag,
@@ -2278,23 +2301,8 @@ DefExpr* buildClassDefExpr(const char*  name,
                            const char*  docs) {
   AggregateType* ct = new AggregateType(tag);
 
-  // Hook the string type in the modules
-  // to avoid duplication with dtString created in initPrimitiveTypes().
-  // gatherWellKnownTypes runs too late to help.
   if (strcmp("string", name) == 0) {
-    *dtString = *ct;
-
-    // These fields get overwritten with `ct` by the assignment.
-    // These fields are set to `this` by the AggregateType constructor
-    // so they should still be `dtString`. Fix them back up.
-    dtString->fields.parent   = dtString;
-    dtString->inherits.parent = dtString;
-
-    gAggregateTypes.remove(gAggregateTypes.index(ct));
-
-    delete ct;
-
-    ct = dtString;
+    ct = adoptStringType(ct);
   }
 
   INT_ASSERT(ct);
@@ -2575,8 +2583,8 @@ DefExpr* buildForwardingExprFnDef(Expr* expr) {
   // Put expr into a method and return the DefExpr for that method.
   // This way, we can work with the rest of the compiler that
   // assumes that 'this' is an ArgSymbol.
-  static int delegate_counter = 0;
-  const char* name = astr("forwarding_expr", istr(++delegate_counter));
+  const char* name = astr("forwarding_expr",
+                          istr(parseNameCounters[PNC_FORWARDING]++));
   if (UnresolvedSymExpr* usex = toUnresolvedSymExpr(expr))
     name = astr(name, "_", usex->unresolved);
   FnSymbol* fn = new FnSymbol(name);
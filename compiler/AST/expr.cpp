@@ -58,6 +58,7 @@ Expr::Expr(AstTag astTag) :
   BaseAST(astTag),
   parentSymbol(NULL),
   parentExpr(NULL),
+  fnNodeIndexSlot(-1),
   list(NULL),
   prev(NULL),
   next(NULL)
@@ -510,7 +511,7 @@ SymExpr::SymExpr(Symbol* init_var) :
 {
   if (!init_var)
     INT_FATAL(this, "Bad call to SymExpr");
-  gSymExprs.add(this);
+  registerNode(gSymExprs, this);
 
   // No need to call var->addSymExpr here since it will be called
   // when the SymExpr is added to the tree.
@@ -636,7 +637,7 @@ UnresolvedSymExpr::UnresolvedSymExpr(const char* i_unresolved) :
 {
   if (!i_unresolved)
     INT_FATAL(this, "bad call to UnresolvedSymExpr");
-  gUnresolvedSymExprs.add(this);
+  registerNode(gUnresolvedSymExprs, this);
 }
 
 void
@@ -717,7 +718,7 @@ DefExpr::DefExpr(Symbol* initSym, BaseAST* initInit, BaseAST* initExprType) :
   if (isArgSymbol(sym) && (exprType || init))
     INT_FATAL(this, "DefExpr of ArgSymbol cannot have either exprType or init");
 
-  gDefExprs.add(this);
+  registerNode(gDefExprs, this);
 }
 
 Expr* DefExpr::getFirstChild() {
@@ -837,7 +838,7 @@ CallExpr::CallExpr(BaseAST* base,
 
   argList.parent = this;
 
-  gCallExprs.add(this);
+  registerNode(gCallExprs, this);
 }
 
 
@@ -862,7 +863,7 @@ CallExpr::CallExpr(PrimitiveOp* prim,
 
   argList.parent = this;
 
-  gCallExprs.add(this);
+  registerNode(gCallExprs, this);
 }
 
 CallExpr::CallExpr(PrimitiveTag prim,
@@ -886,7 +887,7 @@ CallExpr::CallExpr(PrimitiveTag prim,
 
   argList.parent = this;
 
-  gCallExprs.add(this);
+  registerNode(gCallExprs, this);
 }
 
 
@@ -911,7 +912,7 @@ CallExpr::CallExpr(const char* name,
 
   argList.parent = this;
 
-  gCallExprs.add(this);
+  registerNode(gCallExprs, this);
 }
 
 
@@ -1441,7 +1442,7 @@ ContextCallExpr::ContextCallExpr() :
   options()
 {
   options.parent = this;
-  gContextCallExprs.add(this);
+  registerNode(gContextCallExprs, this);
 }
 
 ContextCallExpr*
@@ -1593,7 +1594,7 @@ ForallExpr::ForallExpr(Expr* indices,
   maybeArrayType(maybeArrayType),
   zippered(zippered)
 {
-  gForallExprs.add(this);
+  registerNode(gForallExprs, this);
 }
 
 ForallExpr* ForallExpr::copyInner(SymbolMap* map) {
@@ -1649,7 +1650,7 @@ NamedExpr::NamedExpr(const char* init_name, Expr* init_actual) :
   name(astr(init_name)),
   actual(init_actual)
 {
-  gNamedExprs.add(this);
+  registerNode(gNamedExprs, this);
 }
 
 
@@ -0,0 +1,172 @@
+/*
+ * Copyright 2004-2017 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "fnNodeIndex.h"
+
+#include "astutil.h"
+#include "stlUtil.h"
+
+FnNodeIndex::FnNodeIndex() {
+
+}
+
+//
+// Build the index from a walk of the function the first time it is
+// needed.  Every later change goes through reparent().
+//
+FnNodeIndex* FnNodeIndex::get(FnSymbol* fn) {
+  if (fn->nodeIndex == NULL) {
+    std::vector<BaseAST*> asts;
+
+    collect_asts(fn, asts);
+
+    fn->nodeIndex = new FnNodeIndex();
+
+    for_vector(BaseAST, ast, asts) {
+      Expr* expr = toExpr(ast);
+
+      if (expr != NULL && expr->parentSymbol == fn)
+        fn->nodeIndex->add(expr);
+    }
+  }
+
+  return fn->nodeIndex;
+}
+
+static void forgetSlots(const std::vector<Expr*>& list) {
+  for_vector(Expr, expr, list) {
+    expr->fnNodeIndexSlot = -1;
+  }
+}
+
+void FnNodeIndex::destroy(FnSymbol* fn) {
+  if (FnNodeIndex* index = fn->nodeIndex) {
+    // the listed nodes outlive the index; forget their slots
+    forgetSlots(index->calls);
+    forgetSlots(index->symExprs);
+    forgetSlots(index->defs);
+
+    delete index;
+
+    fn->nodeIndex = NULL;
+  }
+}
+
+std::vector<Expr*>* FnNodeIndex::listFor(Expr* expr) {
+  std::vector<Expr*>* retval = NULL;
+
+  switch (expr->astTag) {
+  case E_CallExpr:
+    retval = &calls;
+    break;
+
+  case E_SymExpr:
+    retval = &symExprs;
+    break;
+
+  case E_DefExpr:
+    retval = &defs;
+    break;
+
+  default:
+    break;
+  }
+
+  return retval;
+}
+
+void FnNodeIndex::add(Expr* expr) {
+  if (std::vector<Expr*>* list = listFor(expr)) {
+    expr->fnNodeIndexSlot = (int) list->size();
+
+    list->push_back(expr);
+  }
+}
+
+// Move the last node into the removed node's slot
+void FnNodeIndex::remove(Expr* expr) {
+  std::vector<Expr*>* list = listFor(expr);
+  int                 slot = expr->fnNodeIndexSlot;
+  Expr*               last = list->back();
+
+  INT_ASSERT(slot >= 0 && (*list)[slot] == expr);
+
+  (*list)[slot]         = last;
+  last->fnNodeIndexSlot = slot;
+
+  list->pop_back();
+
+  expr->fnNodeIndexSlot = -1;
+}
+
+void FnNodeIndex::reparentSlow(Expr* expr, Symbol* newParent) {
+  if (expr->fnNodeIndexSlot >= 0)
+    toFnSymbol(expr->parentSymbol)->nodeIndex->remove(expr);
+
+  if (FnSymbol* fn = toFnSymbol(newParent)) {
+    if (fn->nodeIndex != NULL)
+      fn->nodeIndex->add(expr);
+  }
+}
+
+void FnNodeIndex::verify(FnSymbol* fn) const {
+  const std::vector<Expr*>* lists[] = { &calls, &symExprs, &defs };
+
+  for (int i = 0; i < 3; i++) {
+    const std::vector<Expr*>& list = *lists[i];
+
+    for (size_t slot = 0; slot < list.size(); slot++) {
+      if (list[slot]->parentSymbol != fn)
+        INT_FATAL(list[slot], "Node index lists a node of another function");
+
+      if (list[slot]->fnNodeIndexSlot != (int) slot)
+        INT_FATAL(list[slot], "Bad Expr::fnNodeIndexSlot");
+    }
+  }
+}
+
+void fnCallExprs(FnSymbol* fn, std::vector<CallExpr*>& calls) {
+  FnNodeIndex* index = FnNodeIndex::get(fn);
+
+  calls.reserve(calls.size() + index->calls.size());
+
+  for_vector(Expr, call, index->calls) {
+    calls.push_back(toCallExpr(call));
+  }
+}
+
+void fnSymExprs(FnSymbol* fn, std::vector<SymExpr*>& symExprs) {
+  FnNodeIndex* index = FnNodeIndex::get(fn);
+
+  symExprs.reserve(symExprs.size() + index->symExprs.size());
+
+  for_vector(Expr, se, index->symExprs) {
+    symExprs.push_back(toSymExpr(se));
+  }
+}
+
+void fnDefExprs(FnSymbol* fn, std::vector<DefExpr*>& defs) {
+  FnNodeIndex* index = FnNodeIndex::get(fn);
+
+  defs.reserve(defs.size() + index->defs.size());
+
+  for_vector(Expr, def, index->defs) {
+    defs.push_back(toDefExpr(def));
+  }
+}
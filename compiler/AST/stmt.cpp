@@ -37,7 +37,7 @@
 Map<GotoStmt*,GotoStmt*> copiedIterResumeGotos;
 
 // remember these so we can remove their iterResumeGoto
-Vec<LabelSymbol*> removedIterResumeLabels;
+CHPL_THREAD_LOCAL Vec<LabelSymbol*> removedIterResumeLabels;
 
 /******************************** | *********************************
 *                                                                   *
@@ -77,7 +77,7 @@ BlockStmt::BlockStmt(Expr* initBody, BlockTag initBlockTag) :
   if (initBody)
     body.insertAtTail(initBody);
 
-  gBlockStmts.add(this);
+  registerNode(gBlockStmts, this);
 }
 
 
@@ -589,7 +589,7 @@ CondStmt::CondStmt(Expr* iCondExpr, BaseAST* iThenStmt, BaseAST* iElseStmt) :
     }
   }
 
-  gCondStmts.add(this);
+  registerNode(gCondStmts, this);
 }
 
 Expr*
@@ -746,7 +746,7 @@ GotoStmt::GotoStmt(GotoTag init_gotoTag, const char* init_label) :
   label(init_label ? (Expr*)new UnresolvedSymExpr(init_label)
                    : (Expr*)new SymExpr(gNil))
 {
-  gGotoStmts.add(this);
+  registerNode(gGotoStmts, this);
 }
 
 
@@ -755,7 +755,7 @@ GotoStmt::GotoStmt(GotoTag init_gotoTag, Symbol* init_label) :
   gotoTag(init_gotoTag),
   label(new SymExpr(init_label))
 {
-  gGotoStmts.add(this);
+  registerNode(gGotoStmts, this);
 }
 
 
@@ -770,7 +770,7 @@ GotoStmt::GotoStmt(GotoTag init_gotoTag, Expr* init_label) :
   if (init_label->parentSymbol)
     INT_FATAL(this, "GotoStmt initialized with label already in tree");
 
-  gGotoStmts.add(this);
+  registerNode(gGotoStmts, this);
 }
 
 
@@ -940,7 +940,7 @@ ExternBlockStmt::ExternBlockStmt(const char* init_c_code) :
   Stmt(E_ExternBlockStmt),
   c_code(init_c_code)
 {
-  gExternBlockStmts.add(this);
+  registerNode(gExternBlockStmts, this);
 }
 
 void ExternBlockStmt::verify() {
@@ -991,7 +991,7 @@ ForwardingStmt::ForwardingStmt(DefExpr* toFnDef) :
   renamed(),
   except(false)
 {
-  gForwardingStmts.add(this);
+  registerNode(gForwardingStmts, this);
 
   if (toFnDef)
     if (FnSymbol* fn = toFnSymbol(toFnDef->sym))
@@ -1007,7 +1007,7 @@ ForwardingStmt::ForwardingStmt(DefExpr* toFnDef, std::set<const char*>* args, bo
   renamed(),
   except(exclude)
 {
-  gForwardingStmts.add(this);
+  registerNode(gForwardingStmts, this);
 
   if (toFnDef)
     if (FnSymbol* fn = toFnSymbol(toFnDef->sym))
@@ -31,6 +31,7 @@
 #include "expandVarArgs.h"
 #include "expr.h"
 #include "files.h"
+#include "fnNodeIndex.h"
 #include "intlimits.h"
 #include "iterator.h"
 #include "misc.h"
@@ -285,7 +286,20 @@ bool Symbol::noDocGen() const {
 }
 
 
+//
+// Compiler threads editing different functions still share the
+// SymExpr lists of globals, functions and literals.  Spread those
+// lists over a few locks.
+//
+static const int     kNumSymExprListMutexes = 64;
+static CompilerMutex symExprListMutexes[kNumSymExprListMutexes];
+
+static inline CompilerMutex& symExprListMutex(const Symbol* sym) {
+  return symExprListMutexes[sym->id % kNumSymExprListMutexes];
+}
+
 void Symbol::addSymExpr(SymExpr* se) {
+  ParallelLockGuard guard(symExprListMutex(this));
 
   // MPF 2016-11-08: Consider not tracking SymExprs
   // that refer to Symbols that have an immediate.
@@ -309,6 +323,8 @@ void Symbol::addSymExpr(SymExpr* se) {
 }
 
 void Symbol::removeSymExpr(SymExpr* se) {
+  ParallelLockGuard guard(symExprListMutex(this));
+
   SymExpr*& prev = se->symbolSymExprsPrev;
   SymExpr*& next = se->symbolSymExprsNext;
   if (next)
@@ -520,7 +536,7 @@ VarSymbol::VarSymbol(const char *init_name,
   llvmDIGlobalVariable(NULL),
   llvmDIVariable(NULL)
 {
-  gVarSymbols.add(this);
+  registerNode(gVarSymbols, this);
   if (type == dtUnknown || type->symbol == NULL) {
     this->qual = QUAL_UNKNOWN;
   } else if (type->symbol->hasFlag(FLAG_REF)) {
@@ -700,7 +716,7 @@ ArgSymbol::ArgSymbol(IntentTag iIntent, const char* iName,
     variableExpr = block;
   else
     variableExpr = new BlockStmt(iVariableExpr, BLOCK_SCOPELESS);
-  gArgSymbols.add(this);
+  registerNode(gArgSymbols, this);
 }
 
 
@@ -886,7 +902,7 @@ TypeSymbol::TypeSymbol(const char* init_name, Type* init_type) :
   if (!type)
     INT_FATAL(this, "TypeSymbol constructor called without type");
   type->addSymbol(this);
-  gTypeSymbols.add(this);
+  registerNode(gTypeSymbols, this);
 }
 
 
@@ -1035,6 +1051,7 @@ FnSymbol::FnSymbol(const char* initName) : Symbol(E_FnSymbol, initName) {
   instantiationPoint = NULL;
   basicBlocks        = NULL;
   calledBy           = NULL;
+  nodeIndex          = NULL;
   userString         = NULL;
   valueFunction      = NULL;
   codegenUniqueNum   = 1;
@@ -1045,7 +1062,7 @@ FnSymbol::FnSymbol(const char* initName) : Symbol(E_FnSymbol, initName) {
 
   substitutions.clear();
 
-  gFnSymbols.add(this);
+  registerNode(gFnSymbols, this);
 
   formals.parent = this;
 }
@@ -1072,6 +1089,8 @@ FnSymbol::~FnSymbol() {
   if (calledBy) {
     delete calledBy;
   }
+
+  FnNodeIndex::destroy(this);
 }
 
 
@@ -1095,6 +1114,8 @@ void FnSymbol::verify() {
     INT_FATAL(this, "Bad FnSymbol::retExprType::parentSymbol");
   if (body && body->parentSymbol != this)
     INT_FATAL(this, "Bad FnSymbol::body::parentSymbol");
+  if (nodeIndex)
+    nodeIndex->verify(this);
 
   verifyInTree(retType, "FnSymbol::retType");
   verifyNotOnList(where);
@@ -1886,7 +1907,7 @@ bool FnSymbol::retExprDefinesNonVoid() const {
 
 EnumSymbol::EnumSymbol(const char* init_name) :
   Symbol(E_EnumSymbol, init_name) {
-  gEnumSymbols.add(this);
+  registerNode(gEnumSymbols, this);
 }
 
 void EnumSymbol::verify() {
@@ -1934,7 +1955,7 @@ LabelSymbol::LabelSymbol(const char* init_name) :
   Symbol(E_LabelSymbol, init_name, NULL),
   iterResumeGoto(NULL)
 {
-  gLabelSymbols.add(this);
+  registerNode(gLabelSymbols, this);
 }
 
 
@@ -179,7 +179,7 @@ PrimitiveType::PrimitiveType(Symbol *init, bool internalType) :
   Type(E_PrimitiveType, init)
 {
   isInternalType = internalType;
-  gPrimitiveTypes.add(this);
+  registerNode(gPrimitiveTypes, this);
 }
 
 
@@ -261,7 +261,7 @@ EnumType::EnumType() :
   constants(), integerType(NULL),
   doc(NULL)
 {
-  gEnumTypes.add(this);
+  registerNode(gEnumTypes, this);
   constants.parent = this;
 }
 
@@ -175,7 +175,7 @@ GenRet CForLoop::codegen()
     info->lvt->addLayer();
 
     llvm::MDNode* loopMetadata = nullptr;
-    if(fNoVectorize == false && isOrderIndependent()) {
+    if(needsVectorizationHint()) {
       loopMetadata = generateLoopMetadata(false);
       info->loopStack.emplace(loopMetadata, true);
     }
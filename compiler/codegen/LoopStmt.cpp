@@ -22,12 +22,21 @@
 #include "codegen.h"
 #include "driver.h"
 
-// If vectorization is enabled and this loop is order independent, codegen
-// CHPL_PRAGMA_IVDEP. This method is a no-op if vectorization is off, or the
-// loop is not order independent.
+// --vectorize trusts every order independent loop; --vectorize-safe-loops
+// only those that findVectorizableLoops() proved free of dependences.
+bool LoopStmt::needsVectorizationHint() const
+{
+  return isOrderIndependent() &&
+         (fNoVectorize == false ||
+          (fNoVectorizeSafeLoops == false && isVectorizable()));
+}
+
+// If this loop needs a vectorization hint, codegen CHPL_PRAGMA_IVDEP. This
+// method is a no-op if vectorization is off, or the loop is not order
+// independent.
 void LoopStmt::codegenOrderIndependence()
 {
-  if (fNoVectorize == false && isOrderIndependent())
+  if (needsVectorizationHint())
   {
     GenInfo* info = gGenInfo;
 
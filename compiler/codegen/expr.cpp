@@ -5444,6 +5444,9 @@ void CallExpr::codegenInvokeOnFun() {
   if (fn->hasFlag(FLAG_NON_BLOCKING))
     fname = "chpl_executeOnNB";
 
+  else if (fn->hasFlag(FLAG_FAST_ON_NB))
+    fname = "chpl_executeOnFastNB";
+
   else if (fn->hasFlag(FLAG_FAST_ON))
     fname = "chpl_executeOnFast";
 
@@ -26,6 +26,8 @@ class ForLoop;
 
 class CForLoop : public LoopStmt
 {
+  friend class ModuleCache;
+
   //
   // Class interface
   //
@@ -24,6 +24,7 @@
 
 class DeferStmt : public Stmt
 {
+  friend class ModuleCache;
 
 public:
 
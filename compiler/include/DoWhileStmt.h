@@ -24,6 +24,8 @@
 
 class DoWhileStmt : public WhileStmt
 {
+  friend class ModuleCache;
+
   //
   // Class interface
   //
@@ -30,6 +30,8 @@
 // iteration.
 class ForLoop : public LoopStmt
 {
+  friend class ModuleCache;
+
   //
   // Class interface
   //
@@ -29,6 +29,8 @@
 
 class ForallIntent : public Expr 
 {
+  friend class ModuleCache;
+
 public:
   TFITag intent()      const;
   Expr*  variable()    const;  // non-NULL always
@@ -66,6 +68,8 @@ inline bool   ForallIntent::isReduce()   const { return fiIntent==TFI_REDUCE; }
 
 class ForallStmt : public Stmt
 {
+  friend class ModuleCache;
+
 public:
   bool       zippered()       const; // was 'zip' keyword used?
   AList&     inductionVariables();   // DefExprs, one per iterated expr
@@ -41,6 +41,9 @@ public:
   bool                   isOrderIndependent()                            const;
   void                   orderIndependentSet(bool b);
 
+  bool                   isVectorizable()                                const;
+  void                   vectorizableSet(bool b);
+
 protected:
                          LoopStmt(BlockStmt* initBody);
   virtual               ~LoopStmt();
@@ -48,6 +51,8 @@ protected:
   LabelSymbol*           mBreakLabel;
   LabelSymbol*           mContinueLabel;
   bool                   mOrderIndependent;
+  bool                   mVectorizable;
+  bool                   needsVectorizationHint()                        const;
   void                   codegenOrderIndependence();
 
 
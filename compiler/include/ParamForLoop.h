@@ -24,6 +24,8 @@
 
 class ParamForLoop : public LoopStmt
 {
+  friend class ModuleCache;
+
   //
   // Class interface
   //
@@ -24,6 +24,7 @@
 
 class TryStmt : public Stmt
 {
+  friend class ModuleCache;
 
 public:
 
@@ -25,6 +25,8 @@
 class ResolveScope;
 
 class UseStmt : public Stmt {
+  friend class ModuleCache;
+
 public:
                   UseStmt(BaseAST* source);
 
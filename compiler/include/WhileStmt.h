@@ -24,6 +24,8 @@
 
 class WhileStmt : public LoopStmt
 {
+  friend class ModuleCache;
+
 public:
   Expr*                  condExprGet()                                const;
   SymExpr*               condExprForTmpVariableGet()                  const;
@@ -0,0 +1,61 @@
+/*
+ * Copyright 2004-2017 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//
+// Slab allocator for AST nodes
+// ----------------------------
+//
+// Every BaseAST subclass is allocated through BaseAST::operator new,
+// which carves nodes out of large, aligned slabs that are segregated
+// by (rounded) object size.  Nodes of the same size class are packed
+// together, so the millions of SymExprs and CallExprs created for a
+// large program cost one malloc per slab rather than one per node.
+//
+// Dead nodes are returned to their slab by cleanAst() (via the
+// normal 'delete'), and astArenaReclaim() then hands completely
+// empty slabs back to the system in bulk.
+//
+// Objects larger than the biggest size class fall back to malloc.
+//
+// Defining CHPL_NO_AST_ARENA when building the compiler routes every
+// node through malloc/free, which is useful under valgrind.
+//
+
+#ifndef _AST_ALLOC_H_
+#define _AST_ALLOC_H_
+
+#include <cstddef>
+
+void*  astArenaAlloc(size_t size);
+void   astArenaFree(void* ptr, size_t size);
+
+// return empty slabs to the system; called at the end of cleanAst()
+void   astArenaReclaim();
+
+// release everything; called by destroyAst()
+void   astArenaDestroy();
+
+// per node-type creation counts, maintained by BaseAST's ctor/dtor
+void   astArenaNoteCreate(int astTag);
+void   astArenaNoteDestroy(int astTag);
+
+// print arena statistics (--print-statistics=a)
+void   astArenaPrintStatistics();
+
+#endif
@@ -36,6 +36,7 @@
 #include <ostream>
 #include <string>
 
+#include "compilerThreads.h"
 #include "map.h"
 #include "vec.h"
 
@@ -130,6 +131,16 @@ def_vec_hash(BaseAST);
 foreach_ast(decl_gvecs);
 #undef decl_gvecs
 
+extern CompilerMutex gvecsMutex;
+
+// add a node to its global vector; called from each node constructor
+template <typename T>
+inline void registerNode(Vec<T*>& gvec, T* node) {
+  ParallelLockGuard guard(gvecsMutex);
+
+  gvec.add(node);
+}
+
 //
 // type definitions for common maps
 //
@@ -272,6 +283,10 @@ public:
 
   static  const       std::string tabText;
 
+  // all AST nodes are carved out of the slab allocator in astAlloc.h
+  static void*      operator new(size_t size);
+  static void       operator delete(void* ptr, size_t size);
+
 protected:
                     BaseAST(AstTag type);
   virtual          ~BaseAST();
@@ -307,7 +322,7 @@ void   trace_remove(BaseAST* ast, char flag);
 //
 #define SET_LINENO(ast) astlocMarker markAstLoc(ast->astloc)
 
-extern astlocT currentAstLoc;
+extern CHPL_THREAD_LOCAL astlocT currentAstLoc;
 
 class astlocMarker {
 public:
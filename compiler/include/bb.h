@@ -28,6 +28,7 @@ class Stmt;
 class Symbol;
 class SymExpr;
 
+#include "compilerThreads.h"
 #include "map.h"
 
 #include <vector>
@@ -89,9 +90,10 @@ public:
   static void        printBitVectorSets(BitVecVector& sets);
 
 
-  static BasicBlock*                          basicBlock;
-  static Map<LabelSymbol*, BasicBlock*>       labelMaps;
-  static Map<LabelSymbol*, BasicBlockVector*> gotoMaps;
+  // builder state; per thread so that passes can run in parallel
+  static CHPL_THREAD_LOCAL BasicBlock*                          basicBlock;
+  static CHPL_THREAD_LOCAL Map<LabelSymbol*, BasicBlock*>       labelMaps;
+  static CHPL_THREAD_LOCAL Map<LabelSymbol*, BasicBlockVector*> gotoMaps;
 
 private:
   static void        buildBasicBlocks(FnSymbol* fn,
@@ -108,7 +110,7 @@ private:
   static void        removeEmptyBlocks(FnSymbol* fn);
   static bool        verifyBasicBlocks(FnSymbol* fn);
 
-  static int         nextID;
+  static CHPL_THREAD_LOCAL int nextID;
 
   //
   // Instance methods/variables
@@ -28,6 +28,7 @@
 #include "stmt.h"
 #include "vec.h"
 
+class AggregateType;
 class BaseAST;
 class BlockStmt;
 class CallExpr;
@@ -37,6 +38,24 @@ class FnSymbol;
 class ModuleSymbol;
 class Type;
 
+//
+// The parser names the functions it builds for if-exprs, let-exprs,
+// loop-exprs, reductions, scans and forwarding exprs by appending a
+// counter to a fixed prefix.  The counters are visible so that the
+// module cache can renumber the names in a module that it loads.
+//
+enum ParseNameCounter {
+  PNC_IF_FN,
+  PNC_LET_FN,
+  PNC_LOOPEXPR,
+  PNC_REDUCE,
+  PNC_SCAN,
+  PNC_FORWARDING,
+  NUM_PARSE_NAME_COUNTERS
+};
+
+extern int parseNameCounters[NUM_PARSE_NAME_COUNTERS];
+
 BlockStmt* buildPragmaStmt(Vec<const char*>*, BlockStmt*);
 
 CallExpr* buildOneTuple(Expr* elem);
@@ -125,6 +144,8 @@ CallExpr* buildScanExpr(Expr* op, Expr* data, bool zippered = false);
 
 BlockStmt* buildVarDecls(BlockStmt* stmts, std::set<Flag> flags, const char* docs);
 
+AggregateType* adoptStringType(AggregateType* ct);
+
 DefExpr*  buildClassDefExpr(const char*   name,
                             const char*   cname,
                             AggregateTag  tag,
@@ -48,6 +48,7 @@ void check_parallel();
 void check_prune();
 void check_bulkCopyRecords();
 void check_removeUnnecessaryAutoCopyCalls();
+void check_elideCopies();
 void check_inlineFunctions();
 void check_scalarReplace();
 void check_refPropagation();
@@ -57,12 +58,15 @@ void check_removeWrapRecords();
 void check_removeEmptyRecords();
 void check_localizeGlobals();
 void check_loopInvariantCodeMotion();
+void check_stackAllocateClasses();
 void check_prune2();
 void check_returnStarTuplesByRefArgs();
 void check_insertWideReferences();
 void check_optimizeOnClauses();
+void check_bulkRemoteAccess();
 void check_addInitCalls();
 void check_insertLineNumbers();
+void check_findVectorizableLoops();
 void check_denormalize();
 void check_codegen();
 void check_makeBinary();
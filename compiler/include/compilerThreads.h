@@ -0,0 +1,95 @@
+/*
+ * Copyright 2004-2017 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//
+// Compiler threads
+// ----------------
+//
+// The compiler is single threaded except inside forEachFnInParallel(),
+// which applies an intra-procedural transformation to a set of
+// functions using --compiler-threads worker threads.
+//
+// While the workers run, inParallelRegion is true and the global state
+// that creating and editing AST nodes touches is locked: node ids and
+// the g<Type>s vectors, the AST arena, the astr() table and the SymExpr
+// list of each Symbol.  State that only matters while one function is
+// being transformed (the current line number, the basic block builder,
+// the removed iterator resume labels) is kept per thread.
+//
+// A body run by forEachFnInParallel() may read other functions but
+// must only change the function it is given, and must not delete AST
+// nodes; removed nodes are reclaimed by the next cleanAst() as usual.
+//
+
+#ifndef _COMPILER_THREADS_H_
+#define _COMPILER_THREADS_H_
+
+#include "vec.h"
+
+#include <pthread.h>
+
+class FnSymbol;
+
+//
+// Per-thread state needs C++11 thread_local for its non-POD types.  A
+// compiler built without it runs every pass on the main thread.
+//
+#if __cplusplus >= 201103L
+#define HAVE_COMPILER_THREADS 1
+#define CHPL_THREAD_LOCAL     thread_local
+#else
+#define CHPL_THREAD_LOCAL
+#endif
+
+extern bool inParallelRegion;
+
+class CompilerMutex {
+public:
+                  CompilerMutex();
+                 ~CompilerMutex();
+
+  void            lock();
+  void            unlock();
+
+private:
+  pthread_mutex_t mMutex;
+};
+
+// holds 'mutex' for its lifetime, but only while workers are running
+class ParallelLockGuard {
+public:
+  ParallelLockGuard(CompilerMutex& mutex) :
+    mMutex(inParallelRegion ? &mutex : NULL) {
+    if (mMutex != NULL)
+      mMutex->lock();
+  }
+
+  ~ParallelLockGuard() {
+    if (mMutex != NULL)
+      mMutex->unlock();
+  }
+
+private:
+  CompilerMutex*  mMutex;
+};
+
+// apply 'body' to each function in 'fns', in parallel if allowed
+void forEachFnInParallel(Vec<FnSymbol*>& fns, void (*body)(FnSymbol* fn));
+
+#endif
@@ -33,14 +33,18 @@ extern int  instantiation_limit;
 
 // optimization control flags
 extern bool fFastFlag;
+extern bool fAstrBenchmark;
 extern bool fNoBoundsChecks;
 extern bool fNoCopyPropagation;
+extern bool fNoCopyElision;
 extern bool fNoDeadCodeElimination;
 extern bool fNoGlobalConstOpt;
 extern bool fNoFastFollowers;
 extern bool fNoInlineIterators;
 extern bool fNoloopInvariantCodeMotion;
 extern bool fNoInline;
+extern bool fNoAutoInline;
+extern bool fNoAutoLocalAccess;
 extern bool fNoLiveAnalysis;
 extern bool fNoFormalDomainChecks;
 extern bool fNoLocalChecks;
@@ -55,11 +59,14 @@ extern bool fLLVMWideOpt;
 extern bool fNoRemoteValueForwarding;
 extern bool fNoRemoveCopyCalls;
 extern bool fNoScalarReplacement;
+extern bool fNoStackAllocateClasses;
 extern bool fNoTupleCopyOpt;
 extern bool fNoOptimizeLoopIterators;
 extern bool fNoVectorize;
+extern bool fNoVectorizeSafeLoops;
 extern bool fNoPrivatization;
 extern bool fNoOptimizeOnClauses;
+extern bool fNoBulkRemoteAccess;
 extern bool fNoRemoveEmptyRecords;
 extern bool fNoInferLocalFields;
 extern bool fRemoveUnreachableBlocks;
@@ -67,6 +74,7 @@ extern bool fReplaceArrayAccessesWithRefTemps;
 extern int  optimize_on_clause_limit;
 extern int  scalar_replace_limit;
 extern int  tuple_copy_limit;
+extern int  fCompilerThreads;
 
 
 extern bool report_inlining;
@@ -81,6 +89,9 @@ extern char CHPL_RUNTIME_LIB[FILENAME_MAX+1];
 extern char CHPL_RUNTIME_INCL[FILENAME_MAX+1];
 extern char CHPL_THIRD_PARTY[FILENAME_MAX+1];
 
+// path of the running compiler, or NULL if it could not be found
+extern const char* compilerExecutable;
+
 extern const char* CHPL_HOST_PLATFORM;
 extern const char* CHPL_HOST_COMPILER;
 extern const char* CHPL_TARGET_PLATFORM;
@@ -167,6 +178,7 @@ extern bool printCppLineno;
 extern char defaultDist[256];
 extern bool printSearchDirs;
 extern bool printModuleFiles;
+extern char moduleCacheDir[FILENAME_MAX+1];
 extern bool ignore_warnings;
 extern bool ignore_errors;
 extern bool ignore_errors_for_pass;
@@ -175,9 +187,15 @@ extern bool fWarnConstLoops;
 
 extern bool fReportOptimizedLoopIterators;
 extern bool fReportOrderIndependentLoops;
+extern bool fReportVectorization;
+extern bool fReportArrayHoisting;
+extern bool fReportAutoLocalAccess;
 extern bool fReportOptimizedOn;
 extern bool fReportPromotion;
 extern bool fReportScalarReplace;
+extern bool fReportStackAllocation;
+extern bool fReportCopyElision;
+extern bool fReportBulkRemoteAccess;
 extern bool fReportDeadBlocks;
 extern bool fReportDeadModules;
 
@@ -186,6 +204,9 @@ extern bool fStrictErrorHandling;
 extern bool debugCCode;
 extern bool optimizeCCode;
 extern bool specializeCCode;
+extern bool fLinkTimeOpt;
+extern bool fPgoGenerate;
+extern char fPgoUseDir[FILENAME_MAX+1];
 
 extern bool fNoMemoryFrees;
 extern int  numGlobalsOnHeap;
@@ -88,6 +88,9 @@ public:
   Symbol*         parentSymbol;
   Expr*           parentExpr;
 
+  // position in parentSymbol's FnNodeIndex, or -1
+  int             fnNodeIndexSlot;
+
   AList*          list;           // alist pointer
   Expr*           prev;           // alist previous pointer
   Expr*           next;           // alist next     pointer
@@ -42,6 +42,7 @@ struct fileinfo {
 };
 
 void codegen_makefile(fileinfo* mainfile, const char** tmpbinname=NULL, bool skip_compile_link=false, const std::vector<const char *>& splitFiles = std::vector<const char*>());
+const char* pgoGenerateDir();
 
 void ensureDirExists(const char* /* dirname */, const char* /* explanation */);
 const char* getCwd();
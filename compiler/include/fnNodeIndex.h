@@ -0,0 +1,82 @@
+/*
+ * Copyright 2004-2017 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _FN_NODE_INDEX_H_
+#define _FN_NODE_INDEX_H_
+
+//
+// A per-function index of the CallExprs, SymExprs and DefExprs whose
+// parentSymbol is the function.  The index is built the first time it
+// is asked for and is then kept up to date by insert_help() and
+// remove_help(), so a pass that runs over the same function many times
+// can find the nodes of one kind without walking the function's body.
+//
+// Nodes are listed in no particular order.  Nodes in nested functions
+// and in the type and default expressions of formals have a different
+// parentSymbol and are not included.
+//
+
+#include "expr.h"
+#include "symbol.h"
+
+#include <vector>
+
+class FnNodeIndex {
+public:
+  static FnNodeIndex*   get(FnSymbol* fn);
+  static void           destroy(FnSymbol* fn);
+
+  // called just before expr->parentSymbol changes to 'newParent'
+  static inline void    reparent(Expr* expr, Symbol* newParent);
+
+  void                  verify(FnSymbol* fn)                          const;
+
+  std::vector<Expr*>    calls;
+  std::vector<Expr*>    symExprs;
+  std::vector<Expr*>    defs;
+
+private:
+                        FnNodeIndex();
+
+  std::vector<Expr*>*   listFor(Expr* expr);
+
+  void                  add(Expr* expr);
+  void                  remove(Expr* expr);
+
+  static void           reparentSlow(Expr* expr, Symbol* newParent);
+};
+
+inline void FnNodeIndex::reparent(Expr* expr, Symbol* newParent) {
+  if (expr->parentSymbol != newParent) {
+    if (expr->fnNodeIndexSlot >= 0) {
+      reparentSlow(expr, newParent);
+
+    } else if (FnSymbol* fn = toFnSymbol(newParent)) {
+      if (fn->nodeIndex != NULL)
+        reparentSlow(expr, newParent);
+    }
+  }
+}
+
+// Snapshots of the nodes of one kind whose parentSymbol is 'fn'
+void fnCallExprs(FnSymbol* fn, std::vector<CallExpr*>& calls);
+void fnSymExprs(FnSymbol* fn, std::vector<SymExpr*>& symExprs);
+void fnDefExprs(FnSymbol* fn, std::vector<DefExpr*>& defs);
+
+#endif
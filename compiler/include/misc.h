@@ -72,6 +72,9 @@ void        handleError(FILE* file, const BaseAST* ast, const char* fmt, ...);
 
 void        exitIfFatalErrorsEncountered();
 
+// count of errors, warnings and notes reported so far
+int         numErrorsReported();
+
 void        considerExitingEndOfPass();
 
 void        printCallStack(bool force, bool shortModule, FILE* out);
@@ -0,0 +1,76 @@
+/*
+ * Copyright 2004-2017 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//
+// Module cache
+// ------------
+//
+// With --module-cache <dir> the compiler saves the AST that the parser
+// builds for each internal and standard module file in a binary file
+// in <dir>, and on later compiles loads that file instead of lexing
+// and parsing the module source again.
+//
+// A cache file is only used if it was written for the same module
+// source (by content hash), the same CHPL_* configuration, the same
+// parse-affecting flags and the same compiler executable.  Otherwise
+// the module is parsed as usual and the cache file is rewritten.
+//
+// The cached AST is the output of the parser, before scopeResolve,
+// normalize and the other whole-program passes: those passes see user
+// code and internal modules together, so their results for a module
+// cannot be reused on their own.
+//
+// Loading a module replays the global side effects of parsing it: the
+// modules it names in 'use' statements are queued for parsing, and the
+// counters that the parser uses to name compiler-built functions are
+// advanced.  A file whose parse had other side effects (diagnostics,
+// config values set with -s, 'require' of a .chpl file, references to
+// symbols outside the file other than builtins and literals) is never
+// cached.
+//
+
+#ifndef _MODULE_CACHE_H_
+#define _MODULE_CACHE_H_
+
+#include "ModuleSymbol.h"
+
+#include <vector>
+
+class UseStmt;
+
+// is caching enabled for a file with this tag?
+bool moduleCacheEnabled(ModTag modTag, bool namedOnCommandLine);
+
+// try to load the modules defined in 'path' from the cache.  On
+// success the top-level modules are returned in 'modules'.
+bool moduleCacheLoad(const char*                 path,
+                     ModTag                      modTag,
+                     std::vector<ModuleSymbol*>& modules);
+
+// bracket the parse of a file that should be written to the cache
+void moduleCacheBeginParse();
+
+void moduleCacheEndParse(const char*                       path,
+                         const std::vector<ModuleSymbol*>& modules);
+
+// parser side effects that the cache records or must know about
+void moduleCacheNoteUse(const char* modName, UseStmt* use);
+void moduleCacheNoteUncacheable();
+
+#endif
@@ -61,6 +61,8 @@ void liveVariableAnalysis(FnSymbol* fn,
 
 void remoteValueForwarding();
 
+void autoLocalAccess();
+
 void inferConstRefs();
 
 
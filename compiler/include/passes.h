@@ -35,6 +35,7 @@ void addInitCalls();
 void buildDefaultFunctions();
 void bulkCopyRecords();
 void callDestructors();
+void bulkRemoteAccess();
 void checkNormalized();
 void checkParsed();
 void checkResolved();
@@ -46,7 +47,9 @@ void cullOverReferences();
 void deadCodeElimination();
 void denormalize();
 void docs();
+void elideCopies();
 void expandExternArrayCalls();
+void findVectorizableLoops();
 void flattenClasses();
 void flattenFunctions();
 void inlineFunctions();
@@ -74,6 +77,7 @@ void resolveIntents();
 void returnStarTuplesByRefArgs();
 void scalarReplace();
 void scopeResolve();
+void stackAllocateClasses();
 void verify();
 
 //
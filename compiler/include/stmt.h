@@ -303,7 +303,7 @@ public:
 *                                                                           *
 ************************************* | ************************************/
 
-extern Vec<LabelSymbol*>         removedIterResumeLabels;
+extern CHPL_THREAD_LOCAL Vec<LabelSymbol*> removedIterResumeLabels;
 extern Map<GotoStmt*, GotoStmt*> copiedIterResumeGotos;
 
 
@@ -41,6 +41,10 @@ const char* asubstr(const char* s, const char* e);
 
 void        deleteStrings();
 
+// --astr-benchmark
+void        astrBenchmarkStart();
+void        astrBenchmarkFinish();
+
 int8_t      str2int8(const char* str);
 int16_t     str2int16(const char* str);
 int32_t     str2int32(const char* str);
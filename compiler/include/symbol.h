@@ -46,6 +46,7 @@ extern FnSymbol* chpl_gen_main;
 class BasicBlock;
 class BlockStmt;
 class DefExpr;
+class FnNodeIndex;
 class Immediate;
 class IteratorInfo;
 class Stmt;
@@ -442,6 +443,7 @@ public:
   BlockStmt*                 instantiationPoint;
   std::vector<BasicBlock*>*  basicBlocks;
   Vec<CallExpr*>*            calledBy;
+  FnNodeIndex*               nodeIndex;
   const char*                userString;
 
   // pointer to value function (created in function resolution
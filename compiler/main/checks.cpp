@@ -272,6 +272,15 @@ void check_removeUnnecessaryAutoCopyCalls()
   // Suggestion: Ensure no unnecessary autoCopy calls.
 }
 
+void check_elideCopies()
+{
+  check_afterEveryPass();
+  check_afterNormalization();
+  check_afterCallDestructors();
+  check_afterLowerIterators();
+  check_afterResolveIntents();
+}
+
 void check_inlineFunctions()
 {
   check_afterEveryPass();
@@ -358,6 +367,15 @@ void check_loopInvariantCodeMotion()
   check_afterResolveIntents();
 }
 
+void check_stackAllocateClasses()
+{
+  check_afterEveryPass();
+  check_afterNormalization();
+  check_afterCallDestructors();
+  check_afterLowerIterators();
+  check_afterResolveIntents();
+}
+
 void check_prune2()
 {
   check_afterEveryPass();
@@ -395,6 +413,15 @@ void check_optimizeOnClauses()
   check_afterResolveIntents();
 }
 
+void check_bulkRemoteAccess()
+{
+  check_afterEveryPass();
+  check_afterNormalization();
+  check_afterCallDestructors();
+  check_afterLowerIterators();
+  check_afterResolveIntents();
+}
+
 void check_addInitCalls()
 {
   check_afterEveryPass();
@@ -412,6 +439,14 @@ void check_insertLineNumbers()
   check_afterLowerIterators();
 }
 
+void check_findVectorizableLoops()
+{
+  check_afterEveryPass();
+  check_afterNormalization();
+  check_afterCallDestructors();
+  check_afterLowerIterators();
+}
+
 void check_denormalize() {
   //do we need to call any checks here ?
   //or implement new checks ?
@@ -27,6 +27,7 @@
 #include "arg.h"
 #include "chpl.h"
 #include "commonFlags.h"
+#include "compilerThreads.h"
 #include "config.h"
 #include "countTokens.h"
 #include "docsDriver.h"
@@ -61,6 +62,8 @@ char CHPL_RUNTIME_LIB[FILENAME_MAX+1] = "";
 char CHPL_RUNTIME_INCL[FILENAME_MAX+1] = "";
 char CHPL_THIRD_PARTY[FILENAME_MAX+1] = "";
 
+const char* compilerExecutable = NULL;
+
 const char* CHPL_HOST_PLATFORM = NULL;
 const char* CHPL_HOST_COMPILER = NULL;
 const char* CHPL_TARGET_PLATFORM = NULL;
@@ -96,6 +99,7 @@ bool fLibraryCompile = false;
 bool no_codegen = false;
 int  debugParserLevel = 0;
 bool fVerify = false;
+bool fAstrBenchmark = false;
 bool ignore_errors = false;
 bool ignore_errors_for_pass = false;
 bool ignore_warnings = false;
@@ -105,13 +109,16 @@ bool fFastFlag = false;
 bool fUseNoinit = true;
 bool fNoUserConstructors = false;
 bool fNoCopyPropagation = false;
+bool fNoCopyElision = false;
 bool fNoDeadCodeElimination = false;
 bool fNoScalarReplacement = false;
+bool fNoStackAllocateClasses = false;
 bool fNoTupleCopyOpt = false;
 bool fNoRemoteValueForwarding = false;
 bool fNoRemoveCopyCalls = false;
 bool fNoOptimizeLoopIterators = false;
 bool fNoVectorize = true;
+bool fNoVectorizeSafeLoops = true;
 bool fNoGlobalConstOpt = false;
 bool fNoFastFollowers = false;
 bool fNoInlineIterators = false;
@@ -145,8 +152,11 @@ static bool fNoWarnTupleIteration = true;
 bool fNoloopInvariantCodeMotion = false;
 bool fNoChecks = false;
 bool fNoInline = false;
+bool fNoAutoInline = false;
+bool fNoAutoLocalAccess = false;
 bool fNoPrivatization = false;
 bool fNoOptimizeOnClauses = false;
+bool fNoBulkRemoteAccess = false;
 bool fNoRemoveEmptyRecords = true;
 bool fRemoveUnreachableBlocks = true;
 bool fMinimalModules = false;
@@ -156,6 +166,7 @@ bool fUseIPE         = false;
 int optimize_on_clause_limit = 20;
 int scalar_replace_limit = 8;
 int tuple_copy_limit = scalar_replace_limit;
+int fCompilerThreads = 1;
 bool fGenIDS = false;
 int fLinkStyle = LS_DEFAULT; // use backend compiler's default
 bool fUserSetLocal = false;
@@ -182,9 +193,15 @@ char fPrintStatistics[256] = "";
 bool fPrintDispatch = false;
 bool fReportOptimizedLoopIterators = false;
 bool fReportOrderIndependentLoops = false;
+bool fReportVectorization = false;
+bool fReportArrayHoisting = false;
+bool fReportAutoLocalAccess = false;
 bool fReportOptimizedOn = false;
 bool fReportPromotion = false;
 bool fReportScalarReplace = false;
+bool fReportStackAllocation = false;
+bool fReportCopyElision = false;
+bool fReportBulkRemoteAccess = false;
 bool fReportDeadBlocks = false;
 bool fReportDeadModules = false;
 bool printCppLineno = false;
@@ -194,6 +211,7 @@ char defaultDist[256] = "DefaultDist";
 int instantiation_limit = 256;
 bool printSearchDirs = false;
 bool printModuleFiles = false;
+char moduleCacheDir[FILENAME_MAX+1] = "";
 bool llvmCodegen = false;
 #ifdef HAVE_LLVM
 bool externC = true;
@@ -206,6 +224,9 @@ int breakOnCodegenID = 0;
 bool debugCCode = false;
 bool optimizeCCode = false;
 bool specializeCCode = false;
+bool fLinkTimeOpt = false;
+bool fPgoGenerate = false;
+char fPgoUseDir[FILENAME_MAX+1] = "";
 
 bool fNoMemoryFrees = false;
 int numGlobalsOnHeap = 0;
@@ -611,6 +632,17 @@ static void verifySaveCDir(const ArgumentDescription* desc, const char* unused)
   }
 }
 
+static void verifyPgoUseDir(const ArgumentDescription* desc,
+                            const char* unused) {
+  if (char* real = dirHasFile(fPgoUseDir, ".")) {
+    // profiles are read while compiling in the temporary directory
+    strncpy(fPgoUseDir, real, FILENAME_MAX);
+    free(real);
+  } else {
+    USR_FATAL("--pgo-use directory '%s' does not exist", fPgoUseDir);
+  }
+}
+
 static void turnOffChecks(const ArgumentDescription* desc, const char* unused) {
   fNoNilChecks    = true;
   fNoBoundsChecks = true;
@@ -630,22 +662,28 @@ static void setFastFlag(const ArgumentDescription* desc, const char* unused) {
   // instead, we rely on the backend C compiler to choose
   // an appropriate level of optimization.
   fNoCopyPropagation = false;
+  fNoCopyElision = false;
   fNoDeadCodeElimination = false;
   fNoFastFollowers = false;
   fNoloopInvariantCodeMotion= false;
   fNoInline = false;
+  fNoAutoInline = false;
+  fNoAutoLocalAccess = false;
   fNoInlineIterators = false;
   fNoOptimizeLoopIterators = false;
   fNoLiveAnalysis = false;
   fNoRemoteValueForwarding = false;
   fNoRemoveCopyCalls = false;
   fNoScalarReplacement = false;
+  fNoStackAllocateClasses = false;
   fNoTupleCopyOpt = false;
   fNoPrivatization = false;
+  fNoVectorizeSafeLoops = false;
   fNoChecks = true;
   fNoInferLocalFields = false;
   fIgnoreLocalClasses = false;
   fNoOptimizeOnClauses = false;
+  fNoBulkRemoteAccess = false;
   //fReplaceArrayAccessesWithRefTemps = true; // don't tie this to --fast yet
   optimizeCCode = true;
   specializeCCode = true;
@@ -674,20 +712,26 @@ static void setBaselineFlag(const ArgumentDescription* desc, const char* unused)
   fBaseline = true;                   // --baseline
 
   fNoCopyPropagation = true;          // --no-copy-propagation
+  fNoCopyElision = true;              // --no-copy-elision
   fNoDeadCodeElimination = true;      // --no-dead-code-elimination
   fNoFastFollowers = true;            // --no-fast-followers
   fNoloopInvariantCodeMotion = true;  // --no-loop-invariant-code-motion
   fNoInline = true;                   // --no-inline
+  fNoAutoInline = true;               // --no-auto-inline
+  fNoAutoLocalAccess = true;          // --no-auto-local-access
   fNoInlineIterators = true;          // --no-inline-iterators
   fNoLiveAnalysis = true;             // --no-live-analysis
   fNoOptimizeLoopIterators = true;    // --no-optimize-loop-iterators
   fNoVectorize = true;                // --no-vectorize
+  fNoVectorizeSafeLoops = true;       // --no-vectorize-safe-loops
   fNoRemoteValueForwarding = true;    // --no-remote-value-forwarding
   fNoRemoveCopyCalls = true;          // --no-remove-copy-calls
   fNoScalarReplacement = true;        // --no-scalar-replacement
+  fNoStackAllocateClasses = true;     // --no-stack-allocate-classes
   fNoTupleCopyOpt = true;             // --no-tuple-copy-opt
   fNoPrivatization = true;            // --no-privatization
   fNoOptimizeOnClauses = true;        // --no-optimize-on-clauses
+  fNoBulkRemoteAccess = true;         // --no-bulk-remote-access
   fIgnoreLocalClasses = true;         // --ignore-local-classes
   fNoInferLocalFields = true;         // --no-infer-local-fields
   //fReplaceArrayAccessesWithRefTemps = false; // don't tie this to --baseline yet
@@ -778,6 +822,7 @@ static ArgumentDescription arg_desc[] = {
  {"", ' ', NULL, "Module Processing Options", NULL, NULL, NULL, NULL},
  {"count-tokens", ' ', NULL, "[Don't] count tokens in main modules", "N", &countTokens, "CHPL_COUNT_TOKENS", NULL},
  {"main-module", ' ', "<module>", "Specify entry point module", "S256", NULL, NULL, ModuleSymbol::mainModuleNameSet },
+ {"module-cache", ' ', "<directory>", "Cache parsed modules in directory", "P", moduleCacheDir, "CHPL_MODULE_CACHE_DIR", NULL},
  {"module-dir", 'M', "<directory>", "Add directory to module search path", "P", moduleSearchPath, NULL, addModulePath},
  {"print-code-size", ' ', NULL, "[Don't] print code size of main modules", "N", &printTokens, "CHPL_PRINT_TOKENS", NULL},
  {"print-module-files", ' ', NULL, "Print module file locations", "F", &printModuleFiles, NULL, NULL},
@@ -787,8 +832,13 @@ static ArgumentDescription arg_desc[] = {
  {"local", ' ', NULL, "Target one [many] locale[s]", "N", &fLocal, "CHPL_LOCAL", setLocal},
 
  {"", ' ', NULL, "Optimization Control Options", NULL, NULL, NULL, NULL},
+ {"auto-inline", ' ', NULL, "Enable [disable] automatic inlining", "n", &fNoAutoInline, "CHPL_DISABLE_AUTO_INLINE", NULL},
+ {"auto-local-access", ' ', NULL, "Enable [disable] local access rewriting", "n", &fNoAutoLocalAccess, "CHPL_DISABLE_AUTO_LOCAL_ACCESS", NULL},
  {"baseline", ' ', NULL, "Disable all Chapel optimizations", "F", &fBaseline, "CHPL_BASELINE", setBaselineFlag},
+ {"bulk-remote-access", ' ', NULL, "Enable [disable] bulk remote accesses", "n", &fNoBulkRemoteAccess, "CHPL_DISABLE_BULK_REMOTE_ACCESS", NULL},
  {"cache-remote", ' ', NULL, "Enable cache for remote data (must be enabled specifically)", "F", &fCacheRemote, "CHPL_CACHE_REMOTE", setCacheEnable},
+ {"compiler-threads", ' ', "<threads>", "Run per-function optimizations on <threads> threads", "I", &fCompilerThreads, "CHPL_COMPILER_THREADS", NULL},
+ {"copy-elision", ' ', NULL, "Enable [disable] turning last-use copies into moves", "n", &fNoCopyElision, "CHPL_DISABLE_COPY_ELISION", NULL},
  {"copy-propagation", ' ', NULL, "Enable [disable] copy propagation", "n", &fNoCopyPropagation, "CHPL_DISABLE_COPY_PROPAGATION", NULL},
  {"dead-code-elimination", ' ', NULL, "Enable [disable] dead code elimination", "n", &fNoDeadCodeElimination, "CHPL_DISABLE_DEAD_CODE_ELIMINATION", NULL},
  {"fast", ' ', NULL, "Use fast default settings", "F", &fFastFlag, "CHPL_FAST", setFastFlag},
@@ -807,11 +857,13 @@ static ArgumentDescription arg_desc[] = {
  {"remove-copy-calls", ' ', NULL, "Enable [disable] remove copy calls", "n", &fNoRemoveCopyCalls, "CHPL_DISABLE_REMOVE_COPY_CALLS", NULL},
  {"scalar-replacement", ' ', NULL, "Enable [disable] scalar replacement", "n", &fNoScalarReplacement, "CHPL_DISABLE_SCALAR_REPLACEMENT", NULL},
  {"scalar-replace-limit", ' ', "<limit>", "Limit on the size of tuples being replaced during scalar replacement", "I", &scalar_replace_limit, "CHPL_SCALAR_REPLACE_TUPLE_LIMIT", NULL},
+ {"stack-allocate-classes", ' ', NULL, "Enable [disable] class stack allocation", "n", &fNoStackAllocateClasses, "CHPL_DISABLE_STACK_ALLOCATE_CLASSES", NULL},
  {"tuple-copy-opt", ' ', NULL, "Enable [disable] tuple (memcpy) optimization", "n", &fNoTupleCopyOpt, "CHPL_DISABLE_TUPLE_COPY_OPT", NULL},
  {"tuple-copy-limit", ' ', "<limit>", "Limit on the size of tuples considered for optimization", "I", &tuple_copy_limit, "CHPL_TUPLE_COPY_LIMIT", NULL},
  {"use-noinit", ' ', NULL, "Enable [disable] ability to skip default initialization through the keyword noinit", "N", &fUseNoinit, NULL, NULL},
  {"infer-local-fields", ' ', NULL, "Enable [disable] analysis to infer local fields in classes and records (experimental)", "n", &fNoInferLocalFields, "CHPL_DISABLE_INFER_LOCAL_FIELDS", NULL},
  {"vectorize", ' ', NULL, "Enable [disable] generation of vectorization hints", "n", &fNoVectorize, "CHPL_DISABLE_VECTORIZATION", NULL},
+ {"vectorize-safe-loops", ' ', NULL, "Enable [disable] hints for safe loops", "n", &fNoVectorizeSafeLoops, "CHPL_DISABLE_VECTORIZE_SAFE_LOOPS", NULL},
 
  {"", ' ', NULL, "Run-time Semantic Check Options", NULL, NULL, NULL, NULL},
  {"no-checks", ' ', NULL, "Disable all following run-time checks", "F", &fNoChecks, "CHPL_NO_CHECKS", turnOffChecks},
@@ -838,8 +890,11 @@ static ArgumentDescription arg_desc[] = {
  {"ldflags", ' ', "<flags>", "Back-end C linker flags (can be specified multiple times)", "S", NULL, "CHPL_LD_FLAGS", setLDFlags},
  {"lib-linkage", 'l', "<library>", "C library linkage", "P", libraryFilename, "CHPL_LIB_NAME", handleLibrary},
  {"lib-search-path", 'L', "<directory>", "C library search path", "P", libraryFilename, "CHPL_LIB_PATH", handleLibPath},
+ {"lto", ' ', NULL, "[Don't] Optimize the program and runtime together at link time", "N", &fLinkTimeOpt, "CHPL_LTO", NULL},
  {"optimize", 'O', NULL, "[Don't] Optimize generated C code", "N", &optimizeCCode, "CHPL_OPTIMIZE", NULL},
  {"specialize", ' ', NULL, "[Don't] Specialize generated C code for CHPL_TARGET_ARCH", "N", &specializeCCode, "CHPL_SPECIALIZE", NULL},
+ {"pgo-generate", ' ', NULL, "Instrument generated code to record an execution profile", "F", &fPgoGenerate, "CHPL_PGO_GENERATE", NULL},
+ {"pgo-use", ' ', "<directory>", "Optimize generated code using the profiles in directory", "P", fPgoUseDir, "CHPL_PGO_USE", verifyPgoUseDir},
  {"output", 'o', "<filename>", "Name output executable", "P", executableFilename, "CHPL_EXE_NAME", NULL},
  {"static", ' ', NULL, "Generate a statically linked binary", "F", &fLinkStyle, NULL, NULL},
 
@@ -927,7 +982,7 @@ static ArgumentDescription arg_desc[] = {
  {"print-emitted-code-size", ' ', NULL, "Print emitted code size", "F", &fPrintEmittedCodeSize, NULL, NULL},
  {"print-module-resolution", ' ', NULL, "Print name of module being resolved", "F", &fPrintModuleResolution, "CHPL_PRINT_MODULE_RESOLUTION", NULL},
  {"print-dispatch", ' ', NULL, "Print dynamic dispatch table", "F", &fPrintDispatch, NULL, NULL},
- {"print-statistics", ' ', "[n|k|t]", "Print AST statistics", "S256", fPrintStatistics, NULL, NULL},
+ {"print-statistics", ' ', "[n|k|t|a]", "Print AST statistics", "S256", fPrintStatistics, NULL, NULL},
  {"report-inlining", ' ', NULL, "Print inlined functions", "F", &report_inlining, NULL, NULL},
  {"report-dead-blocks", ' ', NULL, "Print dead block removal stats", "F", &fReportDeadBlocks, NULL, NULL},
  {"report-dead-modules", ' ', NULL, "Print dead module removal stats", "F", &fReportDeadModules, NULL, NULL},
@@ -936,8 +991,15 @@ static ArgumentDescription arg_desc[] = {
  {"report-optimized-on", ' ', NULL, "Print information about on clauses that have been optimized for potential fast remote fork operation", "F", &fReportOptimizedOn, NULL, NULL},
  {"report-promotion", ' ', NULL, "Print information about scalar promotion", "F", &fReportPromotion, NULL, NULL},
  {"report-scalar-replace", ' ', NULL, "Print scalar replacement stats", "F", &fReportScalarReplace, NULL, NULL},
+ {"report-vectorization", ' ', NULL, "Print which loops are safe to vectorize", "F", &fReportVectorization, NULL, NULL},
+ {"report-array-hoisting", ' ', NULL, "Print array metadata hoisting stats", "F", &fReportArrayHoisting, NULL, NULL},
+ {"report-auto-local-access", ' ', NULL, "Print array accesses made local", "F", &fReportAutoLocalAccess, NULL, NULL},
+ {"report-stack-allocation", ' ', NULL, "Print classes allocated on the stack", "F", &fReportStackAllocation, NULL, NULL},
+ {"report-copy-elision", ' ', NULL, "Print record copies turned into moves", "F", &fReportCopyElision, NULL, NULL},
+ {"report-bulk-remote-access", ' ', NULL, "Print remote array ranges copied in bulk", "F", &fReportBulkRemoteAccess, NULL, NULL},
 
  {"", ' ', NULL, "Developer Flags -- Miscellaneous", NULL, NULL, NULL, NULL},
+ {"astr-benchmark", ' ', NULL, "Time interning the compiler's strings", "F", &fAstrBenchmark, "CHPL_ASTR_BENCHMARK", NULL},
  {"break-on-id", ' ', NULL, "Break when AST id is created", "I", &breakOnID, "CHPL_BREAK_ON_ID", NULL},
  {"break-on-delete-id", ' ', NULL, "Break when AST id is deleted", "I", &breakOnDeleteID, "CHPL_BREAK_ON_DELETE_ID", NULL},
  {"break-on-codegen", ' ', NULL, "Break when function cname is code generated", "S256", &breakOnCodegenCname, "CHPL_BREAK_ON_CODEGEN", NULL},
@@ -1228,6 +1290,24 @@ static void checkIncrementalAndOptimized() {
               " using -O optimizations directly.");
 }
 
+static void checkPgo() {
+  if (fPgoGenerate && fPgoUseDir[0])
+    USR_FATAL("--pgo-generate and --pgo-use cannot be used together");
+}
+
+static void checkCompilerThreads() {
+  if (fCompilerThreads < 1)
+    USR_FATAL("--compiler-threads must be at least 1");
+
+#ifndef HAVE_COMPILER_THREADS
+  if (fCompilerThreads > 1) {
+    USR_WARN("This compiler was built without thread support, "
+             "ignoring --compiler-threads");
+    fCompilerThreads = 1;
+  }
+#endif
+}
+
 static void postprocess_args() {
   // Processes that depend on results of passed arguments or values of CHPL_vars
 
@@ -1250,6 +1330,10 @@ static void postprocess_args() {
   checkTargetArch();
 
   checkIncrementalAndOptimized();
+
+  checkCompilerThreads();
+
+  checkPgo();
 }
 
 int main(int argc, char* argv[]) {
@@ -1264,6 +1348,10 @@ int main(int argc, char* argv[]) {
 
     init_args(&sArgState, argv[0]);
 
+    if (sArgState.program_loc != NULL) {
+      compilerExecutable = astr(sArgState.program_loc);
+    }
+
     fDocs   = (strcmp(sArgState.program_name, "chpldoc")  == 0) ? true : false;
     fUseIPE = (strcmp(sArgState.program_name, "chpl-ipe") == 0) ? true : false;
 
@@ -1294,6 +1382,9 @@ int main(int argc, char* argv[]) {
 
     postprocess_args();
 
+    if (fAstrBenchmark == true)
+      astrBenchmarkStart();
+
     initCompilerGlobals(); // must follow argument parsing
 
     setupModulePaths();
@@ -65,6 +65,7 @@ struct PassInfo {
 #define LOG_prune                              LOG_NO_SHORT
 #define LOG_bulkCopyRecords                    LOG_NO_SHORT
 #define LOG_removeUnnecessaryAutoCopyCalls     LOG_NO_SHORT
+#define LOG_elideCopies                        LOG_NO_SHORT
 #define LOG_inlineFunctions                    LOG_NO_SHORT
 #define LOG_scalarReplace                      LOG_NO_SHORT
 #define LOG_refPropagation                     LOG_NO_SHORT
@@ -74,12 +75,15 @@ struct PassInfo {
 #define LOG_removeEmptyRecords                 LOG_NO_SHORT
 #define LOG_localizeGlobals                    LOG_NO_SHORT
 #define LOG_loopInvariantCodeMotion            LOG_NO_SHORT
+#define LOG_stackAllocateClasses               LOG_NO_SHORT
 #define LOG_prune2                             LOG_NO_SHORT
 #define LOG_returnStarTuplesByRefArgs          LOG_NO_SHORT
 #define LOG_insertWideReferences               LOG_NO_SHORT
 #define LOG_optimizeOnClauses                  LOG_NO_SHORT
+#define LOG_bulkRemoteAccess                   LOG_NO_SHORT
 #define LOG_addInitCalls                       LOG_NO_SHORT
 #define LOG_insertLineNumbers                  LOG_NO_SHORT
+#define LOG_findVectorizableLoops              LOG_NO_SHORT
 #define LOG_denormalize                        LOG_NO_SHORT
 #define LOG_codegen                            'c'
 #define LOG_makeBinary                         LOG_NEVER
@@ -134,6 +138,7 @@ static PassInfo sPassList[] = {
   // Optimizations
   RUN(bulkCopyRecords),         // replace simple assignments with PRIM_ASSIGN.
   RUN(removeUnnecessaryAutoCopyCalls),
+  RUN(elideCopies),             // turn last-use record copies into moves
   RUN(inlineFunctions),         // function inlining
   RUN(scalarReplace),           // scalar replace all tuples
   RUN(refPropagation),          // reference propagation
@@ -144,16 +149,19 @@ static PassInfo sPassList[] = {
   RUN(removeEmptyRecords),      // remove empty records
   RUN(localizeGlobals),         // pull out global constants from loop runs
   RUN(loopInvariantCodeMotion), // move loop invariant code above loop runs
+  RUN(stackAllocateClasses),    // put instances that do not escape on the stack
   RUN(prune2),                  // prune AST of dead functions and types again
 
   RUN(returnStarTuplesByRefArgs),
 
   RUN(insertWideReferences),    // inserts wide references for on clauses
   RUN(optimizeOnClauses),       // Optimize on clauses
+  RUN(bulkRemoteAccess),        // copy remote array ranges that loops use
   RUN(addInitCalls),            // Add module init calls and guards.
 
   // AST to C or LLVM
   RUN(insertLineNumbers),       // insert line numbers for error messages
+  RUN(findVectorizableLoops),   // mark loops that are safe to vectorize
   RUN(denormalize),             // denormalize -- remove local temps
   RUN(codegen),                 // generate C code
   RUN(makeBinary)               // invoke underlying C compiler
@@ -0,0 +1,309 @@
+/*
+ * Copyright 2004-2017 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "optimizations.h"
+
+#include "astutil.h"
+#include "build.h"
+#include "driver.h"
+#include "expr.h"
+#include "ForallStmt.h"
+#include "stlUtil.h"
+#include "stmt.h"
+#include "stringutil.h"
+#include "symbol.h"
+
+#include <vector>
+
+/************************************* | **************************************
+*                                                                             *
+* A forall over a domain runs each iteration on the locale that owns its      *
+* index, so in                                                                *
+*                                                                             *
+*   forall i in D do A[i] = B[i] + C[i];                                      *
+*                                                                             *
+* where A, B and C were declared over D, every access is local and the        *
+* locality checks done by the distribution's dsiAccess() are redundant.       *
+* Such accesses are rewritten to A.localAccess(i).                            *
+*                                                                             *
+* This runs before normalization, so the analysis is syntactic.  An access    *
+* A[idx] is rewritten when                                                    *
+*                                                                             *
+*   - the forall is not zippered and iterates over a const domain D or over   *
+*     X.domain,                                                               *
+*   - idx is the forall's index, or all of its destructured components in     *
+*     order,                                                                  *
+*   - A was declared over that same D (var A: [D] t, or through 'typeof'),    *
+*     or A is X,                                                              *
+*   - the access is not inside an 'on' statement or a nested forall, either   *
+*     of which could run it on another locale.                                *
+*                                                                             *
+************************************** | *************************************/
+
+static CallExpr*  arrayTypeExpr(Symbol* sym, int depth);
+static Symbol*    alignmentOf(Symbol* arr);
+static Symbol*    iteratedAlignment(ForallStmt* fs);
+static bool       findIndexVars(ForallStmt* fs, std::vector<Symbol*>& idxVars);
+static bool       isIndexedBy(CallExpr* call, std::vector<Symbol*>& idxVars);
+static bool       mayRunElsewhere(Expr* expr, ForallStmt* fs);
+
+void autoLocalAccess() {
+  if (fNoAutoLocalAccess == true) {
+    return;
+  }
+
+  forv_Vec(ForallStmt, fs, gForallStmts) {
+    Symbol*              alignment = NULL;
+    std::vector<Symbol*> idxVars;
+
+    if (fs->inTree()                              == true  &&
+        fs->zippered()                            == false &&
+        (alignment = iteratedAlignment(fs))       != NULL  &&
+        findIndexVars(fs, idxVars)                == true) {
+      std::vector<CallExpr*> calls;
+
+      collectCallExprs(fs->loopBody(), calls);
+
+      for_vector(CallExpr, call, calls) {
+        SymExpr* base = toSymExpr(call->baseExpr);
+
+        if (base                                 != NULL      &&
+            alignmentOf(base->symbol())          == alignment &&
+            isIndexedBy(call, idxVars)           == true      &&
+            mayRunElsewhere(call, fs)            == false) {
+          Symbol* arr = base->symbol();
+
+          SET_LINENO(call);
+
+          base->replace(buildDotExpr(arr, "localAccess"));
+
+          if (fReportAutoLocalAccess == true) {
+            ModuleSymbol* mod = call->getModule();
+
+            if (developer == true || mod->modTag == MOD_USER) {
+              printf("Local access to %s at %s:%d\n",
+                     arr->name, mod->name, call->linenum());
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+// The 'chpl__buildArrayRuntimeType(...)' call 'sym' was declared with
+static CallExpr* arrayTypeExpr(Symbol* sym, int depth) {
+  Expr* typeExpr = NULL;
+
+  if (depth > 8) {
+    return NULL;
+
+  } else if (ArgSymbol* arg = toArgSymbol(sym)) {
+    if (arg->typeExpr != NULL) {
+      typeExpr = arg->typeExpr->body.tail;
+    }
+
+  } else if (isVarSymbol(sym) == true && sym->defPoint != NULL) {
+    typeExpr = sym->defPoint->exprType;
+  }
+
+  if (CallExpr* call = toCallExpr(typeExpr)) {
+    if (call->isNamed("chpl__buildArrayRuntimeType") == true) {
+      return call;
+
+    } else if (call->isPrimitive(PRIM_TYPEOF) == true) {
+      if (SymExpr* se = toSymExpr(call->get(1))) {
+        return arrayTypeExpr(se->symbol(), depth + 1);
+      }
+    }
+  }
+
+  return NULL;
+}
+
+//
+// Two arrays are aligned when this returns the same symbol for both: the
+// domain they were declared over when that is a named domain, or else the
+// array itself.  Returns NULL for anything not known to be an array.
+//
+static Symbol* alignmentOf(Symbol* arr) {
+  Symbol* retval = NULL;
+
+  if (CallExpr* typeExpr = arrayTypeExpr(arr, 0)) {
+    CallExpr* ensure = toCallExpr(typeExpr->get(1));
+
+    retval = arr;
+
+    if (ensure                                  != NULL &&
+        ensure->isNamed("chpl__ensureDomainExpr") == true &&
+        ensure->numActuals()                    == 1) {
+      if (SymExpr* dom = toSymExpr(ensure->get(1))) {
+        retval = dom->symbol();
+      }
+    }
+  }
+
+  return retval;
+}
+
+static bool isConstSymbol(Symbol* sym) {
+  if (ArgSymbol* arg = toArgSymbol(sym)) {
+    return arg->intent == INTENT_BLANK     ||
+           arg->intent == INTENT_CONST     ||
+           arg->intent == INTENT_CONST_IN  ||
+           arg->intent == INTENT_CONST_REF;
+  }
+
+  return isVarSymbol(sym) == true && sym->hasFlag(FLAG_CONST) == true;
+}
+
+// What the forall's single iterand is aligned with, or NULL
+static Symbol* iteratedAlignment(ForallStmt* fs) {
+  Expr* iterand = fs->firstIteratedExpr();
+
+  if (fs->numIteratedExprs() != 1) {
+    return NULL;
+
+  // forall i in D, but not forall x in A, whose indices are elements
+  } else if (SymExpr* se = toSymExpr(iterand)) {
+    if (isConstSymbol(se->symbol())        == true &&
+        arrayTypeExpr(se->symbol(), 0)     == NULL) {
+      return se->symbol();
+    }
+
+  // forall i in X.domain
+  } else if (CallExpr* call = toCallExpr(iterand)) {
+    const char* member = NULL;
+
+    if (call->isNamed(".")                  == true &&
+        get_string(call->get(2), &member)   == true &&
+        strcmp(member, "_dom")              == 0) {
+      if (SymExpr* arr = toSymExpr(call->get(1))) {
+        return alignmentOf(arr->symbol());
+      }
+    }
+  }
+
+  return NULL;
+}
+
+//
+// The forall's index variable, or the variables its components were
+// destructured into, in order.
+//
+static bool findIndexVars(ForallStmt* fs, std::vector<Symbol*>& idxVars) {
+  DefExpr* idxDef = toDefExpr(fs->inductionVariables().head);
+  Symbol*  idx    = (idxDef != NULL) ? idxDef->sym : NULL;
+
+  if (idx == NULL || fs->inductionVariables().length != 1) {
+    return false;
+
+  } else if (idx->hasFlag(FLAG_TEMP) == false) {
+    idxVars.push_back(idx);
+
+  } else {
+    // forall (i, j) in D  -->  move j, idx(2); move i, idx(1) ...
+    for_alist(stmt, fs->loopBody()->body) {
+      if (CallExpr* move = toCallExpr(stmt)) {
+        CallExpr* component = NULL;
+        SymExpr*  lhs       = NULL;
+        int64_t   k         = 0;
+
+        if (move->isPrimitive(PRIM_MOVE)                      == false ||
+            (lhs       = toSymExpr(move->get(1)))             == NULL  ||
+            (component = toCallExpr(move->get(2)))            == NULL  ||
+            isSymExpr(component->baseExpr)                    == false ||
+            toSymExpr(component->baseExpr)->symbol()          != idx   ||
+            component->numActuals()                           != 1     ||
+            get_int(component->get(1), &k)                    == false) {
+          break;
+        }
+
+        if (k < 1 || k > 64) {
+          return false;
+        }
+
+        if (idxVars.size() < (size_t) k) {
+          idxVars.resize(k, NULL);
+        }
+
+        if (idxVars[k - 1] != NULL) {
+          return false;
+        }
+
+        idxVars[k - 1] = lhs->symbol();
+
+      } else if (isDefExpr(stmt) == false) {
+        break;
+      }
+    }
+
+    for_vector_allowing_0s(Symbol, var, idxVars) {
+      if (var == NULL) {
+        return false;
+      }
+    }
+  }
+
+  return idxVars.size() > 0;
+}
+
+static bool isIndexedBy(CallExpr* call, std::vector<Symbol*>& idxVars) {
+  if (call->numActuals() != (int) idxVars.size()) {
+    return false;
+  }
+
+  for (int i = 1; i <= call->numActuals(); i++) {
+    SymExpr* actual = toSymExpr(call->get(i));
+
+    if (actual == NULL || actual->symbol() != idxVars[i - 1]) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+static bool mayRunElsewhere(Expr* expr, ForallStmt* fs) {
+  if (expr->parentSymbol != fs->parentSymbol) {
+    return true;
+  }
+
+  for (Expr* parent = expr->parentExpr;
+       parent != fs && parent != NULL;
+       parent = parent->parentExpr) {
+    if (isForallStmt(parent) == true) {
+      return true;
+
+    } else if (BlockStmt* block = toBlockStmt(parent)) {
+      if (block->isLoopStmt() == false) {
+        if (CallExpr* info = block->blockInfoGet()) {
+          if (info->isPrimitive(PRIM_BLOCK_ON)         == true ||
+              info->isPrimitive(PRIM_BLOCK_BEGIN_ON)   == true ||
+              info->isPrimitive(PRIM_BLOCK_COBEGIN_ON) == true ||
+              info->isPrimitive(PRIM_BLOCK_COFORALL_ON) == true) {
+            return true;
+          }
+        }
+      }
+    }
+  }
+
+  return false;
+}
@@ -0,0 +1,896 @@
+/*
+ * Copyright 2004-2017 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//
+// bulkRemoteAccess
+// ----------------
+//
+// A serial loop such as
+//
+//   on Locales[1] do
+//     for i in 1..n do B[i] = A[i-1] + A[i+1];
+//
+// reaches the elements of A and B through wide pointers, so each
+// iteration does two remote gets and a remote put.  This pass finds C for
+// loops over lo..hi that touch the elements of remote arrays at i plus a
+// constant, and rewrites them to
+//
+//   if (0 < hi-lo+1 <= maxBulkElements) {
+//     allocate a local buffer for each array and get the elements the
+//     loop reads with a single chpl_comm_get
+//     run a copy of the loop on the buffers
+//     put the buffers of the arrays the loop writes back with a single
+//     chpl_comm_put and free the buffers
+//   } else {
+//     run the original loop
+//   }
+//
+// A loop is rewritten only when every iteration's accesses can be moved
+// to the buffers without changing what the loop computes:
+//
+//   * the body is straight line code that makes no calls, so every
+//     element the loop touches is within the range that is copied
+//
+//   * every wide reference in the body is the address of an element of
+//     a loop invariant wide data pointer of numbers or bools, and is only
+//     read or stored through
+//
+//   * other than that, the body only writes locals, so nothing it does can
+//     change the elements that were copied into the buffers
+//
+//   * an array that is written is not read or written through any other
+//     data pointer, unless the two come from different array variables
+//
+// This runs after insertWideReferences(), so it only sees the accesses
+// that really are wide.
+//
+
+#include "passes.h"
+
+#include "astutil.h"
+#include "CForLoop.h"
+#include "driver.h"
+#include "expr.h"
+#include "stlUtil.h"
+#include "stmt.h"
+#include "symbol.h"
+
+#include <cstdio>
+#include <map>
+#include <set>
+#include <vector>
+
+// The largest number of iterations a loop is rewritten for
+static const int64_t maxBulkElements = 1 << 20;
+
+// The elements of one array that a loop touches
+struct RemoteArray {
+  RemoteArray() : data(NULL), refType(NULL),
+                  minOffset(0), maxOffset(0),
+                  isRead(false), isWritten(false) { }
+
+  std::vector<Symbol*> base;        // the array and fields it came from
+  Symbol*              data;        // a wide data pointer to its elements
+  Type*                refType;     // a wide reference to one element
+  std::set<Symbol*>    dataSyms;    // every data pointer loaded from it
+  int64_t              minOffset;
+  int64_t              maxOffset;
+  bool                 isRead;
+  bool                 isWritten;
+};
+
+class BulkAccessFinder {
+public:
+                         BulkAccessFinder(CForLoop* loop);
+
+  bool                   find();
+
+  Symbol*                index;
+  Symbol*                low;
+  Symbol*                high;
+
+  std::vector<RemoteArray> arrays;
+
+private:
+  bool                   findBounds();
+  void                   findWrittenSymbols();
+
+  bool                   checkStmts(BlockStmt* block);
+  bool                   checkCall(CallExpr* call);
+  bool                   checkExpr(Expr* expr);
+  bool                   checkLocalStore(Symbol* sym, Expr* rhs);
+  bool                   checkAliases();
+
+  bool                   defineElementRef(Symbol* ref, CallExpr* arrayGet);
+  bool                   isInvariant(Symbol* sym);
+  bool                   offsetOf(Symbol* sym, int64_t& offset);
+
+  CForLoop*                      mLoop;
+
+  std::set<Symbol*>              mWritten;
+  std::set<Symbol*>              mLocalRefs;
+  std::map<Symbol*, size_t>      mElementRefs;
+};
+
+static std::vector<Symbol*> baseOf(Symbol* sym);
+static bool                 isBulkElementType(Type* type);
+static bool                 isDistinctArray(const RemoteArray& a,
+                                            const RemoteArray& b);
+
+static void                 rewriteLoop(CForLoop* loop,
+                                        BulkAccessFinder& finder);
+static void                 reportLoop(CForLoop* loop,
+                                       BulkAccessFinder& finder);
+
+void bulkRemoteAccess() {
+  if (fNoBulkRemoteAccess == true || fLocal == true) {
+    return;
+  }
+
+  forv_Vec(BlockStmt, block, gBlockStmts) {
+    CForLoop* loop = toCForLoop(block);
+
+    if (loop != NULL && loop->parentSymbol != NULL) {
+      BulkAccessFinder finder(loop);
+
+      if (finder.find() == true) {
+        if (fReportBulkRemoteAccess == true) {
+          reportLoop(loop, finder);
+        }
+
+        rewriteLoop(loop, finder);
+      }
+    }
+  }
+}
+
+/************************************* | **************************************
+*                                                                             *
+* Check one loop                                                              *
+*                                                                             *
+************************************** | *************************************/
+
+BulkAccessFinder::BulkAccessFinder(CForLoop* loop) :
+  index(NULL), low(NULL), high(NULL), mLoop(loop) {
+
+}
+
+bool BulkAccessFinder::find() {
+  findWrittenSymbols();
+
+  return findBounds()        == true &&
+         checkStmts(mLoop)   == true &&
+         arrays.size()       >  0    &&
+         checkAliases()      == true;
+}
+
+// for (index = low; index <= high; index += 1)
+bool BulkAccessFinder::findBounds() {
+  CallExpr* init = NULL;
+  CallExpr* test = NULL;
+  CallExpr* incr = NULL;
+  int64_t   step = 0;
+
+  if (mLoop->initBlockGet()->body.length == 1 &&
+      mLoop->testBlockGet()->body.length == 1 &&
+      mLoop->incrBlockGet()->body.length == 1) {
+    init = toCallExpr(mLoop->initBlockGet()->body.head);
+    test = toCallExpr(mLoop->testBlockGet()->body.head);
+    incr = toCallExpr(mLoop->incrBlockGet()->body.head);
+  }
+
+  if (init == NULL || isMoveOrAssign(init)                == false ||
+      test == NULL || test->isPrimitive(PRIM_LESSOREQUAL) == false ||
+      incr == NULL || incr->isPrimitive(PRIM_ADD_ASSIGN)  == false) {
+    return false;
+  }
+
+  if (SymExpr* se = toSymExpr(init->get(1))) {
+    index = se->symbol();
+  }
+
+  if (index                                 == NULL               ||
+      index->type                           != dtInt[INT_SIZE_64] ||
+      index->isRef()                        == true               ||
+      mWritten.count(index)                 != 0) {
+    return false;
+  }
+
+  if (SymExpr* se = toSymExpr(init->get(2))) {
+    low = se->symbol();
+  }
+
+  if (SymExpr* se = toSymExpr(test->get(2))) {
+    high = se->symbol();
+  }
+
+  return low                                != NULL               &&
+         high                               != NULL               &&
+         low->type                          == index->type        &&
+         high->type                         == index->type        &&
+         isInvariant(low)                   == true               &&
+         isInvariant(high)                  == true               &&
+         isSymExpr(test->get(1))            == true               &&
+         toSymExpr(test->get(1))->symbol()  == index              &&
+         isSymExpr(incr->get(1))            == true               &&
+         toSymExpr(incr->get(1))->symbol()  == index              &&
+         get_int(incr->get(2), &step)       == true               &&
+         step                               == 1;
+}
+
+void BulkAccessFinder::findWrittenSymbols() {
+  std::vector<CallExpr*> calls;
+
+  collectCallExprs(mLoop, calls);
+
+  for_vector(CallExpr, call, calls) {
+    if (mLoop->initBlockGet()->contains(call) == true ||
+        mLoop->incrBlockGet()->contains(call) == true) {
+      continue;
+    }
+
+    if (isMoveOrAssign(call)                  == true ||
+        isOpEqualPrim(call)                   == true ||
+        call->isPrimitive(PRIM_SET_MEMBER)    == true ||
+        call->isPrimitive(PRIM_ADDR_OF)       == true ||
+        call->isPrimitive(PRIM_SET_REFERENCE) == true) {
+      if (SymExpr* se = toSymExpr(call->get(1))) {
+        mWritten.insert(se->symbol());
+      }
+    }
+  }
+}
+
+bool BulkAccessFinder::checkStmts(BlockStmt* block) {
+  for_alist(stmt, block->body) {
+    if (DefExpr* def = toDefExpr(stmt)) {
+      if (isLabelSymbol(def->sym) == true) {
+        return false;
+      }
+
+    } else if (CallExpr* call = toCallExpr(stmt)) {
+      if (checkCall(call) == false) {
+        return false;
+      }
+
+    } else if (BlockStmt* inner = toBlockStmt(stmt)) {
+      if (inner->isLoopStmt()  == true ||
+          inner->blockInfoGet() != NULL ||
+          checkStmts(inner)     == false) {
+        return false;
+      }
+
+    } else {
+      // conditionals and gotos could skip an access
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool BulkAccessFinder::checkCall(CallExpr* call) {
+  if (isMoveOrAssign(call) == true || isOpEqualPrim(call) == true) {
+    SymExpr* lhs = toSymExpr(call->get(1));
+    Expr*    rhs = call->get(2);
+
+    if (lhs == NULL) {
+      return false;
+    }
+
+    std::map<Symbol*, size_t>::iterator it = mElementRefs.find(lhs->symbol());
+
+    // a store through an element reference
+    if (it != mElementRefs.end()) {
+      RemoteArray& array = arrays[it->second];
+
+      if (call->isPrimitive(PRIM_MOVE) == true) {
+        return false;
+      }
+
+      if (isOpEqualPrim(call) == true) {
+        array.isRead = true;
+      }
+
+      array.isWritten = true;
+
+      return checkExpr(rhs);
+    }
+
+    // the address of an element
+    if (CallExpr* rhsCall = toCallExpr(rhs)) {
+      if (rhsCall->isPrimitive(PRIM_ARRAY_GET)    == true &&
+          call->isPrimitive(PRIM_MOVE)            == true &&
+          lhs->symbol()->isWideRef()              == true) {
+        return defineElementRef(lhs->symbol(), rhsCall);
+      }
+    }
+
+    // a load through an element reference
+    if (CallExpr* rhsCall = toCallExpr(rhs)) {
+      SymExpr* ref = toSymExpr(rhsCall->get(1));
+
+      if (rhsCall->isPrimitive(PRIM_DEREF)        == true &&
+          ref                                     != NULL &&
+          mElementRefs.count(ref->symbol())       != 0) {
+        arrays[mElementRefs[ref->symbol()]].isRead = true;
+
+        return checkLocalStore(lhs->symbol(), rhs);
+      }
+    }
+
+    return checkExpr(rhs) && checkLocalStore(lhs->symbol(), rhs);
+  }
+
+  return checkExpr(call);
+}
+
+//
+// The body may only write memory that no array element can live in: the
+// function's own variables and their fields.
+//
+bool BulkAccessFinder::checkLocalStore(Symbol* sym, Expr* rhs) {
+  if (sym->isWideRef()                              == true ||
+      sym->type->symbol->hasFlag(FLAG_WIDE_CLASS)   == true) {
+    return false;
+
+  } else if (sym->isRef() == false) {
+    return true;
+
+  } else if (mLocalRefs.count(sym) != 0) {
+    return true;
+  }
+
+  // a reference to a variable, which the body may store through
+  if (CallExpr* call = toCallExpr(rhs)) {
+    SymExpr* se = toSymExpr(call->get(1));
+
+    if ((call->isPrimitive(PRIM_ADDR_OF)       == true ||
+         call->isPrimitive(PRIM_SET_REFERENCE) == true) &&
+        se                                     != NULL  &&
+        isVarSymbol(se->symbol())              == true  &&
+        se->symbol()->isRef()                  == false) {
+      mLocalRefs.insert(sym);
+      return true;
+    }
+  }
+
+  return false;
+}
+
+bool BulkAccessFinder::checkExpr(Expr* expr) {
+  if (SymExpr* se = toSymExpr(expr)) {
+    Symbol* sym = se->symbol();
+
+    if (isTypeSymbol(sym) == true) {
+      return true;
+
+    } else if (sym->isWideRef()                            == true ||
+               sym->type->symbol->hasFlag(FLAG_WIDE_CLASS) == true) {
+      return false;
+    }
+
+    return sym->isRef() == false || mLocalRefs.count(sym) != 0;
+
+  } else if (CallExpr* call = toCallExpr(expr)) {
+    if (call->isPrimitive() == false) {
+      return false;
+    }
+
+    switch (call->primitive->tag) {
+    case PRIM_UNARY_MINUS:
+    case PRIM_UNARY_PLUS:
+    case PRIM_UNARY_NOT:
+    case PRIM_UNARY_LNOT:
+    case PRIM_ADD:
+    case PRIM_SUBTRACT:
+    case PRIM_MULT:
+    case PRIM_DIV:
+    case PRIM_MOD:
+    case PRIM_LSH:
+    case PRIM_RSH:
+    case PRIM_EQUAL:
+    case PRIM_NOTEQUAL:
+    case PRIM_LESSOREQUAL:
+    case PRIM_GREATEROREQUAL:
+    case PRIM_LESS:
+    case PRIM_GREATER:
+    case PRIM_AND:
+    case PRIM_OR:
+    case PRIM_XOR:
+    case PRIM_POW:
+    case PRIM_MIN:
+    case PRIM_MAX:
+    case PRIM_GET_REAL:
+    case PRIM_GET_IMAG:
+    case PRIM_CAST:
+    case PRIM_DEREF:
+    case PRIM_ADD_ASSIGN:
+    case PRIM_SUBTRACT_ASSIGN:
+    case PRIM_MULT_ASSIGN:
+    case PRIM_DIV_ASSIGN:
+    case PRIM_MOD_ASSIGN:
+    case PRIM_LSH_ASSIGN:
+    case PRIM_RSH_ASSIGN:
+    case PRIM_AND_ASSIGN:
+    case PRIM_OR_ASSIGN:
+    case PRIM_XOR_ASSIGN:
+      break;
+
+    // these compute the address of a variable
+    case PRIM_ADDR_OF:
+    case PRIM_SET_REFERENCE:
+      if (SymExpr* se = toSymExpr(call->get(1))) {
+        return isVarSymbol(se->symbol()) == true &&
+               se->symbol()->isRef()     == false;
+      }
+
+      return false;
+
+    default:
+      return false;
+    }
+
+    for_actuals(actual, call) {
+      if (checkExpr(actual) == false) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  return false;
+}
+
+// 'ref' is moved the address of element 'index + offset' of a wide array
+bool BulkAccessFinder::defineElementRef(Symbol* ref, CallExpr* arrayGet) {
+  SymExpr* dataExpr  = toSymExpr(arrayGet->get(1));
+  SymExpr* indexExpr = toSymExpr(arrayGet->get(2));
+  Symbol*  data      = (dataExpr != NULL) ? dataExpr->symbol() : NULL;
+  Symbol*  addr      = NULL;
+  int64_t  offset    = 0;
+
+  if (data == NULL || indexExpr == NULL || mElementRefs.count(ref) != 0) {
+    return false;
+  }
+
+  if (data->type->symbol->hasFlag(FLAG_WIDE_CLASS) == true) {
+    addr = data->type->getField("addr", false);
+  }
+
+  if (addr                                          == NULL  ||
+      addr->type->symbol->hasFlag(FLAG_DATA_CLASS)  == false ||
+      isBulkElementType(getDataClassType(addr->type->symbol)->typeInfo())
+                                                    == false ||
+      isInvariant(data)                             == false ||
+      offsetOf(indexExpr->symbol(), offset)         == false) {
+    return false;
+  }
+
+  // every use of the reference must be one that checkCall() understands
+  for_SymbolSymExprs(se, ref) {
+    if (mLoop->contains(se) == false) {
+      return false;
+    }
+  }
+
+  std::vector<Symbol*> base = baseOf(data);
+  size_t               i    = 0;
+
+  for (i = 0; i < arrays.size(); i++) {
+    if (arrays[i].base == base) {
+      break;
+    }
+  }
+
+  if (i == arrays.size()) {
+    RemoteArray array;
+
+    array.base      = base;
+    array.data      = data;
+    array.refType   = ref->type;
+    array.minOffset = offset;
+    array.maxOffset = offset;
+
+    arrays.push_back(array);
+  }
+
+  arrays[i].dataSyms.insert(data);
+
+  if (offset < arrays[i].minOffset) arrays[i].minOffset = offset;
+  if (offset > arrays[i].maxOffset) arrays[i].maxOffset = offset;
+
+  mElementRefs[ref] = i;
+
+  return true;
+}
+
+// Defined outside the loop and not written in it
+bool BulkAccessFinder::isInvariant(Symbol* sym) {
+  if (VarSymbol* var = toVarSymbol(sym)) {
+    if (var->immediate != NULL) {
+      return true;
+    }
+  }
+
+  if (sym->isRefOrWideRef() == true || mWritten.count(sym) != 0) {
+    return false;
+  }
+
+  for_SymbolDefs(def, sym) {
+    if (mLoop->contains(def) == true) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+// 'sym' is the index, or a temp the body sets to the index plus a constant
+bool BulkAccessFinder::offsetOf(Symbol* sym, int64_t& offset) {
+  SymExpr*  def  = NULL;
+  CallExpr* move = NULL;
+  CallExpr* rhs  = NULL;
+
+  if (sym == index) {
+    offset = 0;
+    return true;
+  }
+
+  if ((def  = sym->getSingleDef())               == NULL  ||
+      mLoop->contains(def)                       == false ||
+      (move = toCallExpr(def->parentExpr))       == NULL  ||
+      move->isPrimitive(PRIM_MOVE)               == false ||
+      (rhs  = toCallExpr(move->get(2)))          == NULL) {
+    return false;
+  }
+
+  if (rhs->isPrimitive(PRIM_ADD) == true) {
+    SymExpr* lhs = toSymExpr(rhs->get(1));
+
+    if (lhs != NULL && lhs->symbol() == index)
+      return get_int(rhs->get(2), &offset);
+
+    lhs = toSymExpr(rhs->get(2));
+
+    if (lhs != NULL && lhs->symbol() == index)
+      return get_int(rhs->get(1), &offset);
+
+  } else if (rhs->isPrimitive(PRIM_SUBTRACT) == true) {
+    SymExpr* lhs = toSymExpr(rhs->get(1));
+
+    if (lhs != NULL && lhs->symbol() == index &&
+        get_int(rhs->get(2), &offset) == true) {
+      offset = -offset;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+// An array that is written must not be reached through another array
+bool BulkAccessFinder::checkAliases() {
+  for (size_t i = 0; i < arrays.size(); i++) {
+    if (arrays[i].isWritten == false) {
+      continue;
+    }
+
+    for (size_t j = 0; j < arrays.size(); j++) {
+      if (i != j && isDistinctArray(arrays[i], arrays[j]) == false) {
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+/************************************* | **************************************
+*                                                                             *
+* Rewrite the loop                                                            *
+*                                                                             *
+************************************** | *************************************/
+
+static void    moveOuterDefs(BlockStmt* block, CForLoop* loop);
+static Symbol* newLocal(const char* name, Type* type, Expr* before);
+
+static void rewriteLoop(CForLoop* loop, BulkAccessFinder& finder) {
+  SET_LINENO(loop);
+
+  // LICM can leave a declaration in the loop after hoisting its uses
+  moveOuterDefs(loop, loop);
+
+  Type*      idxType  = finder.index->type;
+  BlockStmt* bulk     = new BlockStmt();
+  BlockStmt* fallback = new BlockStmt();
+  Symbol*    count    = newLocal("bulk_count", idxType, loop);
+  Symbol*    isLow    = newLocal("bulk_has_iters", dtBool, loop);
+  Symbol*    isFit    = newLocal("bulk_fits", dtBool, loop);
+  Symbol*    useBulk  = newLocal("bulk_use_buffers", dtBool, loop);
+  SymbolMap  map;
+
+  loop->insertBefore(new CallExpr(PRIM_MOVE, count,
+                       new CallExpr(PRIM_SUBTRACT, finder.high, finder.low)));
+  loop->insertBefore(new CallExpr(PRIM_ADD_ASSIGN, count, new_IntSymbol(1)));
+  loop->insertBefore(new CallExpr(PRIM_MOVE, isLow,
+                       new CallExpr(PRIM_GREATER, count, new_IntSymbol(0))));
+  loop->insertBefore(new CallExpr(PRIM_MOVE, isFit,
+                       new CallExpr(PRIM_LESSOREQUAL,
+                                    count,
+                                    new_IntSymbol(maxBulkElements))));
+  loop->insertBefore(new CallExpr(PRIM_MOVE, useBulk,
+                       new CallExpr(PRIM_AND, isLow, isFit)));
+
+  loop->insertBefore(new CondStmt(new SymExpr(useBulk), bulk, fallback));
+
+  CForLoop* copy = loop->copy(&map);
+
+  fallback->insertAtTail(loop->remove());
+
+  bulk->insertAtTail(copy);
+
+  std::vector<Symbol*> buffers;
+  std::vector<Symbol*> lengths;
+  std::vector<Symbol*> localRefs;
+  std::vector<Symbol*> remoteRefs;
+  std::vector<Symbol*> nodes;
+
+  for (size_t i = 0; i < finder.arrays.size(); i++) {
+    RemoteArray& array   = finder.arrays[i];
+    Type*        bufType = array.data->type->getField("addr")->type;
+    Type*        refType = array.refType->getField("addr")->type;
+    int64_t      extra   = array.maxOffset - array.minOffset;
+    Symbol*      start   = newLocal("bulk_start", idxType, NULL);
+    Symbol*      shift   = newLocal("bulk_shift", idxType, NULL);
+    Symbol*      len     = newLocal("bulk_len", idxType, NULL);
+    Symbol*      buf     = newLocal("bulk_buf", bufType, NULL);
+    Symbol*      shifted = newLocal("bulk_shifted_buf", bufType, NULL);
+    Symbol*      local   = newLocal("bulk_local_ref", refType, NULL);
+    Symbol*      remote  = newLocal("bulk_remote_ref", array.refType, NULL);
+    Symbol*      node    = newLocal("bulk_node", NODE_ID_TYPE, NULL);
+
+    local->qual  = QUAL_REF;
+    remote->qual = QUAL_WIDE_REF;
+
+    copy->insertBefore(new DefExpr(start));
+    copy->insertBefore(new DefExpr(shift));
+    copy->insertBefore(new DefExpr(len));
+    copy->insertBefore(new DefExpr(buf));
+    copy->insertBefore(new DefExpr(shifted));
+    copy->insertBefore(new DefExpr(local));
+    copy->insertBefore(new DefExpr(remote));
+    copy->insertBefore(new DefExpr(node));
+
+    // the elements low+minOffset .. high+maxOffset
+    copy->insertBefore(new CallExpr(PRIM_MOVE, start,
+                         new CallExpr(PRIM_ADD,
+                                      finder.low,
+                                      new_IntSymbol(array.minOffset))));
+    copy->insertBefore(new CallExpr(PRIM_MOVE, shift,
+                         new CallExpr(PRIM_UNARY_MINUS, start)));
+    copy->insertBefore(new CallExpr(PRIM_MOVE, len,
+                         new CallExpr(PRIM_ADD,
+                                      count,
+                                      new_IntSymbol(extra))));
+
+    copy->insertBefore(new CallExpr(PRIM_ARRAY_ALLOC,
+                                    buf,
+                                    len,
+                                    gFalse,
+                                    new_IntSymbol(-1, INT_SIZE_32)));
+
+    // so that the copied loop can index the buffer as it did the array
+    copy->insertBefore(new CallExpr(PRIM_ARRAY_SHIFT_BASE_POINTER,
+                                    shifted,
+                                    buf,
+                                    shift));
+
+    copy->insertBefore(new CallExpr(PRIM_MOVE, local,
+                         new CallExpr(PRIM_ARRAY_GET, buf, new_IntSymbol(0))));
+    copy->insertBefore(new CallExpr(PRIM_MOVE, remote,
+                         new CallExpr(PRIM_ARRAY_GET, array.data, start)));
+    copy->insertBefore(new CallExpr(PRIM_MOVE, node,
+                         new CallExpr(PRIM_WIDE_GET_NODE, remote)));
+
+    // a loop that writes some elements of the range but not others leaves
+    // the others as they were
+    if (array.isRead == true || extra != 0) {
+      copy->insertBefore(new CallExpr(PRIM_CHPL_COMM_ARRAY_GET,
+                                      local,
+                                      node,
+                                      remote,
+                                      len));
+    }
+
+    buffers.push_back(buf);
+    lengths.push_back(len);
+    localRefs.push_back(local);
+    remoteRefs.push_back(remote);
+    nodes.push_back(node);
+
+    // index the buffer instead of the array in the copy
+    std::vector<SymExpr*> symExprs;
+
+    collectSymExprs(copy, symExprs);
+
+    for_vector(SymExpr, se, symExprs) {
+      if (array.dataSyms.count(se->symbol()) != 0) {
+        CallExpr* arrayGet = toCallExpr(se->parentExpr);
+        CallExpr* move     = toCallExpr(arrayGet->parentExpr);
+        Symbol*   ref      = toSymExpr(move->get(1))->symbol();
+
+        se->setSymbol(shifted);
+
+        ref->type = refType;
+        ref->qual = QUAL_REF;
+      }
+    }
+  }
+
+
+  for (size_t i = 0; i < finder.arrays.size(); i++) {
+    if (finder.arrays[i].isWritten == true) {
+      bulk->insertAtTail(new CallExpr(PRIM_CHPL_COMM_ARRAY_PUT,
+                                      localRefs[i],
+                                      nodes[i],
+                                      remoteRefs[i],
+                                      lengths[i]));
+    }
+
+    bulk->insertAtTail(new CallExpr(PRIM_ARRAY_FREE, buffers[i], lengths[i]));
+  }
+}
+
+// Move declarations out of the loop for symbols that are used outside it
+static void moveOuterDefs(BlockStmt* block, CForLoop* loop) {
+  for_alist(stmt, block->body) {
+    if (DefExpr* def = toDefExpr(stmt)) {
+      for_SymbolSymExprs(se, def->sym) {
+        if (loop->contains(se) == false) {
+          loop->insertBefore(def->remove());
+          break;
+        }
+      }
+
+    } else if (BlockStmt* inner = toBlockStmt(stmt)) {
+      moveOuterDefs(inner, loop);
+    }
+  }
+}
+
+static Symbol* newLocal(const char* name, Type* type, Expr* before) {
+  VarSymbol* retval = newTemp(name, type);
+
+  if (before != NULL) {
+    before->insertBefore(new DefExpr(retval));
+  }
+
+  return retval;
+}
+
+/************************************* | **************************************
+*                                                                             *
+* Helpers                                                                     *
+*                                                                             *
+************************************** | *************************************/
+
+//
+// The variable a data pointer was loaded from, then the fields it was
+// loaded through
+//
+static std::vector<Symbol*> baseOf(Symbol* sym) {
+  std::vector<Symbol*> fields;
+  std::vector<Symbol*> retval;
+
+  for (int i = 0; i < 16 && sym->hasFlag(FLAG_TEMP) == true; i++) {
+    SymExpr*  def  = sym->getSingleDef();
+    CallExpr* move = def ? toCallExpr(def->parentExpr) : NULL;
+
+    if (move == NULL || move->isPrimitive(PRIM_MOVE) == false) {
+      break;
+
+    } else if (SymExpr* se = toSymExpr(move->get(2))) {
+      sym = se->symbol();
+
+    } else if (CallExpr* call = toCallExpr(move->get(2))) {
+      SymExpr* obj   = toSymExpr(call->get(1));
+      SymExpr* field = NULL;
+
+      if (call->isPrimitive(PRIM_GET_MEMBER_VALUE) == false ||
+          obj                                      == NULL  ||
+          (field = toSymExpr(call->get(2)))        == NULL) {
+        break;
+      }
+
+      fields.push_back(field->symbol());
+
+      sym = obj->symbol();
+
+    } else {
+      break;
+    }
+  }
+
+  retval.push_back(sym);
+
+  for (size_t i = fields.size(); i > 0; i--) {
+    retval.push_back(fields[i - 1]);
+  }
+
+  return retval;
+}
+
+static bool isBulkElementType(Type* type) {
+  return is_bool_type(type)    == true ||
+         is_int_type(type)     == true ||
+         is_uint_type(type)    == true ||
+         is_real_type(type)    == true ||
+         is_imag_type(type)    == true ||
+         is_complex_type(type) == true;
+}
+
+//
+// Two user arrays that are held by different variables do not share
+// their elements.  Temps and references may hold another name for an
+// array.
+//
+static bool isDistinctArray(const RemoteArray& a, const RemoteArray& b) {
+  Symbol* rootA = a.base[0];
+  Symbol* rootB = b.base[0];
+
+  return rootA                                    != rootB &&
+         a.base.size()                            >  1     &&
+         b.base.size()                            >  1     &&
+         isVarSymbol(rootA)                       == true  &&
+         isVarSymbol(rootB)                       == true  &&
+         rootA->isRefOrWideRef()                  == false &&
+         rootB->isRefOrWideRef()                  == false &&
+         rootA->hasFlag(FLAG_TEMP)                == false &&
+         rootB->hasFlag(FLAG_TEMP)                == false &&
+         rootA->type->symbol->hasFlag(FLAG_ARRAY) == true  &&
+         rootB->type->symbol->hasFlag(FLAG_ARRAY) == true;
+}
+
+static void reportLoop(CForLoop* loop, BulkAccessFinder& finder) {
+  ModuleSymbol* mod = loop->getModule();
+
+  if (developer == true || mod->modTag == MOD_USER) {
+    for (size_t i = 0; i < finder.arrays.size(); i++) {
+      RemoteArray& array = finder.arrays[i];
+      Symbol*      root  = array.base[0];
+      const char*  name  = "an array";
+
+      if (root->hasFlag(FLAG_TEMP) == false) {
+        name = root->name;
+      }
+
+      if (array.isRead == true) {
+        printf("Bulk get of %s for loop at %s:%d\n",
+               name, mod->name, loop->linenum());
+      }
+
+      if (array.isWritten == true) {
+        printf("Bulk put of %s for loop at %s:%d\n",
+               name, mod->name, loop->linenum());
+      }
+    }
+  }
+}
@@ -24,6 +24,7 @@
 #include "astutil.h"
 #include "bb.h"
 #include "bitVec.h"
+#include "compilerThreads.h"
 #include "driver.h"
 #include "expr.h"
 #include "passes.h"
@@ -123,7 +124,7 @@
 //#############################################################################
 
 
-static size_t s_repl_count; ///< The number of pairs replaced by GCP this pass.
+static CHPL_THREAD_LOCAL size_t s_repl_count; ///< The number of pairs replaced by GCP this pass.
 
 //#############################################################################
 //# LOCAL COPY PROPAGATION
@@ -942,26 +943,27 @@ size_t globalCopyPropagation(FnSymbol* fn) {
   return s_repl_count;
 }
 
-void copyPropagation(void) {
-  if (!fNoCopyPropagation) {
-    forv_Vec(FnSymbol, fn, gFnSymbols)
-    {
-      // This test is necessary because extern function stubs may contain
-      // _construct_tuple calls that are unresolved.
-      if (fn->hasFlag(FLAG_EXTERN))
-        continue;
+static void copyPropagation(FnSymbol* fn) {
+  // This test is necessary because extern function stubs may contain
+  // _construct_tuple calls that are unresolved.
+  if (fn->hasFlag(FLAG_EXTERN))
+    return;
 
-      localCopyPropagation(fn);
-      if (!fNoDeadCodeElimination)
-        deadVariableElimination(fn);
+  localCopyPropagation(fn);
+  if (!fNoDeadCodeElimination)
+    deadVariableElimination(fn);
 
-      // Iterate GCP with dead code elimination.
-      while (globalCopyPropagation(fn) > 0)
-      {
-        if (!fNoDeadCodeElimination)
-          deadVariableElimination(fn);
-      }
-    }
+  // Iterate GCP with dead code elimination.
+  while (globalCopyPropagation(fn) > 0)
+  {
+    if (!fNoDeadCodeElimination)
+      deadVariableElimination(fn);
+  }
+}
+
+void copyPropagation(void) {
+  if (!fNoCopyPropagation) {
+    forEachFnInParallel(gFnSymbols, copyPropagation);
   }
 }
 
@@ -22,8 +22,10 @@
 
 #include "astutil.h"
 #include "bb.h"
+#include "compilerThreads.h"
 #include "driver.h"
 #include "expr.h"
+#include "fnNodeIndex.h"
 #include "ForLoop.h"
 #include "ModuleSymbol.h"
 #include "passes.h"
@@ -43,8 +45,9 @@ static void deleteUnreachableBlocks(FnSymbol* fn, BasicBlockSet& reachable);
 static bool         isInCForLoopHeader(Expr* expr);
 static void         cleanupLoopBlocks(FnSymbol* fn);
 
-static unsigned int deadBlockCount;
-static unsigned int deadModuleCount;
+static unsigned int  deadBlockCount;
+static CompilerMutex deadBlockCountMutex;
+static unsigned int  deadModuleCount;
 
 
 
@@ -81,8 +84,15 @@ static bool isDeadVariable(Symbol* var) {
 }
 
 void deadVariableElimination(FnSymbol* fn) {
-  std::set<Symbol*> symSet;
-  collectSymbolSet(fn, symSet);
+  std::set<Symbol*>     symSet;
+  std::vector<DefExpr*> defs;
+
+  fnDefExprs(fn, defs);
+
+  for_vector(DefExpr, def, defs) {
+    if (isLcnSymbol(def->sym))
+      symSet.insert(def->sym);
+  }
 
   // Use 'symSet' and 'todo' together for a unique queue of symbols to process
   std::queue<Symbol*> todo;
@@ -461,30 +471,31 @@ static void deadModuleElimination() {
   }
 }
 
-void deadCodeElimination() {
-  if (!fNoDeadCodeElimination) {
-    deadBlockElimination();
+static void deadCodeElimination(FnSymbol* fn) {
+  // 2014/10/17   Noakes and Elliot
+  // Dead Block Elimination may convert valid loops to "malformed" loops.
+  // Some of these will break BasicBlock construction. Clean them up.
+  cleanupLoopBlocks(fn);
 
-    deadStringLiteralElimination();
+  deadVariableElimination(fn);
 
+  // 2014/10/17   Noakes and Elliot
+  // Dead Variable Elimination may convert some "uninteresting" loops
+  // that were left behind by DeadBlockElimination and turn them in to
+  // "malformed" loops.  Cleanup again.
+  cleanupLoopBlocks(fn);
 
-    forv_Vec(FnSymbol, fn, gFnSymbols) {
+  deadExpressionElimination(fn);
+}
 
-      // 2014/10/17   Noakes and Elliot
-      // Dead Block Elimination may convert valid loops to "malformed" loops.
-      // Some of these will break BasicBlock construction. Clean them up.
-      cleanupLoopBlocks(fn);
+void deadCodeElimination() {
+  if (!fNoDeadCodeElimination) {
+    deadBlockElimination();
 
-      deadVariableElimination(fn);
+    deadStringLiteralElimination();
 
-      // 2014/10/17   Noakes and Elliot
-      // Dead Variable Elimination may convert some "uninteresting" loops
-      // that were left behind by DeadBlockElimination and turn them in to
-      // "malformed" loops.  Cleanup again.
-      cleanupLoopBlocks(fn);
 
-      deadExpressionElimination(fn);
-    }
+    forEachFnInParallel(gFnSymbols, deadCodeElimination);
 
     deadModuleElimination();
 
@@ -497,12 +508,7 @@ void deadBlockElimination()
 {
   deadBlockCount = 0;
 
-  forv_Vec(FnSymbol, fn, gFnSymbols)
-  {
-    if (!isAlive(fn))
-      continue;
-    deadBlockElimination(fn);
-  }
+  forEachFnInParallel(gFnSymbols, deadBlockElimination);
 
   if (fReportDeadBlocks)
     printf("\tRemoved %d dead blocks.\n", deadBlockCount);
@@ -512,6 +518,9 @@ void deadBlockElimination()
 // Look for and remove unreachable blocks.
 static void deadBlockElimination(FnSymbol* fn)
 {
+  if (!isAlive(fn))
+    return;
+
   // We need the basic block information to be correct, so recompute it.
   BasicBlock::buildBasicBlocks(fn);
 
@@ -558,13 +567,15 @@ static void findReachableBlocks(FnSymbol* fn, BasicBlockSet& reachable)
 
 static void deleteUnreachableBlocks(FnSymbol* fn, BasicBlockSet& reachable)
 {
+  unsigned int numDeleted = 0;
+
   // Visit all the blocks, deleting all those that are not reachable
   for_vector(BasicBlock, bb, *fn->basicBlocks)
   {
     if (reachable.count(bb))
       continue;
 
-    ++deadBlockCount;
+    ++numDeleted;
 
     // Remove all of its expressions.
     for_vector(Expr, expr, bb->exprs)
@@ -615,6 +626,10 @@ static void deleteUnreachableBlocks(FnSymbol* fn, BasicBlockSet& reachable)
         expr->remove();
     }
   }
+
+  ParallelLockGuard guard(deadBlockCountMutex);
+
+  deadBlockCount += numDeleted;
 }
 
 //
@@ -0,0 +1,364 @@
+/*
+ * Copyright 2004-2017 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "passes.h"
+
+#include "astutil.h"
+#include "driver.h"
+#include "expr.h"
+#include "stlUtil.h"
+#include "stmt.h"
+#include "symbol.h"
+#include "type.h"
+
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <set>
+#include <vector>
+
+/************************************* | **************************************
+*                                                                             *
+* Turn the last use of a record into a move.  Initializing one record from   *
+* a local that is destroyed without being mentioned again,                   *
+*                                                                             *
+*   move b, chpl__initCopy(a)                                                 *
+*   ...                                                                       *
+*   chpl__autoDestroy(a)                                                      *
+*                                                                             *
+* becomes                                                                     *
+*                                                                             *
+*   move b, a                                                                 *
+*   ...                                                                       *
+*                                                                             *
+* so 'b' takes over the value of 'a', e.g. the buffer of a string, instead   *
+* of copying it and freeing the original.                                     *
+*                                                                             *
+* 'a' must be a local declared in the same block as the copy and the        *
+* destroy, and every other mention of it must come before the copy.  Those   *
+* mentions may not let a reference or a pointer into 'a' outlive them, since *
+* it would see the value now owned by 'b'.                                    *
+*                                                                             *
+* Copying and destroying a record is not observable unless a user module    *
+* gives it, or a record it contains, a constructor, initializer or deinit.   *
+* Such records, and the records that wrap arrays, domains, synchronization   *
+* variables and atomics, are left alone.                                      *
+*                                                                             *
+************************************** | *************************************/
+
+struct CopySite {
+  CallExpr* move;               // move b, chpl__initCopy(a)
+  CallExpr* destroy;            // chpl__autoDestroy(a)
+  Symbol*   src;
+};
+
+static void buildUserLifecycleTypes(std::set<Type*>& types);
+
+static bool findCopy(CallExpr*              call,
+                     CopySite&              site,
+                     std::set<Type*>&       userTypes,
+                     std::map<Type*, bool>& movable);
+static bool findDestroy(CopySite& site);
+
+static bool isMovableType(Type*                  type,
+                          std::set<Type*>&       userTypes,
+                          std::map<Type*, bool>& movable);
+static bool isUserDefined(FnSymbol* fn);
+static bool isPointerType(Type* type);
+static bool isSafeEarlierUse(SymExpr* se);
+
+static Expr* statementIn(Expr* expr, Expr* block);
+static bool  comesBefore(Expr* stmt, Expr* other);
+
+static void convertToMove(CopySite& site);
+
+void elideCopies() {
+  std::set<Type*>       userTypes;
+  std::map<Type*, bool> movable;
+  int                   numElided = 0;
+
+  if (fNoCopyElision == true) {
+    return;
+  }
+
+  buildUserLifecycleTypes(userTypes);
+
+  forv_Vec(FnSymbol, fn, gFnSymbols) {
+    std::vector<CallExpr*> calls;
+
+    collectCallExprs(fn, calls);
+
+    for_vector(CallExpr, call, calls) {
+      CopySite site;
+
+      if (findCopy(call, site, userTypes, movable) == true &&
+          findDestroy(site)                        == true) {
+        if (fReportCopyElision == true) {
+          ModuleSymbol* mod = fn->getModule();
+
+          if (developer == true || mod->modTag == MOD_USER) {
+            printf("Moved %s at %s:%d\n",
+                   site.src->type->symbol->name,
+                   mod->name,
+                   site.move->linenum());
+          }
+        }
+
+        convertToMove(site);
+
+        numElided++;
+      }
+    }
+  }
+
+  if (fReportCopyElision == true && developer == true) {
+    printf("Elided %d copies\n", numElided);
+  }
+}
+
+//
+// Collects the types whose construction or destruction runs code from a
+// user module.
+//
+static void buildUserLifecycleTypes(std::set<Type*>& types) {
+  forv_Vec(FnSymbol, fn, gFnSymbols) {
+    if (isUserDefined(fn) == true) {
+      if (fn->hasFlag(FLAG_CONSTRUCTOR) == true) {
+        types.insert(fn->retType->getValType());
+
+      } else if (fn->_this != NULL &&
+                 (fn->hasFlag(FLAG_DESTRUCTOR)     == true ||
+                  strcmp(fn->name, "init")         == 0    ||
+                  strcmp(fn->name, "initialize")   == 0)) {
+        types.insert(fn->_this->getValType());
+      }
+    }
+  }
+}
+
+//
+// Matches 'move b, chpl__initCopy(a)' or 'move b, chpl__autoCopy(a)' where
+// 'a' is a local record of a type whose copies can be elided.
+//
+static bool findCopy(CallExpr*              call,
+                     CopySite&              site,
+                     std::set<Type*>&       userTypes,
+                     std::map<Type*, bool>& movable) {
+  FnSymbol* copyFn = call->resolvedFunction();
+  CallExpr* move   = toCallExpr(call->parentExpr);
+  bool      retval = false;
+
+  if (copyFn                                   != NULL  &&
+      (copyFn->hasFlag(FLAG_INIT_COPY_FN)      == true  ||
+       copyFn->hasFlag(FLAG_AUTO_COPY_FN)      == true) &&
+      copyFn->hasFlag(FLAG_ERRONEOUS_INITCOPY) == false &&
+      copyFn->hasFlag(FLAG_ERRONEOUS_AUTOCOPY) == false &&
+      isUserDefined(copyFn)                    == false &&
+      call->numActuals()                       == 1     &&
+      move                                     != NULL  &&
+      move->isPrimitive(PRIM_MOVE)             == true  &&
+      move->get(2)                             == call  &&
+      isBlockStmt(move->parentExpr)            == true) {
+    SymExpr* lhs    = toSymExpr(move->get(1));
+    SymExpr* actual = toSymExpr(call->get(1));
+
+    if (lhs != NULL && actual != NULL) {
+      VarSymbol* src = toVarSymbol(actual->symbol());
+
+      if (src                                   != NULL                 &&
+          src                                   != lhs->symbol()        &&
+          src->isRef()                          == false                &&
+          src->hasFlag(FLAG_NO_AUTO_DESTROY)    == false                &&
+          src->defPoint->parentExpr             == move->parentExpr     &&
+          lhs->symbol()->type                   == src->type            &&
+          copyFn->retType                       == src->type            &&
+          lhs->symbol()->hasFlag(FLAG_NECESSARY_AUTO_COPY) == false     &&
+          isMovableType(src->type, userTypes, movable) == true) {
+        site.move    = move;
+        site.destroy = NULL;
+        site.src     = src;
+
+        retval       = true;
+      }
+    }
+  }
+
+  return retval;
+}
+
+//
+// Finds the destroy of the copied local, and returns true if nothing
+// after the copy but that destroy mentions it.
+//
+static bool findDestroy(CopySite& site) {
+  Expr* block = site.move->parentExpr;
+
+  for_SymbolSymExprs(se, site.src) {
+    CallExpr* parent = toCallExpr(se->parentExpr);
+    Expr*     stmt   = statementIn(se, block);
+
+    if (parent != NULL && parent->parentExpr == site.move) {
+      continue;
+
+    } else if (stmt == NULL) {
+      return false;
+
+    } else if (parent             != NULL             &&
+               parent             == stmt             &&
+               parent->resolvedFunction() != NULL     &&
+               parent->resolvedFunction()->hasFlag(FLAG_AUTO_DESTROY_FN)) {
+      if (site.destroy != NULL || comesBefore(site.move, stmt) == false) {
+        return false;
+      }
+
+      site.destroy = parent;
+
+    } else if (comesBefore(stmt, site.move) == false ||
+               isSafeEarlierUse(se)         == false) {
+      return false;
+    }
+  }
+
+  return site.destroy != NULL;
+}
+
+//
+// A mention of the local before the copy is safe if it cannot leave behind
+// a reference or a pointer into the value, or hand it to another task.
+//
+static bool isSafeEarlierUse(SymExpr* se) {
+  CallExpr* call   = toCallExpr(se->parentExpr);
+  bool      retval = false;
+
+  if (call == NULL) {
+    retval = false;
+
+  } else if (call->isPrimitive(PRIM_MOVE) == true && call->get(1) == se) {
+    retval = true;
+
+  } else if (call->isPrimitive(PRIM_GET_MEMBER_VALUE) == true) {
+    retval = call->get(1) == se && isPointerType(call->typeInfo()) == false;
+
+  } else if (FnSymbol* fn = call->resolvedFunction()) {
+    retval = isTaskFun(fn)              == false      &&
+             fn->retTag                 != RET_REF    &&
+             fn->retTag                 != RET_CONST_REF &&
+             fn->retType->isRef()       == false      &&
+             isPointerType(fn->retType) == false;
+  }
+
+  return retval;
+}
+
+static bool isMovableType(Type*                  type,
+                          std::set<Type*>&       userTypes,
+                          std::map<Type*, bool>& movable) {
+  std::map<Type*, bool>::iterator it     = movable.find(type);
+  AggregateType*                  at     = toAggregateType(type);
+  bool                            retval = true;
+
+  if (it != movable.end()) {
+    return it->second;
+  }
+
+  if (at == NULL || isRecord(at) == false) {
+    retval = false;
+
+  } else if (at->symbol->hasFlag(FLAG_ARRAY)            == true ||
+             at->symbol->hasFlag(FLAG_DOMAIN)           == true ||
+             at->symbol->hasFlag(FLAG_DISTRIBUTION)     == true ||
+             at->symbol->hasFlag(FLAG_SYNC)             == true ||
+             at->symbol->hasFlag(FLAG_SINGLE)           == true ||
+             at->symbol->hasFlag(FLAG_ATOMIC_TYPE)      == true ||
+             at->symbol->hasFlag(FLAG_ITERATOR_RECORD)  == true ||
+             at->symbol->hasFlag(FLAG_TUPLE)            == true ||
+             at->symbol->hasFlag(FLAG_EXTERN)           == true ||
+             at->symbol->hasFlag(FLAG_RUNTIME_TYPE_VALUE) == true ||
+             userTypes.count(at)                        >  0) {
+    retval = false;
+
+  } else {
+    for_fields(field, at) {
+      Type* fieldType = field->type->getValType();
+
+      if (fieldType->symbol->hasFlag(FLAG_SYNC)        == true ||
+          fieldType->symbol->hasFlag(FLAG_SINGLE)      == true ||
+          fieldType->symbol->hasFlag(FLAG_ATOMIC_TYPE) == true) {
+        retval = false;
+
+      } else if (isRecord(fieldType) == true &&
+                 isMovableType(fieldType, userTypes, movable) == false) {
+        retval = false;
+      }
+
+      if (retval == false) {
+        break;
+      }
+    }
+  }
+
+  movable[type] = retval;
+
+  return retval;
+}
+
+static bool isUserDefined(FnSymbol* fn) {
+  return fn->getModule()->modTag            == MOD_USER &&
+         fn->hasFlag(FLAG_COMPILER_GENERATED) == false;
+}
+
+// Could a value of this type point into a record's storage?
+static bool isPointerType(Type* type) {
+  return type                                  == dtCVoidPtr ||
+         type                                  == dtStringC  ||
+         type->symbol->hasFlag(FLAG_C_PTR_CLASS) == true     ||
+         type->symbol->hasFlag(FLAG_DATA_CLASS)  == true;
+}
+
+// The statement of 'block' containing 'expr', if any
+static Expr* statementIn(Expr* expr, Expr* block) {
+  Expr* stmt = expr;
+
+  while (stmt != NULL && stmt->parentExpr != block) {
+    stmt = stmt->parentExpr;
+  }
+
+  return stmt;
+}
+
+// Is 'stmt' earlier than 'other' in the same list?
+static bool comesBefore(Expr* stmt, Expr* other) {
+  for (Expr* cur = stmt->next; cur != NULL; cur = cur->next) {
+    if (cur == other) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+static void convertToMove(CopySite& site) {
+  CallExpr* copy = toCallExpr(site.move->get(2));
+
+  SET_LINENO(site.move);
+
+  copy->replace(new SymExpr(site.src));
+
+  site.destroy->remove();
+}
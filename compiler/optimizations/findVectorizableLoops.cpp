@@ -0,0 +1,848 @@
+/*
+ * Copyright 2004-2017 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//
+// findVectorizableLoops
+// ---------------------
+//
+// A loop is marked order independent when it comes from a forall or a
+// vectorizeOnly() loop, but the body of such a loop can still read what
+// an earlier iteration wrote, e.g.
+//
+//   forall i in 2..n do A[i] = A[i-1];
+//
+// This pass looks at the body of each order independent C for loop and
+// marks the loop vectorizable only when no element of memory written by
+// one iteration can be read or written by another:
+//
+//   * every element written or read is reached through an array_get of
+//     a loop invariant data pointer, at an index that is an affine
+//     function of exactly one induction variable
+//
+//   * for each data pointer that is written, every access uses the same
+//     affine index, so each iteration touches its own element
+//
+//   * the body makes no calls, contains no nested loops, does not leave
+//     the loop early and does not let a reference to an element escape
+//
+//   * scalars that live across iterations are locals whose address is
+//     never taken, so the backend can keep them in registers
+//
+// Data pointers that are loaded from different arrays are assumed not to
+// overlap.  The forall itself asserts this; the analysis only catches
+// dependences between accesses to the same array.
+//
+// --vectorize-safe-loops emits a vectorization hint for the loops that
+// are marked; --vectorize emits one for every order independent loop.
+//
+
+#include "passes.h"
+
+#include "astutil.h"
+#include "CForLoop.h"
+#include "driver.h"
+#include "expr.h"
+#include "stlUtil.h"
+#include "stmt.h"
+#include "stringutil.h"
+#include "symbol.h"
+
+#include <cstdio>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+// a + sum(terms[sym] * sym), where each sym is an induction variable or a
+// loop invariant symbol
+struct AffineIndex {
+  AffineIndex() : known(false), constant(0) { }
+
+  bool                       known;
+  int64_t                    constant;
+  std::map<Symbol*, int64_t> terms;
+};
+
+struct MemoryAccess {
+  std::vector<Symbol*> base;      // empty if the memory is not known
+  AffineIndex          index;
+  bool                 isWrite;
+};
+
+class LoopDependenceChecker {
+public:
+                         LoopDependenceChecker(CForLoop* loop);
+
+  bool                   check();
+
+  std::string            reason;
+
+private:
+  void                   findInductionVariables();
+  void                   findWrittenSymbols(BlockStmt* block);
+
+  bool                   checkStmts(BlockStmt* block, bool conditional);
+  bool                   checkStmt(Expr* stmt, bool conditional);
+  bool                   checkCall(CallExpr* call, bool conditional);
+  bool                   checkExpr(Expr* expr);
+  bool                   checkScalarWrite(Symbol* sym);
+  bool                   checkAccesses();
+
+  void                   defineRef(Symbol* ref, Expr* rhs);
+  void                   defineValue(Symbol* sym, Expr* rhs, bool conditional);
+
+  void                   read(Symbol* ref);
+  void                   write(Symbol* ref);
+
+  AffineIndex            evaluate(Expr* expr);
+  std::vector<Symbol*>   baseOf(Symbol* sym);
+  const char*            baseName(const std::vector<Symbol*>& base);
+
+  bool                   fail(const char* format, const char* name = NULL);
+
+  CForLoop*                          mLoop;
+
+  std::set<Symbol*>                  mInductionVars;
+  std::set<Symbol*>                  mWritten;
+  std::set<LabelSymbol*>             mSeenLabels;
+  bool                               mAfterGoto;
+
+  std::map<Symbol*, AffineIndex>     mValues;
+  std::map<Symbol*, MemoryAccess>    mRefs;
+  std::vector<MemoryAccess>          mAccesses;
+};
+
+static void reportLoop(CForLoop* loop, const char* reason);
+
+void findVectorizableLoops() {
+  if (fNoVectorizeSafeLoops == false || fReportVectorization == true) {
+    forv_Vec(BlockStmt, block, gBlockStmts) {
+      CForLoop* loop = toCForLoop(block);
+
+      if (loop                       != NULL  &&
+          loop->parentSymbol         != NULL  &&
+          loop->isOrderIndependent() == true) {
+        LoopDependenceChecker checker(loop);
+        bool                  safe = checker.check();
+
+        loop->vectorizableSet(safe);
+
+        if (fReportVectorization == true) {
+          reportLoop(loop, safe ? NULL : checker.reason.c_str());
+        }
+      }
+    }
+  }
+}
+
+static void reportLoop(CForLoop* loop, const char* reason) {
+  ModuleSymbol* mod = loop->getModule();
+
+  if (developer == true || mod->modTag == MOD_USER) {
+    if (reason == NULL) {
+      printf("%s for %s:%d is safe to vectorize\n",
+             loop->astTagAsString(), mod->name, loop->linenum());
+    } else {
+      printf("%s for %s:%d is not safe to vectorize: %s\n",
+             loop->astTagAsString(), mod->name, loop->linenum(), reason);
+    }
+  }
+}
+
+/************************************* | **************************************
+*                                                                             *
+* Check one loop                                                              *
+*                                                                             *
+************************************** | *************************************/
+
+LoopDependenceChecker::LoopDependenceChecker(CForLoop* loop) :
+  mLoop(loop), mAfterGoto(false) {
+
+}
+
+bool LoopDependenceChecker::check() {
+  findWrittenSymbols(mLoop);
+  findWrittenSymbols(mLoop->testBlockGet());
+  findWrittenSymbols(mLoop->incrBlockGet());
+
+  findInductionVariables();
+
+  if (mInductionVars.size() == 0)
+    return fail("it has no induction variable");
+
+  return checkStmts(mLoop, false) && checkAccesses();
+}
+
+//
+// An induction variable is stepped by a constant or loop invariant amount
+// in the increment clause and is not otherwise written in the loop.  Zip
+// loops step a copy and move it back, so copies of a stepped symbol count.
+//
+void LoopDependenceChecker::findInductionVariables() {
+  std::vector<CallExpr*> calls;
+  std::set<Symbol*>      bodyWrites;
+
+  collectCallExprs(mLoop->incrBlockGet(), calls);
+
+  for_vector(CallExpr, call, calls) {
+    if (call->isPrimitive(PRIM_ADD_ASSIGN)      == true ||
+        call->isPrimitive(PRIM_SUBTRACT_ASSIGN) == true) {
+      SymExpr* lhs  = toSymExpr(call->get(1));
+      SymExpr* step = toSymExpr(call->get(2));
+
+      if (lhs                               != NULL &&
+          step                              != NULL &&
+          (is_int_type(lhs->symbol()->type)  == true ||
+           is_uint_type(lhs->symbol()->type) == true)) {
+        VarSymbol* var = toVarSymbol(step->symbol());
+
+        if (var != NULL && var->immediate != NULL) {
+          if (var->immediate->to_int() != 0)
+            mInductionVars.insert(lhs->symbol());
+
+        } else if (step->symbol()->isRef()        == false &&
+                   mWritten.count(step->symbol()) == 0) {
+          mInductionVars.insert(lhs->symbol());
+        }
+      }
+    }
+  }
+
+  for_vector(CallExpr, call, calls) {
+    if (isMoveOrAssign(call) == true) {
+      SymExpr* lhs = toSymExpr(call->get(1));
+      SymExpr* rhs = toSymExpr(call->get(2));
+
+      if (lhs != NULL && rhs != NULL && mInductionVars.count(rhs->symbol()))
+        mInductionVars.insert(lhs->symbol());
+    }
+  }
+
+  // a variable that the body writes is not an induction variable
+  calls.clear();
+
+  collectCallExprs(mLoop, calls);
+
+  for_vector(CallExpr, call, calls) {
+    if (isMoveOrAssign(call) == true || isOpEqualPrim(call) == true) {
+      if (SymExpr* lhs = toSymExpr(call->get(1))) {
+        if (mLoop->initBlockGet()->contains(call) == false &&
+            mLoop->testBlockGet()->contains(call) == false &&
+            mLoop->incrBlockGet()->contains(call) == false) {
+          bodyWrites.insert(lhs->symbol());
+        }
+      }
+    }
+  }
+
+  for_set(Symbol, sym, bodyWrites) {
+    mInductionVars.erase(sym);
+  }
+}
+
+void LoopDependenceChecker::findWrittenSymbols(BlockStmt* block) {
+  std::vector<CallExpr*> calls;
+
+  collectCallExprs(block, calls);
+
+  for_vector(CallExpr, call, calls) {
+    if (mLoop->initBlockGet()->contains(call) == true)
+      continue;
+
+    if (isMoveOrAssign(call)                    == true ||
+        isOpEqualPrim(call)                     == true ||
+        call->isPrimitive(PRIM_SET_MEMBER)      == true ||
+        call->isPrimitive(PRIM_SET_SVEC_MEMBER) == true ||
+        call->isPrimitive(PRIM_ADDR_OF)         == true ||
+        call->isPrimitive(PRIM_SET_REFERENCE)   == true) {
+      if (SymExpr* se = toSymExpr(call->get(1))) {
+        mWritten.insert(se->symbol());
+      }
+    }
+  }
+}
+
+/************************************* | **************************************
+*                                                                             *
+* Walk the body in order, recording the value of each integer temp and the    *
+* element each reference temp points to as they are defined.                  *
+*                                                                             *
+************************************** | *************************************/
+
+bool LoopDependenceChecker::checkStmts(BlockStmt* block, bool conditional) {
+  for_alist(stmt, block->body) {
+    // the statements after a forward goto may be skipped
+    if (checkStmt(stmt, conditional || mAfterGoto) == false)
+      return false;
+  }
+
+  return true;
+}
+
+bool LoopDependenceChecker::checkStmt(Expr* stmt, bool conditional) {
+  if (DefExpr* def = toDefExpr(stmt)) {
+    if (LabelSymbol* label = toLabelSymbol(def->sym))
+      mSeenLabels.insert(label);
+
+    return true;
+
+  } else if (CallExpr* call = toCallExpr(stmt)) {
+    return checkCall(call, conditional);
+
+  } else if (CondStmt* cond = toCondStmt(stmt)) {
+    return checkExpr(cond->condExpr)                   &&
+           checkStmts(cond->thenStmt, true)            &&
+           (cond->elseStmt == NULL ||
+            checkStmts(cond->elseStmt, true));
+
+  } else if (GotoStmt* gotoStmt = toGotoStmt(stmt)) {
+    LabelSymbol* label = gotoStmt->gotoTarget();
+
+    // a forward jump within the body, e.g. from an inlined return
+    if (mSeenLabels.count(label) != 0)
+      return fail("it jumps backward");
+
+    if (label == NULL || mLoop->contains(label->defPoint) == false)
+      return fail("it exits the loop early");
+
+    mAfterGoto = true;
+
+    return true;
+
+  } else if (BlockStmt* block = toBlockStmt(stmt)) {
+    if (block->isLoopStmt() == true)
+      return fail("it contains a nested loop");
+
+    if (block->blockInfoGet() != NULL)
+      return fail("it contains a block that is not analyzed");
+
+    return checkStmts(block, conditional);
+  }
+
+  return fail("it contains a statement that is not analyzed");
+}
+
+bool LoopDependenceChecker::checkCall(CallExpr* call, bool conditional) {
+  if (isMoveOrAssign(call) == true || isOpEqualPrim(call) == true) {
+    SymExpr* lhs = toSymExpr(call->get(1));
+    Expr*    rhs = call->get(2);
+    Symbol*  sym = (lhs != NULL) ? lhs->symbol() : NULL;
+
+    if (sym == NULL)
+      return fail("it contains a store that is not analyzed");
+
+    if (checkExpr(rhs) == false)
+      return false;
+
+    if (sym->isRef() == true) {
+      // moving a reference defines it; anything else stores through it
+      if (call->isPrimitive(PRIM_MOVE) == true &&
+          rhs->isRef()                 == true) {
+        if (conditional == true)
+          mRefs.erase(sym);
+        else
+          defineRef(sym, rhs);
+
+      } else {
+        write(sym);
+      }
+
+      return reason.empty();
+    }
+
+    if (checkScalarWrite(sym) == false)
+      return false;
+
+    if (isOpEqualPrim(call) == true)
+      mValues.erase(sym);
+    else
+      defineValue(sym, rhs, conditional);
+
+    return true;
+
+  } else if (call->isPrimitive(PRIM_SET_MEMBER)      == true ||
+             call->isPrimitive(PRIM_SET_SVEC_MEMBER) == true) {
+    SymExpr* obj = toSymExpr(call->get(1));
+
+    if (checkExpr(call->get(3)) == false)
+      return false;
+
+    if (call->get(3)->isRef() == true)
+      return fail("it stores a reference");
+
+    // a field of an element, or of a record local to the body
+    if (obj != NULL && mRefs.count(obj->symbol()) != 0) {
+      write(obj->symbol());
+      return reason.empty();
+
+    } else if (obj                                   != NULL  &&
+               obj->symbol()->isRef()                == false &&
+               isRecord(obj->symbol()->type)         == true  &&
+               mLoop->contains(obj->symbol()->defPoint)) {
+      return true;
+    }
+
+    return fail("it writes a field of %s",
+                obj != NULL ? obj->symbol()->name : "an object");
+  }
+
+  return checkExpr(call);
+}
+
+//
+// A scalar that is written by the loop must not be memory that the
+// element accesses could alias
+//
+bool LoopDependenceChecker::checkScalarWrite(Symbol* sym) {
+  if (isModuleSymbol(sym->defPoint->parentSymbol) == true)
+    return fail("it writes the global %s", sym->name);
+
+  for_SymbolSymExprs(se, sym) {
+    if (CallExpr* parent = toCallExpr(se->parentExpr)) {
+      if (parent->isPrimitive(PRIM_ADDR_OF)       == true ||
+          parent->isPrimitive(PRIM_SET_REFERENCE) == true) {
+        return fail("it writes %s, whose address is taken", sym->name);
+
+      } else if (parent->isPrimitive() == false) {
+        ArgSymbol* formal = actual_to_formal(se);
+
+        if (formal != NULL && formal->isRef() == true)
+          return fail("it writes %s, whose address is taken", sym->name);
+      }
+    }
+  }
+
+  return true;
+}
+
+// Check the primitives in an expression and record the elements it reads
+bool LoopDependenceChecker::checkExpr(Expr* expr) {
+  if (SymExpr* se = toSymExpr(expr)) {
+    Symbol* sym = se->symbol();
+
+    if (sym->isWideRef() == true ||
+        sym->type->symbol->hasFlag(FLAG_WIDE_CLASS) == true)
+      return fail("it accesses remote data");
+
+    if (sym->isRef() == true)
+      read(sym);
+
+    return reason.empty();
+
+  } else if (CallExpr* call = toCallExpr(expr)) {
+    if (call->isPrimitive() == false) {
+      FnSymbol* fn = call->resolvedFunction();
+
+      return fail("it calls %s", fn != NULL ? fn->name : "a function");
+    }
+
+    switch (call->primitive->tag) {
+    case PRIM_UNARY_MINUS:
+    case PRIM_UNARY_PLUS:
+    case PRIM_UNARY_NOT:
+    case PRIM_UNARY_LNOT:
+    case PRIM_ADD:
+    case PRIM_SUBTRACT:
+    case PRIM_MULT:
+    case PRIM_DIV:
+    case PRIM_MOD:
+    case PRIM_LSH:
+    case PRIM_RSH:
+    case PRIM_EQUAL:
+    case PRIM_NOTEQUAL:
+    case PRIM_LESSOREQUAL:
+    case PRIM_GREATEROREQUAL:
+    case PRIM_LESS:
+    case PRIM_GREATER:
+    case PRIM_AND:
+    case PRIM_OR:
+    case PRIM_XOR:
+    case PRIM_POW:
+    case PRIM_MIN:
+    case PRIM_MAX:
+    case PRIM_GET_REAL:
+    case PRIM_GET_IMAG:
+    case PRIM_PTR_EQUAL:
+    case PRIM_PTR_NOTEQUAL:
+    case PRIM_CAST:
+    case PRIM_DEREF:
+    case PRIM_GET_MEMBER_VALUE:
+    case PRIM_GET_SVEC_MEMBER_VALUE:
+      break;
+
+    // these compute an address without reading it
+    case PRIM_ARRAY_GET:
+    case PRIM_GET_MEMBER:
+    case PRIM_GET_SVEC_MEMBER:
+    case PRIM_ADDR_OF:
+    case PRIM_SET_REFERENCE:
+      for_actuals(actual, call) {
+        if (SymExpr* se = toSymExpr(actual)) {
+          if (se->symbol()->isWideRef() == true)
+            return fail("it accesses remote data");
+
+        } else if (checkExpr(actual) == false) {
+          return false;
+        }
+      }
+
+      return true;
+
+    case PRIM_ARRAY_GET_VALUE: {
+      MemoryAccess access;
+      SymExpr*     base = toSymExpr(call->get(1));
+
+      if (base != NULL && mWritten.count(base->symbol()) == 0)
+        access.base  = baseOf(base->symbol());
+
+      access.index   = evaluate(call->get(2));
+      access.isWrite = false;
+
+      mAccesses.push_back(access);
+
+      return checkExpr(call->get(2));
+    }
+
+    default:
+      return fail("it uses the primitive '%s'", call->primitive->name);
+    }
+
+    for_actuals(actual, call) {
+      if (checkExpr(actual) == false)
+        return false;
+    }
+
+    return true;
+  }
+
+  return fail("it contains an expression that is not analyzed");
+}
+
+// 'ref' is moved the address 'rhs' computes
+void LoopDependenceChecker::defineRef(Symbol* ref, Expr* rhs) {
+  MemoryAccess access;
+  CallExpr*    call = toCallExpr(rhs);
+  SymExpr*     se   = toSymExpr(rhs);
+
+  access.isWrite = false;
+
+  if (call != NULL && call->isPrimitive(PRIM_ARRAY_GET) == true) {
+    SymExpr* base = toSymExpr(call->get(1));
+
+    if (base != NULL && mWritten.count(base->symbol()) == 0)
+      access.base = baseOf(base->symbol());
+
+    access.index = evaluate(call->get(2));
+
+  } else if (call != NULL && (call->isPrimitive(PRIM_GET_MEMBER)      ||
+                              call->isPrimitive(PRIM_GET_SVEC_MEMBER) ||
+                              call->isPrimitive(PRIM_ADDR_OF)         ||
+                              call->isPrimitive(PRIM_SET_REFERENCE))) {
+    se = toSymExpr(call->get(1));
+  }
+
+  if (se != NULL) {
+    std::map<Symbol*, MemoryAccess>::iterator it = mRefs.find(se->symbol());
+
+    if (it != mRefs.end()) {
+      // a field of an element, or a copy of an element reference
+      access = it->second;
+
+    } else if (se->symbol()->isRef()              == false &&
+               mWritten.count(se->symbol())       == 0) {
+      // the address of a loop invariant value is the same every iteration
+      access.base        = baseOf(se->symbol());
+      access.index.known = true;
+    }
+  }
+
+  mRefs[ref] = access;
+}
+
+void LoopDependenceChecker::defineValue(Symbol*   sym,
+                                        Expr*     rhs,
+                                        bool      conditional) {
+  if (conditional                == false &&
+      (is_int_type(sym->type)    == true  ||
+       is_uint_type(sym->type)   == true))
+    mValues[sym] = evaluate(rhs);
+  else
+    mValues.erase(sym);
+}
+
+void LoopDependenceChecker::read(Symbol* ref) {
+  std::map<Symbol*, MemoryAccess>::iterator it = mRefs.find(ref);
+  MemoryAccess                              access;
+
+  if (it != mRefs.end()) {
+    access = it->second;
+
+  } else if (mWritten.count(ref) == 0) {
+    // a loop invariant reference, e.g. a 'const ref' formal
+    access.base = baseOf(ref);
+  }
+
+  access.isWrite = false;
+
+  mAccesses.push_back(access);
+}
+
+void LoopDependenceChecker::write(Symbol* ref) {
+  std::map<Symbol*, MemoryAccess>::iterator it = mRefs.find(ref);
+
+  if (it == mRefs.end() || it->second.base.size() == 0) {
+    fail("it writes through %s, which is not analyzed", ref->name);
+
+  } else {
+    MemoryAccess access = it->second;
+
+    access.isWrite = true;
+
+    mAccesses.push_back(access);
+  }
+}
+
+/************************************* | **************************************
+*                                                                             *
+* Compare each write with every access to the same array                      *
+*                                                                             *
+************************************** | *************************************/
+
+static int numInductionTerms(const AffineIndex&       index,
+                             const std::set<Symbol*>& inductionVars);
+
+bool LoopDependenceChecker::checkAccesses() {
+  for (size_t i = 0; i < mAccesses.size(); i++) {
+    const MemoryAccess& w = mAccesses[i];
+
+    if (w.isWrite == false)
+      continue;
+
+    if (w.index.known == true &&
+        numInductionTerms(w.index, mInductionVars) == 0)
+      return fail("it writes the same element of %s in every iteration",
+                  baseName(w.base));
+
+    if (w.index.known == false ||
+        numInductionTerms(w.index, mInductionVars) != 1)
+      return fail("it writes %s at an index that is not analyzed",
+                  baseName(w.base));
+
+    for (size_t j = 0; j < mAccesses.size(); j++) {
+      const MemoryAccess& a = mAccesses[j];
+
+      if (a.base.size() == 0)
+        return fail("it reads memory that %s may alias", baseName(w.base));
+
+      if (i == j || a.base != w.base)
+        continue;
+
+      if (a.index.known == false || a.index.terms != w.index.terms)
+        return fail("it may access %s at an index written by another "
+                    "iteration",
+                    baseName(w.base));
+
+      if (a.index.constant != w.index.constant)
+        return fail("it accesses %s at an index written by another iteration",
+                    baseName(w.base));
+    }
+  }
+
+  return true;
+}
+
+static int numInductionTerms(const AffineIndex&       index,
+                             const std::set<Symbol*>& inductionVars) {
+  int retval = 0;
+
+  for (std::map<Symbol*, int64_t>::const_iterator it = index.terms.begin();
+       it != index.terms.end();
+       ++it) {
+    if (inductionVars.count(it->first) != 0 && it->second != 0)
+      retval = retval + 1;
+  }
+
+  return retval;
+}
+
+/************************************* | **************************************
+*                                                                             *
+* Helpers                                                                     *
+*                                                                             *
+************************************** | *************************************/
+
+AffineIndex LoopDependenceChecker::evaluate(Expr* expr) {
+  AffineIndex retval;
+
+  if (SymExpr* se = toSymExpr(expr)) {
+    Symbol*    sym = se->symbol();
+    VarSymbol* var = toVarSymbol(sym);
+
+    if (var != NULL && var->immediate != NULL) {
+      if (var->immediate->const_kind == NUM_KIND_INT ||
+          var->immediate->const_kind == NUM_KIND_UINT) {
+        retval.known    = true;
+        retval.constant = var->immediate->to_int();
+      }
+
+    } else if (mValues.count(sym) != 0) {
+      retval = mValues[sym];
+
+    } else if (sym->isRef() == false &&
+               (mInductionVars.count(sym) != 0 || mWritten.count(sym) == 0)) {
+      retval.known      = true;
+      retval.terms[sym] = 1;
+    }
+
+  } else if (CallExpr* call = toCallExpr(expr)) {
+    if (call->isPrimitive(PRIM_ADD)      == true ||
+        call->isPrimitive(PRIM_SUBTRACT) == true) {
+      AffineIndex lhs  = evaluate(call->get(1));
+      AffineIndex rhs  = evaluate(call->get(2));
+      int64_t     sign = call->isPrimitive(PRIM_ADD) ? 1 : -1;
+
+      if (lhs.known == true && rhs.known == true) {
+        retval          = lhs;
+        retval.constant = lhs.constant + sign * rhs.constant;
+
+        for (std::map<Symbol*, int64_t>::iterator it = rhs.terms.begin();
+             it != rhs.terms.end();
+             ++it) {
+          retval.terms[it->first] += sign * it->second;
+
+          if (retval.terms[it->first] == 0)
+            retval.terms.erase(it->first);
+        }
+      }
+
+    } else if (call->isPrimitive(PRIM_MULT) == true) {
+      AffineIndex lhs = evaluate(call->get(1));
+      AffineIndex rhs = evaluate(call->get(2));
+
+      if (rhs.known == true && rhs.terms.size() == 0)
+        std::swap(lhs, rhs);
+
+      // a constant times an affine index
+      if (lhs.known == true && lhs.terms.size() == 0 && rhs.known == true) {
+        retval          = rhs;
+        retval.constant = rhs.constant * lhs.constant;
+
+        for (std::map<Symbol*, int64_t>::iterator it = retval.terms.begin();
+             it != retval.terms.end();
+             ++it) {
+          it->second = it->second * lhs.constant;
+        }
+      }
+
+    } else if (call->isPrimitive(PRIM_CAST) == true) {
+      if (is_int_type(call->get(1)->typeInfo()) == true ||
+          is_uint_type(call->get(1)->typeInfo()) == true)
+        retval = evaluate(call->get(2));
+    }
+  }
+
+  return retval;
+}
+
+//
+// The array a data pointer was loaded from: the symbol it is copied or
+// loaded from, then the fields it was loaded through
+//
+std::vector<Symbol*> LoopDependenceChecker::baseOf(Symbol* sym) {
+  std::vector<Symbol*> fields;
+  std::vector<Symbol*> retval;
+
+  for (int i = 0; i < 16; i++) {
+    SymExpr*  def  = sym->getSingleDef();
+    CallExpr* move = def ? toCallExpr(def->parentExpr) : NULL;
+    Expr*     rhs  = NULL;
+
+    if (isArgSymbol(sym)                          == true ||
+        isModuleSymbol(sym->defPoint->parentSymbol) == true ||
+        move == NULL || move->isPrimitive(PRIM_MOVE) == false)
+      break;
+
+    rhs = move->get(2);
+
+    if (SymExpr* se = toSymExpr(rhs)) {
+      sym = se->symbol();
+
+    } else if (CallExpr* call = toCallExpr(rhs)) {
+      SymExpr* obj = toSymExpr(call->get(1));
+
+      if (call->isPrimitive(PRIM_CAST) == true)
+        obj = toSymExpr(call->get(2));
+
+      if (obj == NULL)
+        break;
+
+      if (call->isPrimitive(PRIM_GET_MEMBER_VALUE)      == true ||
+          call->isPrimitive(PRIM_GET_MEMBER)            == true ||
+          call->isPrimitive(PRIM_GET_SVEC_MEMBER_VALUE) == true ||
+          call->isPrimitive(PRIM_GET_SVEC_MEMBER)       == true) {
+        SymExpr* field = toSymExpr(call->get(2));
+
+        if (field == NULL)
+          break;
+
+        fields.push_back(field->symbol());
+
+      } else if (call->isPrimitive(PRIM_CAST)          == false &&
+                 call->isPrimitive(PRIM_DEREF)         == false &&
+                 call->isPrimitive(PRIM_ADDR_OF)       == false &&
+                 call->isPrimitive(PRIM_SET_REFERENCE) == false) {
+        break;
+      }
+
+      sym = obj->symbol();
+
+    } else {
+      break;
+    }
+  }
+
+  retval.push_back(sym);
+
+  for (size_t i = fields.size(); i > 0; i--) {
+    retval.push_back(fields[i - 1]);
+  }
+
+  return retval;
+}
+
+const char* LoopDependenceChecker::baseName(const std::vector<Symbol*>& base) {
+  const char* retval = "an array";
+
+  if (base.size() > 0 && base[0]->hasFlag(FLAG_TEMP) == false)
+    retval = base[0]->name;
+
+  return retval;
+}
+
+bool LoopDependenceChecker::fail(const char* format, const char* name) {
+  if (reason.empty() == true) {
+    char buffer[256];
+
+    snprintf(buffer, sizeof(buffer), format, name);
+
+    reason = buffer;
+  }
+
+  return false;
+}
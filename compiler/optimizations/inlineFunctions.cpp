@@ -20,26 +20,35 @@
 #include "passes.h"
 
 #include "astutil.h"
+#include "CForLoop.h"
 #include "driver.h"
 #include "expr.h"
+#include "fnNodeIndex.h"
+#include "ModuleSymbol.h"
 #include "optimizations.h"
 #include "stlUtil.h"
 #include "stmt.h"
 #include "stringutil.h"
+#include "wellknown.h"
 
+#include <algorithm>
 #include <set>
 #include <vector>
 
 static void updateRefCalls();
 static void inlineFunctionsImpl();
+static void autoInlineFunctions();
 static void inlineFunction(FnSymbol* fn, std::set<FnSymbol*>& inlinedSet);
 static void inlineCall(CallExpr* call);
+static void inlineCall(CallExpr* call, BlockStmt* block);
+static BlockStmt* copyBody(CallExpr* call, bool preserveLineNumbers);
 static void updateDerefCalls();
 static void inlineCleanup();
 
 /************************************* | **************************************
 *                                                                             *
 * inline all functions with the inline flag                                   *
+* inline small functions that are not marked inline                           *
 * remove unnecessary block statements and gotos                               *
 *                                                                             *
 ************************************** | *************************************/
@@ -51,6 +60,8 @@ void inlineFunctions() {
 
   inlineFunctionsImpl();
 
+  autoInlineFunctions();
+
   updateDerefCalls();
 
   inlineCleanup();
@@ -75,6 +86,338 @@ static void inlineFunctionsImpl() {
   }
 }
 
+/************************************* | **************************************
+*                                                                             *
+* Inline small functions that are not marked inline.                          *
+*                                                                             *
+* The size of a function is the number of calls in its body.  A function is   *
+* inlined at a call site if it is no bigger than a limit that grows with the  *
+* loop depth of the call, as long as the total growth of the program stays    *
+* within a budget.  A function with a single call site is inlined if it is    *
+* not too big; prune2() then removes it, so it does not count against the     *
+* budget.                                                                     *
+*                                                                             *
+* Functions are visited from smallest to largest so that small helpers are    *
+* folded into their callers before the callers themselves are considered.     *
+*                                                                             *
+* Only functions in user modules are considered.  The internal and standard   *
+* modules mark their hot paths inline, and inlining the rest exposes code     *
+* that the C compiler warns about once the actuals are constants.             *
+*                                                                             *
+************************************** | *************************************/
+
+// the limit for a call outside of any loop; doubles with each loop level
+static const int kAutoInlineSize        =    8;
+static const int kAutoInlineMaxDepth    =    3;
+
+static const int kAutoInlineSingleSize  =  100;
+static const int kAutoInlineCallerSize  = 2000;
+
+// percentage of the program's calls that inlining may add
+static const int kAutoInlineGrowth      =   10;
+
+struct AutoInlineState {
+  int budget;
+  int growth;
+  int numInlined;
+  int numUnused;
+};
+
+static bool isAutoInlineCandidate(FnSymbol*            fn,
+                                  std::set<FnSymbol*>& wellKnown);
+static bool canAutoInlineAt(FnSymbol* fn, CallExpr* call);
+static int  fnSize(FnSymbol* fn);
+static int  loopDepth(Expr* expr);
+static bool isAutoInlineSmaller(FnSymbol* a, FnSymbol* b);
+static void autoInlineFunction(FnSymbol* fn, AutoInlineState& state);
+static void autoInlineCall(FnSymbol* fn, CallExpr* call);
+
+static void autoInlineFunctions() {
+  if (fNoInline == false && fNoAutoInline == false) {
+    std::vector<FnSymbol*> wellKnownFns = getWellKnownFunctions();
+    std::set<FnSymbol*>    wellKnown(wellKnownFns.begin(), wellKnownFns.end());
+    std::vector<FnSymbol*> candidates;
+    AutoInlineState        state;
+
+    // inlining marked functions copied calls without recording them
+    compute_call_sites();
+
+    forv_Vec(FnSymbol, fn, gFnSymbols) {
+      if (isAutoInlineCandidate(fn, wellKnown) == true) {
+        candidates.push_back(fn);
+      }
+    }
+
+    std::stable_sort(candidates.begin(),
+                     candidates.end(),
+                     isAutoInlineSmaller);
+
+    state.budget     = gCallExprs.n / 100 * kAutoInlineGrowth;
+    state.growth     = 0;
+    state.numInlined = 0;
+    state.numUnused  = 0;
+
+    for_vector(FnSymbol, fn, candidates) {
+      if (isAlive(fn) == true) {
+        autoInlineFunction(fn, state);
+      }
+    }
+
+    if (report_inlining) {
+      printf("chapel compiler: reporting inlining, "
+             "auto-inlined %d calls, %d functions are no longer called, "
+             "growth %d of %d calls\n",
+             state.numInlined,
+             state.numUnused,
+             state.growth,
+             state.budget);
+    }
+  }
+}
+
+//
+// Later passes look for calls to functions with these flags, so the
+// calls must stay calls
+//
+static const Flag sKeepCallsFlags[] = {
+  FLAG_ALLOCATOR,
+  FLAG_LOCALE_MODEL_ALLOC,
+  FLAG_LOCALE_MODEL_FREE,
+  FLAG_AUTO_COPY_FN,
+  FLAG_AUTO_DESTROY_FN,
+  FLAG_INIT_COPY_FN,
+  FLAG_DONOR_FN,
+  FLAG_DESTRUCTOR,
+  FLAG_COMMAND_LINE_SETTING,
+  FLAG_FN_RETARG,
+  FLAG_LOCAL_ARGS,
+  FLAG_LOCAL_FN,
+
+  FLAG_ON_BLOCK,
+  FLAG_BEGIN_BLOCK,
+  FLAG_COBEGIN_OR_COFORALL_BLOCK,
+  FLAG_LOCAL_ON,
+  FLAG_FAST_ON,
+  FLAG_FAST_ON_NB,
+  FLAG_NON_BLOCKING
+};
+
+static bool isAutoInlineCandidate(FnSymbol*            fn,
+                                  std::set<FnSymbol*>& wellKnown) {
+  int numFlags = sizeof(sKeepCallsFlags) / sizeof(sKeepCallsFlags[0]);
+
+  for (int i = 0; i < numFlags; i++) {
+    if (fn->hasFlag(sKeepCallsFlags[i]) == true) {
+      return false;
+    }
+  }
+
+  return fn->getModule()->modTag           == MOD_USER &&
+         fn->hasFlag(FLAG_INLINE)             == false &&
+         fn->hasFlag(FLAG_EXTERN)             == false &&
+         fn->hasFlag(FLAG_EXPORT)             == false &&
+         fn->hasFlag(FLAG_VIRTUAL)            == false &&
+         fn->hasFlag(FLAG_ITERATOR_FN)        == false &&
+         fn->hasFlag(FLAG_MODULE_INIT)        == false &&
+         fn->hasFlag(FLAG_NO_CODEGEN)         == false &&
+         isTaskFun(fn)                        == false &&
+         wellKnown.count(fn)                  == 0     &&
+         fn                                   != chpl_gen_main &&
+         fn->calledBy                         != NULL  &&
+         fn->calledBy->n                      >  0;
+}
+
+//
+// insertLineNumbers() gives the calls in user code their own line
+// numbers, and passes the caller's line number to other functions
+//
+static bool usesOwnLineNumbers(FnSymbol* fn) {
+  return fn->getModule()->modTag           == MOD_USER &&
+         fn->hasFlag(FLAG_COMPILER_GENERATED) == false;
+}
+
+static bool isInLocalBlock(Expr* expr) {
+  for (Expr* parent = expr->parentExpr; parent; parent = parent->parentExpr) {
+    if (BlockStmt* block = toBlockStmt(parent)) {
+      if (block->isLoopStmt() == false &&
+          block->blockInfoGet()       != NULL &&
+          block->blockInfoGet()->isPrimitive(PRIM_BLOCK_LOCAL) == true) {
+        return true;
+      }
+    }
+  }
+
+  return false;
+}
+
+// Is 'stmt' one of the clauses in the header of a C for loop?
+static bool isInCForLoopHeader(Expr* stmt) {
+  bool retval = false;
+
+  if (CForLoop* loop = toCForLoop(stmt->parentExpr->parentExpr)) {
+    retval = stmt->parentExpr == loop->initBlockGet() ||
+             stmt->parentExpr == loop->testBlockGet() ||
+             stmt->parentExpr == loop->incrBlockGet();
+  }
+
+  return retval;
+}
+
+static bool canAutoInlineAt(FnSymbol* fn, CallExpr* call) {
+  FnSymbol* caller = toFnSymbol(call->parentSymbol);
+  Expr*     stmt   = NULL;
+
+  if (caller == NULL || caller == fn || call->resolvedFunction() != fn)
+    return false;
+
+  // The statements of the body are inserted before the call's statement
+  stmt = call->getStmtExpr();
+
+  if (stmt                          == NULL ||
+      stmt->list                    == NULL ||
+      isBlockStmt(stmt->parentExpr) == false)
+    return false;
+
+  if (isInCForLoopHeader(stmt) == true || isInLocalBlock(stmt) == true)
+    return false;
+
+  for_actuals(actual, call) {
+    if (isSymExpr(actual) == false)
+      return false;
+  }
+
+  // the calls in 'fn' would start reporting the line of the call to 'caller'
+  if (usesOwnLineNumbers(fn) == true && usesOwnLineNumbers(caller) == false)
+    return false;
+
+  return true;
+}
+
+static int fnSize(FnSymbol* fn) {
+  return (int) FnNodeIndex::get(fn)->calls.size();
+}
+
+static int loopDepth(Expr* expr) {
+  int retval = 0;
+
+  for (Expr* parent = expr->parentExpr; parent; parent = parent->parentExpr) {
+    if (isLoopStmt(parent) == true) {
+      retval = retval + 1;
+    }
+  }
+
+  return retval;
+}
+
+static bool isAutoInlineSmaller(FnSymbol* a, FnSymbol* b) {
+  return fnSize(a) < fnSize(b);
+}
+
+static void autoInlineFunction(FnSymbol* fn, AutoInlineState& state) {
+  std::vector<CallExpr*> sites;
+  int                    size       = fnSize(fn);
+  int                    numInlined = 0;
+  bool                   singleSite = false;
+
+  forv_Vec(CallExpr, call, *fn->calledBy) {
+    if (call->parentSymbol != NULL && call->resolvedFunction() == fn) {
+      sites.push_back(call);
+    }
+  }
+
+  // inlining the only reference to a function lets prune2() remove it
+  singleSite = sites.size() == 1 && fn->firstSymExpr() == fn->lastSymExpr();
+
+  for_vector(CallExpr, call, sites) {
+    if (canAutoInlineAt(fn, call) == true) {
+      FnSymbol* caller = toFnSymbol(call->parentSymbol);
+      int       depth  = std::min(loopDepth(call), kAutoInlineMaxDepth);
+      bool      small  = size <= (kAutoInlineSize << depth) &&
+                         state.growth + size <= state.budget;
+
+      if (fnSize(caller) + size > kAutoInlineCallerSize) {
+
+      } else if (singleSite == true && size <= kAutoInlineSingleSize) {
+        autoInlineCall(fn, call);
+        numInlined = numInlined + 1;
+
+      } else if (small == true) {
+        autoInlineCall(fn, call);
+        numInlined   = numInlined   + 1;
+        state.growth = state.growth + size;
+      }
+    }
+  }
+
+  state.numInlined = state.numInlined + numInlined;
+
+  if (numInlined > 0 && fn->firstSymExpr() == NULL) {
+    state.numUnused = state.numUnused + 1;
+  }
+
+  if (report_inlining && numInlined > 0) {
+    printf("chapel compiler: reporting inlining, "
+           "%s function was auto-inlined at %d of %d call sites\n",
+           fn->cname,
+           numInlined,
+           (int) sites.size());
+  }
+}
+
+//
+// A function may modify its value formals, which the inlined body
+// would do to the actuals.  Pass copies, as the C call would; copy
+// propagation removes the ones that are not needed.
+//
+static void copyValueActuals(CallExpr* call) {
+  Expr*                   stmt = call->getStmtExpr();
+  std::vector<ArgSymbol*> formals;
+  std::vector<Expr*>      actuals;
+
+  SET_LINENO(call);
+
+  for_formals_actuals(formal, actual, call) {
+    if (formal->isRef() == false && formal->isWideRef() == false) {
+      formals.push_back(formal);
+      actuals.push_back(actual);
+    }
+  }
+
+  for (size_t i = 0; i < actuals.size(); i++) {
+    Expr*      actual = actuals[i];
+    VarSymbol* tmp    = newTemp("inlineArg", formals[i]->type);
+
+    actual->replace(new SymExpr(tmp));
+
+    stmt->insertBefore(new DefExpr(tmp));
+    stmt->insertBefore(new CallExpr(PRIM_MOVE, tmp, actual));
+  }
+}
+
+static void autoInlineCall(FnSymbol* fn, CallExpr* call) {
+  bool                   preserve = preserveInlinedLineNumbers == true ||
+                                    usesOwnLineNumbers(fn)     == true;
+  BlockStmt*             block    = NULL;
+  std::vector<CallExpr*> calls;
+
+  copyValueActuals(call);
+
+  block = copyBody(call, preserve);
+
+  // keep calledBy current for the functions that are visited later
+  collectFnCalls(block, calls);
+
+  for_vector(CallExpr, copy, calls) {
+    FnSymbol* calledFn = copy->resolvedFunction();
+
+    if (calledFn->calledBy != NULL) {
+      calledFn->calledBy->add(copy);
+    }
+  }
+
+  inlineCall(call, block);
+}
+
 /************************************* | **************************************
 *                                                                             *
 * Inline a function at every call site                                        *
@@ -173,9 +516,11 @@ static void inlineAtCallSites(FnSymbol* fn) {
 *                                                                             *
 ************************************** | *************************************/
 
-static BlockStmt* copyBody(CallExpr* call);
-
 static void inlineCall(CallExpr* call) {
+  inlineCall(call, copyBody(call, preserveInlinedLineNumbers));
+}
+
+static void inlineCall(CallExpr* call, BlockStmt* block) {
   SET_LINENO(call);
 
   //
@@ -192,7 +537,6 @@ static void inlineCall(CallExpr* call) {
   Expr*      stmt  = call->getStmtExpr();
 
   FnSymbol*  fn    = call->resolvedFunction();
-  BlockStmt* block = copyBody(call);
 
   // Transfer most of the statements from the body to immediately before
   // the statement that that contains the call.
@@ -235,7 +579,7 @@ static void inlineCall(CallExpr* call) {
 // choose to always replace an actual immediate with a temp.
 //
 
-static BlockStmt* copyBody(CallExpr* call) {
+static BlockStmt* copyBody(CallExpr* call, bool preserveLineNumbers) {
   SET_LINENO(call);
 
   SymbolMap  map;
@@ -264,7 +608,7 @@ static BlockStmt* copyBody(CallExpr* call) {
 
   retval = fn->body->copy(&map);
 
-  if (preserveInlinedLineNumbers == false) {
+  if (preserveLineNumbers == false) {
     reset_ast_loc(retval, call);
   }
 
@@ -22,6 +22,7 @@
 #include "astutil.h"
 #include "bb.h"
 #include "bitVec.h"
+#include "compilerThreads.h"
 #include "CForLoop.h"
 #include "dominator.h"
 #include "driver.h"
@@ -72,6 +73,10 @@ Timer buildLocalDefMapsTimer;
 Timer computeLoopInvariantsTimer;
 Timer overallTimer;
 
+#ifdef detailedTiming
+static long numLoops = 0;
+#endif
+
 #define MAX_NUM_ALIASES 200000
 
 //TODO The alias analysis is extremely conservative. Beyond possibly not hoisting
@@ -110,23 +115,29 @@ public:
       delete bitExits;
     }
 
-    // This function exists to place an expr in the
-    // "preheader" of the loop,
-    void insertBefore(Expr* expr) {
+    // Returns the loop statement this loop was built from, or NULL
+    Expr* getLoopStmt() {
       if (header->exprs.size() != 0) {
         // find the first expr in the header, and get it's parent expr (for
         // most cases it will be the surrounding block statement of the loop)
         if (BlockStmt* blockStmt = toBlockStmt(header->exprs.at(0)->parentExpr)) {
           if (blockStmt->isLoopStmt()) {
-            blockStmt->insertBefore(expr->remove());
+            return blockStmt;
 
           } else if (blockStmt->blockTag == BLOCK_C_FOR_LOOP) {
-            CForLoop* cforLoop = CForLoop::loopForClause(blockStmt);
-
-            cforLoop->insertBefore(expr->remove());
+            return CForLoop::loopForClause(blockStmt);
           }
         }
       }
+      return NULL;
+    }
+
+    // This function exists to place an expr in the
+    // "preheader" of the loop,
+    void insertBefore(Expr* expr) {
+      if (Expr* loopStmt = getLoopStmt()) {
+        loopStmt->insertBefore(expr->remove());
+      }
     }
 
     //Set the header, and insert the header into the loop blocks
@@ -469,6 +480,209 @@ static bool isConst(SymExpr* symExpr) {
 }
 
 
+/*
+ * Array metadata
+ *
+ * Every access A[i,j] loads _instance from the array record, and then
+ * shiftedData and blk (and off, str, ... for strided arrays) from the
+ * array class.  _instance never changes once the array record has been
+ * initialized, and the array class fields are only changed by methods
+ * that resize or reallocate the array.  So in a loop that calls no
+ * functions and stores through no reference that might point into an
+ * array record or class, these loads are invariant -- even when A is a
+ * ref formal, which otherwise keeps anything derived from it in the loop.
+ */
+enum RefTarget {
+  REF_TARGET_UNKNOWN,
+  REF_TARGET_ARRAY,     // into an array record or array class
+  REF_TARGET_OTHER      // somewhere that is not array metadata
+};
+
+// the move that binds each ref in a function, or NULL if there are several
+typedef std::map<Symbol*, CallExpr*> RefBindingMap;
+
+static bool isArrayMetadataType(Type* type) {
+  Type* valType = type->getValType();
+
+  return valType->symbol->hasFlag(FLAG_ARRAY) || isArrayClass(valType);
+}
+
+static void collectRefBindings(FnSymbol* fn, RefBindingMap& refBindings) {
+  std::vector<CallExpr*> calls;
+
+  collectCallExprs(fn, calls);
+
+  for_vector(CallExpr, call, calls) {
+    if (call->isPrimitive(PRIM_MOVE) && call->get(2)->isRef()) {
+      if (SymExpr* lhs = toSymExpr(call->get(1))) {
+        if (lhs->symbol()->isRef()) {
+          if (refBindings.count(lhs->symbol()) == 0) {
+            refBindings[lhs->symbol()] = call;
+          } else {
+            refBindings[lhs->symbol()] = NULL;
+          }
+        }
+      }
+    }
+  }
+}
+
+static RefTarget fieldTarget(Expr* base, RefBindingMap& refBindings, int depth);
+
+// What the reference 'expr' evaluates to may point into
+static RefTarget refTarget(Expr* expr, RefBindingMap& refBindings, int depth) {
+  if (depth > 16) {
+    return REF_TARGET_UNKNOWN;
+  }
+
+  if (SymExpr* symExpr = toSymExpr(expr)) {
+    Symbol* sym = symExpr->symbol();
+
+    if (sym->isRef()) {
+      RefBindingMap::iterator it = refBindings.find(sym);
+
+      // ref formals and refs bound more than once
+      if (it == refBindings.end() || it->second == NULL) {
+        return REF_TARGET_UNKNOWN;
+      }
+
+      return refTarget(it->second->get(2), refBindings, depth + 1);
+    }
+
+    // the address of a variable
+    return isArrayMetadataType(sym->type) ? REF_TARGET_ARRAY : REF_TARGET_OTHER;
+
+  } else if (CallExpr* call = toCallExpr(expr)) {
+    if (call->isPrimitive(PRIM_ADDR_OF) ||
+        call->isPrimitive(PRIM_SET_REFERENCE)) {
+      return refTarget(call->get(1), refBindings, depth + 1);
+
+    } else if (call->isPrimitive(PRIM_GET_MEMBER) ||
+               call->isPrimitive(PRIM_GET_SVEC_MEMBER)) {
+      return fieldTarget(call->get(1), refBindings, depth + 1);
+
+    } else if (call->isPrimitive(PRIM_ARRAY_GET)) {
+      // an element of a _ddata buffer
+      if (isArrayMetadataType(call->typeInfo())) {
+        return REF_TARGET_ARRAY;
+      }
+
+      return REF_TARGET_OTHER;
+    }
+  }
+
+  return REF_TARGET_UNKNOWN;
+}
+
+// Where a field of 'base' lives
+static RefTarget fieldTarget(Expr* base, RefBindingMap& refBindings, int depth) {
+  Type* valType = base->typeInfo()->getValType();
+
+  if (isArrayMetadataType(valType)) {
+    return REF_TARGET_ARRAY;
+
+  } else if (isClass(valType) || base->isRef() == false) {
+    return REF_TARGET_OTHER;
+
+  } else {
+    // a field of a record that is itself reached through a ref
+    return refTarget(base, refBindings, depth);
+  }
+}
+
+// Is 'call' a load of a field of an array record or class?
+static bool isArrayMetadataLoad(CallExpr* call, RefBindingMap& refBindings) {
+  if (call->isPrimitive(PRIM_GET_MEMBER)            ||
+      call->isPrimitive(PRIM_GET_MEMBER_VALUE)      ||
+      call->isPrimitive(PRIM_GET_SVEC_MEMBER)       ||
+      call->isPrimitive(PRIM_GET_SVEC_MEMBER_VALUE)) {
+    return fieldTarget(call->get(1), refBindings, 0) == REF_TARGET_ARRAY;
+  }
+
+  return false;
+}
+
+static bool isArrayMetadataBase(SymExpr* symExpr, RefBindingMap& refBindings) {
+  if (CallExpr* call = toCallExpr(symExpr->parentExpr)) {
+    return call->get(1) == symExpr && isArrayMetadataLoad(call, refBindings);
+  }
+
+  return false;
+}
+
+// Could 'call' change an array record or class?
+static bool mayStoreArrayMetadata(CallExpr* call, RefBindingMap& refBindings) {
+  // any function, or anything it calls, may resize an array
+  if (call->primitive == NULL) {
+    return true;
+  }
+
+  switch (call->primitive->tag) {
+    case PRIM_SET_MEMBER:
+    case PRIM_SET_SVEC_MEMBER:
+      return fieldTarget(call->get(1), refBindings, 0) != REF_TARGET_OTHER;
+
+    case PRIM_MOVE:
+    case PRIM_ASSIGN:
+    case PRIM_ADD_ASSIGN:
+    case PRIM_SUBTRACT_ASSIGN:
+    case PRIM_MULT_ASSIGN:
+    case PRIM_DIV_ASSIGN:
+    case PRIM_MOD_ASSIGN:
+    case PRIM_LSH_ASSIGN:
+    case PRIM_RSH_ASSIGN:
+    case PRIM_AND_ASSIGN:
+    case PRIM_OR_ASSIGN:
+    case PRIM_XOR_ASSIGN: {
+      SymExpr* lhs = toSymExpr(call->get(1));
+
+      // binding a ref does not store through it
+      if (call->isPrimitive(PRIM_MOVE) && call->get(2)->isRef()) {
+        return false;
+      }
+
+      if (lhs != NULL && lhs->symbol()->isRef()) {
+        return refTarget(lhs, refBindings, 0) != REF_TARGET_OTHER;
+      }
+
+      return false;
+    }
+
+    case PRIM_ARRAY_SET:
+    case PRIM_ARRAY_SET_FIRST:
+      return isArrayMetadataType(call->get(3)->typeInfo());
+
+    case PRIM_NOOP:
+    case PRIM_RETURN:
+    case PRIM_CAST:
+    case PRIM_ARRAY_GET:
+    case PRIM_ARRAY_GET_VALUE:
+      return false;
+
+    default:
+      return isLoopInvariantPrimitive(call->primitive) == false;
+  }
+}
+
+static bool arrayMetadataIsStable(Loop* loop, RefBindingMap& refBindings) {
+  for_vector(BasicBlock, block, *loop->getBlocks()) {
+    for_vector(Expr, expr, block->exprs) {
+      std::vector<CallExpr*> calls;
+
+      collectCallExprs(expr, calls);
+
+      for_vector(CallExpr, call, calls) {
+        if (mayStoreArrayMetadata(call, refBindings)) {
+          return false;
+        }
+      }
+    }
+  }
+
+  return true;
+}
+
+
 /*
  * TODO The following three functions duplicate most of the functionality that is in the 
  * routines found in astUtil. However, these use the STL containers instead of the 
@@ -681,7 +895,8 @@ static bool allOperandsAreLoopInvariant(Expr* expr, std::set<SymExpr*>& loopInva
  * of a variable check if it is composed of loop invariant operands and operations. 
  */
 static void computeLoopInvariants(std::vector<SymExpr*>& loopInvariants, Loop*
-    loop, symToVecSymExprMap& localDefMap, FnSymbol* fn) {
+    loop, symToVecSymExprMap& localDefMap, FnSymbol* fn,
+    RefBindingMap& refBindings, bool metadataIsStable) {
  
   // collect all of the symExprs, defExprs, and callExprs in the loop
   startTimer(collectSymExprAndDefTimer);
@@ -876,6 +1091,11 @@ static void computeLoopInvariants(std::vector<SymExpr*>& loopInvariants, Loop*
         }
       }
     }
+    // ... except for loading the metadata of an array (see "Array metadata")
+    if (mightHaveBeenDeffedElseWhere && metadataIsStable &&
+        isArrayMetadataBase(symExpr, refBindings)) {
+      mightHaveBeenDeffedElseWhere = false;
+    }
     // Find where the variable is defined.
     Symbol* defScope = symExpr->symbol()->defPoint->parentSymbol;
     // if the variable is a module level (global) variable
@@ -1094,6 +1314,63 @@ static bool canPerformCodeMotion(Loop* loop) {
 }
 
 
+/*
+ * --report-array-hoisting
+ *
+ * Functions are hoisted from in parallel, so the loops are collected
+ * here and printed in source order once they have all been visited.
+ */
+struct HoistedArrayMetadata {
+  const char* modName;
+  const char* loopTag;
+  int         lineno;
+  int         numLoads;
+
+  bool operator<(const HoistedArrayMetadata& other) const {
+    int cmp = strcmp(modName, other.modName);
+
+    return (cmp != 0) ? (cmp < 0) : (lineno < other.lineno);
+  }
+};
+
+static std::vector<HoistedArrayMetadata> hoistedArrayMetadata;
+static CompilerMutex                     hoistedArrayMetadataMutex;
+
+static void noteHoistedArrayMetadata(Loop* loop, int numLoads) {
+  Expr* loopStmt = loop->getLoopStmt();
+
+  if (loopStmt != NULL) {
+    ModuleSymbol* mod = loopStmt->getModule();
+
+    if (developer == true || mod->modTag == MOD_USER) {
+      HoistedArrayMetadata note;
+      ParallelLockGuard    guard(hoistedArrayMetadataMutex);
+
+      note.modName  = mod->name;
+      note.loopTag  = loopStmt->astTagAsString();
+      note.lineno   = loopStmt->linenum();
+      note.numLoads = numLoads;
+
+      hoistedArrayMetadata.push_back(note);
+    }
+  }
+}
+
+static void reportHoistedArrayMetadata() {
+  std::stable_sort(hoistedArrayMetadata.begin(), hoistedArrayMetadata.end());
+
+  for (size_t i = 0; i < hoistedArrayMetadata.size(); i++) {
+    HoistedArrayMetadata& note = hoistedArrayMetadata[i];
+
+    printf("%s for %s:%d: hoisted %d array metadata load%s\n",
+           note.loopTag, note.modName, note.lineno,
+           note.numLoads, (note.numLoads == 1) ? "" : "s");
+  }
+
+  hoistedArrayMetadata.clear();
+}
+
+
 /*
  * The basic algorithm for loop invariant code motion is as follows:
  * First figure out where the loops actually are. To do this the dominators need 
@@ -1109,99 +1386,129 @@ static bool canPerformCodeMotion(Loop* loop) {
  * hoisted before the loop(into a preheader of sorts) so long as they definition dominates
  * all uses in the loop, and the block that the definition is located in dominates all exits. 
  */
-void loopInvariantCodeMotion(void) {
+static void loopInvariantCodeMotion(FnSymbol* fn) {
+  //build the basic blocks, where the first bb is the entry block 
+  startTimer(buildBBTimer);
 
-  if(fNoloopInvariantCodeMotion) {
-    return;
-  }
-  
-  startTimer(overallTimer);
-  long numLoops = 0;
-    
-  //TODO use stl routine here
-  forv_Vec(FnSymbol, fn, gFnSymbols) {
-
-    //build the basic blocks, where the first bb is the entry block 
-    startTimer(buildBBTimer);
-
-    BasicBlock::buildBasicBlocks(fn);
+  BasicBlock::buildBasicBlocks(fn);
 
-    std::vector<BasicBlock*> basicBlocks = *fn->basicBlocks;
+  std::vector<BasicBlock*> basicBlocks = *fn->basicBlocks;
 
-    BasicBlock* entryBlock = basicBlocks[0];
+  BasicBlock* entryBlock = basicBlocks[0];
 
-    unsigned nBlocks = basicBlocks.size();
+  unsigned nBlocks = basicBlocks.size();
 
-    stopTimer(buildBBTimer);
-    
-    //compute the dominators 
-    startTimer(computeDominatorTimer);
-    std::vector<BitVec*> dominators;
-    for(unsigned i = 0; i < nBlocks; i++) {
-      dominators.push_back(new BitVec(nBlocks));
-    }    
-    computeDominators(dominators, basicBlocks);
-    stopTimer(computeDominatorTimer);
-
-    //Collect all of the loops 
-    startTimer(collectNaturalLoopsTimer);
-    std::vector<Loop*> loops;
-    collectNaturalLoops(loops, basicBlocks, entryBlock, dominators);
-    stopTimer(collectNaturalLoopsTimer);
+  stopTimer(buildBBTimer);
+  
+  //compute the dominators 
+  startTimer(computeDominatorTimer);
+  std::vector<BitVec*> dominators;
+  for(unsigned i = 0; i < nBlocks; i++) {
+    dominators.push_back(new BitVec(nBlocks));
+  }    
+  computeDominators(dominators, basicBlocks);
+  stopTimer(computeDominatorTimer);
+
+  //Collect all of the loops 
+  startTimer(collectNaturalLoopsTimer);
+  std::vector<Loop*> loops;
+  collectNaturalLoops(loops, basicBlocks, entryBlock, dominators);
+  stopTimer(collectNaturalLoopsTimer);
+
+  RefBindingMap refBindings;
+  if (loops.size() != 0) {
+    collectRefBindings(fn, refBindings);
+  }
+  
+  //For each loop found 
+  for_vector(Loop, curLoop, loops) {
+
+    //check that this loop doesn't have anything that 
+    //would prevent code motion from occurring
+    startTimer(canPerformCodeMotionTimer);
+    bool performCodeMotion = canPerformCodeMotion(curLoop);
+    stopTimer(canPerformCodeMotionTimer);
+    if(performCodeMotion == false) {
+      continue;
+    }
     
-    //For each loop found 
-    for_vector(Loop, curLoop, loops) {
-
-      //check that this loop doesn't have anything that 
-      //would prevent code motion from occurring
-      startTimer(canPerformCodeMotionTimer);
-      bool performCodeMotion = canPerformCodeMotion(curLoop);
-      stopTimer(canPerformCodeMotionTimer);
-      if(performCodeMotion == false) {
-        continue;
-      }
-      
-      //build the defUseMaps 
-      startTimer(buildLocalDefMapsTimer);
-      symToVecSymExprMap localDefMap;
-      symToVecSymExprMap localUseMap;
-      std::map<SymExpr*, int> localMap;
-      buildLocalDefUseMaps(curLoop, localDefMap, localUseMap, localMap);
-      stopTimer(buildLocalDefMapsTimer);
-
-      //and use the defUseMaps to compute loop invariants 
-      startTimer(computeLoopInvariantsTimer);
-      std::vector<SymExpr*> loopInvariants;
-      computeLoopInvariants(loopInvariants, curLoop, localDefMap, fn);
-      stopTimer(computeLoopInvariantsTimer);
-
-      //For each invariant, only move it if its def, dominates all uses and all exits 
-      for_vector(SymExpr, symExpr, loopInvariants) {
-        if(CallExpr* call = toCallExpr(symExpr->parentExpr)) {
-          if(defDominatesAllUses(curLoop, symExpr, dominators, localMap, localUseMap)) {
-            if(defDominatesAllExits(curLoop, symExpr, dominators, localMap)) {
-              curLoop->insertBefore(call);
+    //build the defUseMaps 
+    startTimer(buildLocalDefMapsTimer);
+    symToVecSymExprMap localDefMap;
+    symToVecSymExprMap localUseMap;
+    std::map<SymExpr*, int> localMap;
+    buildLocalDefUseMaps(curLoop, localDefMap, localUseMap, localMap);
+    stopTimer(buildLocalDefMapsTimer);
+
+    //and use the defUseMaps to compute loop invariants 
+    startTimer(computeLoopInvariantsTimer);
+    std::vector<SymExpr*> loopInvariants;
+    bool metadataIsStable = arrayMetadataIsStable(curLoop, refBindings);
+    computeLoopInvariants(loopInvariants, curLoop, localDefMap, fn,
+                          refBindings, metadataIsStable);
+    stopTimer(computeLoopInvariantsTimer);
+
+    //For each invariant, only move it if its def, dominates all uses and all exits 
+    int numMetadataLoads = 0;
+    for_vector(SymExpr, symExpr, loopInvariants) {
+      if(CallExpr* call = toCallExpr(symExpr->parentExpr)) {
+        if(defDominatesAllUses(curLoop, symExpr, dominators, localMap, localUseMap)) {
+          if(defDominatesAllExits(curLoop, symExpr, dominators, localMap)) {
+            CallExpr* rhs = toCallExpr(call->get(2));
+            if (rhs != NULL && isArrayMetadataLoad(rhs, refBindings)) {
+              numMetadataLoads++;
             }
-          }   
-        }
+            curLoop->insertBefore(call);
+          }
+        }   
       }
-                
-      freeLocalDefUseMaps(localDefMap, localUseMap);
-    }
-    numLoops += loops.size();
-    
-    for_vector(Loop, loop, loops) {
-      delete loop;
-      loop = 0;
     }
-    
-    for_vector(BitVec, bitVec, dominators) {
-      delete bitVec;
-      bitVec = 0;
+
+    if (fReportArrayHoisting && numMetadataLoads > 0) {
+      noteHoistedArrayMetadata(curLoop, numMetadataLoads);
     }
+              
+    freeLocalDefUseMaps(localDefMap, localUseMap);
+  }
+#ifdef detailedTiming
+  numLoops += loops.size();
+#endif
+  
+  for_vector(Loop, loop, loops) {
+    delete loop;
+    loop = 0;
+  }
+  
+  for_vector(BitVec, bitVec, dominators) {
+    delete bitVec;
+    bitVec = 0;
   }
+}
+
+void loopInvariantCodeMotion(void) {
+
+  if(fNoloopInvariantCodeMotion) {
+    return;
+  }
+  
+  startTimer(overallTimer);
+
+#ifdef detailedTiming
+  // the timers are shared, so time one function at a time
+  numLoops = 0;
+
+  forv_Vec(FnSymbol, fn, gFnSymbols) {
+    loopInvariantCodeMotion(fn);
+  }
+#else
+  forEachFnInParallel(gFnSymbols, loopInvariantCodeMotion);
+#endif
 
   stopTimer(overallTimer);
+
+  if (fReportArrayHoisting) {
+    reportHoistedArrayMetadata();
+  }
     
 #ifdef detailedTiming  
   FILE *timingFile;
@@ -29,6 +29,7 @@
 #include "astutil.h"
 #include "driver.h"
 #include "expr.h"
+#include "fnNodeIndex.h"
 #include "stlUtil.h"
 #include "stmt.h"
 
@@ -460,7 +461,7 @@ markFastSafeFn(FnSymbol *fn, int recurse, std::set<FnSymbol*>& visited) {
 
   std::vector<CallExpr*> calls;
 
-  collectCallExprs(fn, calls);
+  fnCallExprs(fn, calls);
 
   for_vector(CallExpr, call, calls) {
     bool inLocal = fn->hasFlag(FLAG_LOCAL_FN) || inLocalBlock(call);
@@ -549,7 +550,7 @@ removeUnnecessaryFences(FnSymbol* fn)
     // from the wrapper.
     std::vector<CallExpr*> calls;
 
-    collectCallExprs(fn, calls);
+    fnCallExprs(fn, calls);
 
     for_vector(CallExpr, call, calls) {
       if (call->isPrimitive(PRIM_START_RMEM_FENCE) ||
@@ -564,6 +565,94 @@ removeUnnecessaryFences(FnSymbol* fn)
 }
 
 
+static bool
+isRefSymbol(Symbol* sym) {
+  return sym->isRef() || sym->isWideRef() || isReferenceType(sym->type);
+}
+
+// Does fn store through a reference that it was passed, or one made
+// from such a reference (e.g. by narrowing it in a local block or by
+// taking the address of a field)?
+static bool
+storesThroughFormalRef(FnSymbol* fn) {
+  std::set<Symbol*>      passed;
+  std::vector<CallExpr*> calls;
+  bool                   changed = true;
+
+  // An on-block wrapper gets its references out of the argument bundle
+  for_formals(formal, fn) {
+    if (isRefSymbol(formal) || fn->hasFlag(FLAG_ON_BLOCK))
+      passed.insert(formal);
+  }
+
+  collectCallExprs(fn->body, calls);
+
+  while (changed) {
+    changed = false;
+
+    for_vector(CallExpr, call, calls) {
+      if (call->isPrimitive(PRIM_MOVE) || call->isPrimitive(PRIM_ASSIGN)) {
+        SymExpr* lhs = toSymExpr(call->get(1));
+
+        if (lhs && isRefSymbol(lhs->symbol()) &&
+            passed.count(lhs->symbol()) == 0) {
+          std::vector<SymExpr*> rhsSymExprs;
+
+          collectSymExprs(call->get(2), rhsSymExprs);
+
+          for_vector(SymExpr, se, rhsSymExprs) {
+            if (passed.count(se->symbol()) != 0) {
+              passed.insert(lhs->symbol());
+              changed = true;
+              break;
+            }
+          }
+        }
+      }
+    }
+  }
+
+  for_vector(CallExpr, call, calls) {
+    for_actuals(actual, call) {
+      SymExpr* se = toSymExpr(actual);
+
+      if (se == NULL || passed.count(se->symbol()) == 0 ||
+          !isRefSymbol(se->symbol()))
+        continue;
+
+      if ((call->isPrimitive(PRIM_SET_MEMBER) && actual == call->get(1)) ||
+          (isDefAndOrUse(se) & 1))
+        return true;
+    }
+  }
+
+  return false;
+}
+
+// Can the caller of this fast on-block wrapper continue without waiting
+// for the on body?  Not if the body stores through a reference it was
+// passed, since that is a result the caller may read.  Nothing else a
+// fast body does can be seen by the caller without communicating, and
+// the runtime finishes such ons before starting other communication.
+static bool
+isFastOnWithoutResults(FnSymbol* wrapFn) {
+  std::vector<CallExpr*> calls;
+
+  if (storesThroughFormalRef(wrapFn))
+    return false;
+
+  collectCallExprs(wrapFn->body, calls);
+
+  for_vector(CallExpr, call, calls) {
+    FnSymbol* onFn = call->resolvedFunction();
+
+    if (onFn && onFn->hasFlag(FLAG_ON) && storesThroughFormalRef(onFn))
+      return false;
+  }
+
+  return true;
+}
+
 void
 optimizeOnClauses(void) {
   if (fNoOptimizeOnClauses)
@@ -601,8 +690,10 @@ optimizeOnClauses(void) {
     if (fastFork) {
       // Code generation will use executeOnFast because
       // the function will have been marked with FLAG_FAST_ON
-      // in markFastSafeFn.
-      // No other action is necessary at this point.
+      // in markFastSafeFn, or executeOnFastNB if the caller
+      // does not need to wait for it.
+      if (isFastOnWithoutResults(fn))
+        fn->addFlag(FLAG_FAST_ON_NB);
     }
     if (removeRmemFences) {
       // Compiling with --cache-remote adds fences for the start
@@ -625,6 +716,10 @@ optimizeOnClauses(void) {
           printf("Optimized on clause (%s) in module %s (%s:%d)\n",
                fn->cname, mod->name, fn->fname(), fn->linenum());
         }
+        if (fn->hasFlag(FLAG_FAST_ON_NB)) {
+          printf("Non-blocking on clause (%s) in module %s (%s:%d)\n",
+               fn->cname, mod->name, fn->fname(), fn->linenum());
+        }
         if (removeRmemFences) {
           printf("Optimized rmem fence (%s) in module %s (%s:%d)\n",
                fn->cname, mod->name, fn->fname(), fn->linenum());
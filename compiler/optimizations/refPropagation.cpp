@@ -22,14 +22,16 @@
 #include "optimizations.h"
 
 #include "astutil.h"
+#include "compilerThreads.h"
 #include "driver.h"
 #include "expr.h"
+#include "fnNodeIndex.h"
 #include "passes.h"
 #include "stlUtil.h"
 #include "stmt.h"
 #include "view.h"
 
-static size_t s_ref_repl_count; ///< The number of references replaced this pass.
+static CHPL_THREAD_LOCAL size_t s_ref_repl_count; ///< The number of references replaced this pass.
 
 // If there is exactly one definition of var by something of reference type, 
 // then return the call that defines it.
@@ -229,14 +231,14 @@ eliminateSingleAssignmentReference(Map<Symbol*,Vec<SymExpr*>*>& defMap,
 
 
 size_t singleAssignmentRefPropagation(FnSymbol* fn) {
-  std::vector<BaseAST*> asts;
-  collect_asts(fn, asts);
+  std::vector<DefExpr*> defs;
+  fnDefExprs(fn, defs);
 
   Vec<Symbol*> refSet;
   Vec<Symbol*> refVec;
-  // Walk the asts in this function, and build lists of reference variables and sym exprs.
-  for_vector(BaseAST, ast, asts) {
-    if (VarSymbol* var = toVarSymbol(ast)) {
+  // Walk the definitions in this function, and build a list of reference variables.
+  for_vector(DefExpr, def, defs) {
+    if (VarSymbol* var = toVarSymbol(def->sym)) {
       if (var->isRef()) {
         refVec.add(var);
         refSet.set_add(var);
@@ -301,13 +303,15 @@ size_t singleAssignmentRefPropagation(FnSymbol* fn) {
   return s_ref_repl_count;
 }
 
+static void refPropagation(FnSymbol* fn) {
+  singleAssignmentRefPropagation(fn);
+  if (!fNoDeadCodeElimination)
+    deadVariableElimination(fn);
+}
+
 void refPropagation() {
   if (!fNoCopyPropagation) {
-    forv_Vec(FnSymbol, fn, gFnSymbols) {
-      singleAssignmentRefPropagation(fn);
-      if (!fNoDeadCodeElimination)
-        deadVariableElimination(fn);
-    }
+    forEachFnInParallel(gFnSymbols, refPropagation);
   }
 }
 
@@ -0,0 +1,564 @@
+/*
+ * Copyright 2004-2017 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "passes.h"
+
+#include "astutil.h"
+#include "driver.h"
+#include "expr.h"
+#include "stlUtil.h"
+#include "stmt.h"
+#include "symbol.h"
+
+#include <cstdio>
+#include <map>
+#include <set>
+#include <vector>
+
+/************************************* | **************************************
+*                                                                             *
+* Replace heap allocations of class instances that do not outlive the        *
+* function creating them with PRIM_STACK_ALLOCATE_CLASS, the primitive that  *
+* parallel() already uses for task argument bundles.                         *
+*                                                                             *
+* After inlining, 'new C()' followed by 'delete c', and an iterator class    *
+* created by _getIterator() and released by _freeIterator(), look like       *
+*                                                                             *
+*   move tmp, chpl_here_alloc(size, md)                                       *
+*   move c, cast(C, tmp)                                                      *
+*   ...                                                                       *
+*   chpl_here_free(cast_to_void_star(c))                                      *
+*                                                                             *
+* The instance is moved to the stack when the free is the only one, both     *
+* statements are in the same block, and every mention of 'c' and of the     *
+* locals it is copied into lies between them and cannot leak the pointer:   *
+* it is not returned, stored into memory, taken by reference, or passed to   *
+* a task function, an extern, or a function whose formal may leak it.  A     *
+* function that only returns its formal, as constructors do, passes the     *
+* instance on to the result of the call.                                     *
+*                                                                             *
+* The C temporary backing the instance is declared at function scope, so a   *
+* site inside a loop reuses it.  That is safe because the free ends the     *
+* lifetime of each instance before the site can run again.                   *
+*                                                                             *
+************************************** | *************************************/
+
+enum FormalEscape {
+  FORMAL_KEPT,          // the callee only uses the formal
+  FORMAL_RETURNED,      // ... or returns it
+  FORMAL_ESCAPES        // it may outlive the call
+};
+
+typedef std::map<ArgSymbol*, FormalEscape> FormalEscapeMap;
+
+struct StackAllocSite {
+  CallExpr*         alloc;      // move tmp, chpl_here_alloc(...)
+  CallExpr*         cast;       // move c, cast(C, tmp)
+  CallExpr*         free;       // chpl_here_free(...)
+};
+
+// The locals holding an instance, or a reference into it
+struct EscapeState {
+  std::set<Symbol*>      aliases;
+  std::vector<Symbol*>   worklist;
+  std::vector<CallExpr*> frees;
+
+  bool                   isFormal;
+  bool                   returned;
+  int                    depth;
+};
+
+static const int maxCalleeDepth = 4;
+
+static bool         findAllocation(CallExpr* call, StackAllocSite& site);
+static bool         findFree(StackAllocSite&  site,
+                             FormalEscapeMap& formals);
+
+static bool         mayEscape(Symbol*          sym,
+                              EscapeState&     state,
+                              FormalEscapeMap& formals);
+static bool         pointerMayEscape(SymExpr*         se,
+                                     EscapeState&     state,
+                                     FormalEscapeMap& formals);
+static bool         interiorRefMayEscape(SymExpr*         se,
+                                         EscapeState&     state,
+                                         FormalEscapeMap& formals);
+static bool         addAlias(Symbol* sym, Expr* use, EscapeState& state);
+
+static FormalEscape formalEscape(FnSymbol*        fn,
+                                 ArgSymbol*       formal,
+                                 FormalEscapeMap& formals,
+                                 int              depth);
+
+static bool         isWithin(Expr* expr, CallExpr* first, CallExpr* last);
+static void         convertToStack(StackAllocSite& site);
+
+void stackAllocateClasses() {
+  FormalEscapeMap formals;
+  int             numConverted = 0;
+
+  if (fNoStackAllocateClasses == true) {
+    return;
+  }
+
+  forv_Vec(FnSymbol, fn, gFnSymbols) {
+    std::vector<CallExpr*> calls;
+
+    collectCallExprs(fn, calls);
+
+    for_vector(CallExpr, call, calls) {
+      StackAllocSite site;
+
+      if (findAllocation(call, site)    == true &&
+          findFree(site, formals)       == true) {
+        if (fReportStackAllocation == true) {
+          ModuleSymbol* mod = fn->getModule();
+          Symbol*       var = toSymExpr(site.cast->get(1))->symbol();
+
+          if (developer == true || mod->modTag == MOD_USER) {
+            printf("Stack allocated %s at %s:%d\n",
+                   var->type->symbol->name,
+                   mod->name,
+                   site.cast->linenum());
+          }
+        }
+
+        convertToStack(site);
+
+        numConverted++;
+      }
+    }
+  }
+
+  if (fReportStackAllocation == true && developer == true) {
+    printf("Converted %d allocations to the stack\n", numConverted);
+  }
+}
+
+//
+// Matches the two statements that allocate a class instance, and returns
+// true when the instance is held in a local of the enclosing function.
+//
+static bool findAllocation(CallExpr* call, StackAllocSite& site) {
+  FnSymbol* allocFn  = call->resolvedFunction();
+  CallExpr* move     = toCallExpr(call->parentExpr);
+  SymExpr*  tmpSe    = NULL;
+  CallExpr* cast     = NULL;
+  CallExpr* castMove = NULL;
+  SymExpr*  lhs      = NULL;
+
+  if (allocFn                                     == NULL  ||
+      allocFn->hasFlag(FLAG_LOCALE_MODEL_ALLOC)   == false ||
+      move                                        == NULL  ||
+      move->isPrimitive(PRIM_MOVE)                == false ||
+      (tmpSe = toSymExpr(move->get(1)))           == NULL  ||
+      tmpSe->symbol()->isRef()                    == true) {
+    return false;
+  }
+
+  // the temp must be used exactly once, as the operand of the cast
+  for_SymbolSymExprs(se, tmpSe->symbol()) {
+    if (se == tmpSe) {
+      continue;
+
+    } else if (cast != NULL) {
+      return false;
+
+    } else if ((cast = toCallExpr(se->parentExpr)) == NULL) {
+      return false;
+    }
+  }
+
+  if (cast                                        == NULL  ||
+      cast->isPrimitive(PRIM_CAST)                == false ||
+      (castMove = toCallExpr(cast->parentExpr))   == NULL  ||
+      castMove->isPrimitive(PRIM_MOVE)            == false ||
+      castMove->parentExpr                        != move->parentExpr ||
+      (lhs = toSymExpr(castMove->get(1)))         == NULL) {
+    return false;
+  }
+
+  AggregateType* ct  = toAggregateType(lhs->symbol()->type);
+  Symbol*        var = lhs->symbol();
+
+  if (ct                                          == NULL  ||
+      ct->isClass()                               == false ||
+      ct->symbol->hasFlag(FLAG_EXTERN)            == true  ||
+      ct->symbol->hasFlag(FLAG_DATA_CLASS)        == true  ||
+      ct->symbol->hasFlag(FLAG_WIDE_CLASS)        == true  ||
+      isVarSymbol(var)                            == false ||
+      var->defPoint->parentSymbol                 != move->parentSymbol ||
+      var->hasFlag(FLAG_EXTERN)                   == true) {
+    return false;
+  }
+
+  site.alloc = move;
+  site.cast  = castMove;
+  site.free  = NULL;
+
+  return true;
+}
+
+//
+// Finds the one free of the instance.  Fails if there is not exactly one,
+// if it is not later in the block than the allocation, if the instance may
+// escape, or if any alias is mentioned outside of the two statements.
+//
+static bool findFree(StackAllocSite& site, FormalEscapeMap& formals) {
+  Symbol*     var = toSymExpr(site.cast->get(1))->symbol();
+  EscapeState state;
+
+  state.isFormal = false;
+  state.returned = false;
+  state.depth    = 0;
+
+  if (mayEscape(var, state, formals) == true || state.frees.size() != 1) {
+    return false;
+  }
+
+  site.free = state.frees[0];
+
+  if (site.free->parentExpr != site.cast->parentExpr) {
+    return false;
+  }
+
+  for (Expr* stmt = site.cast; stmt != site.free; stmt = stmt->next) {
+    if (stmt == NULL) {
+      return false;
+    }
+  }
+
+  for_set(Symbol, alias, state.aliases) {
+    for_SymbolSymExprs(se, alias) {
+      if (isWithin(se, site.cast, site.free) == false) {
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+//
+// Adds 'sym' and the locals it is copied into to the aliases in 'state',
+// and returns true if any of them could let the instance outlive the
+// function.  Frees of the instance are collected in 'state'.
+//
+static bool mayEscape(Symbol*          sym,
+                      EscapeState&     state,
+                      FormalEscapeMap& formals) {
+  state.aliases.insert(sym);
+  state.worklist.push_back(sym);
+
+  while (state.worklist.empty() == false) {
+    Symbol* alias = state.worklist.back();
+
+    state.worklist.pop_back();
+
+    for_SymbolSymExprs(se, alias) {
+      bool escapes = false;
+
+      if (alias->isRef() == true) {
+        escapes = interiorRefMayEscape(se, state, formals);
+      } else {
+        escapes = pointerMayEscape(se, state, formals);
+      }
+
+      if (escapes == true) {
+        return true;
+      }
+    }
+  }
+
+  // each copy must hold only this instance; stores through references
+  // into it are the only other definitions allowed
+  for_set(Symbol, alias, state.aliases) {
+    if (alias->isRef() == false) {
+      int numDefs = 0;
+
+      for_SymbolDefs(def, alias) {
+        numDefs++;
+      }
+
+      if (numDefs > 1 || (numDefs == 1 && isArgSymbol(alias) == true)) {
+        return true;
+      }
+    }
+  }
+
+  return false;
+}
+
+// Can this use of a local holding the instance leak it?
+static bool pointerMayEscape(SymExpr*         se,
+                             EscapeState&     state,
+                             FormalEscapeMap& formals) {
+  CallExpr* call = toCallExpr(se->parentExpr);
+  CallExpr* move = (call != NULL) ? toCallExpr(call->parentExpr) : NULL;
+
+  if (move != NULL &&
+      (move->isPrimitive(PRIM_MOVE) == false || move->get(2) != call)) {
+    move = NULL;
+  }
+
+  if (call == NULL) {
+    return true;
+
+  // a definition, counted by mayEscape()
+  } else if (call->isPrimitive(PRIM_MOVE) == true && call->get(1) == se) {
+    return false;
+
+  } else if (call->isPrimitive(PRIM_MOVE) == true) {
+    return addAlias(toSymExpr(call->get(1))->symbol(), se, state);
+
+  } else if (call->isPrimitive(PRIM_RETURN) == true) {
+    state.returned = true;
+
+    return state.isFormal == false;
+
+  } else if (FnSymbol* fn = call->resolvedFunction()) {
+    if (fn->hasFlag(FLAG_LOCALE_MODEL_FREE) == true) {
+      state.frees.push_back(call);
+
+      return state.isFormal;
+
+    } else {
+      ArgSymbol*   formal = actual_to_formal(se);
+      FormalEscape kind   = FORMAL_ESCAPES;
+
+      // a ref formal could redirect the local to another instance
+      if (formal->isRef() == false) {
+        kind = formalEscape(fn, formal, formals, state.depth + 1);
+      }
+
+      if (kind == FORMAL_RETURNED && move != NULL) {
+        return addAlias(toSymExpr(move->get(1))->symbol(), se, state);
+      }
+
+      return kind == FORMAL_ESCAPES;
+    }
+
+  // 'delete' and _freeIterator() cast the instance for chpl_here_free()
+  } else if (call->isPrimitive(PRIM_CAST_TO_VOID_STAR) == true ||
+             call->isPrimitive(PRIM_WIDE_GET_ADDR)     == true ||
+             call->isPrimitive(PRIM_CAST)              == true ||
+             call->isPrimitive(PRIM_DYNAMIC_CAST)      == true) {
+    CallExpr* parent = toCallExpr(call->parentExpr);
+    FnSymbol* fn     = (parent != NULL) ? parent->resolvedFunction() : NULL;
+
+    if (fn != NULL && fn->hasFlag(FLAG_LOCALE_MODEL_FREE) == true) {
+      state.frees.push_back(parent);
+
+      return state.isFormal;
+
+    } else if (move != NULL) {
+      return addAlias(toSymExpr(move->get(1))->symbol(), se, state);
+    }
+
+    return true;
+
+  } else if (call->get(1) != se) {
+    return call->isPrimitive(PRIM_PTR_EQUAL)    == false &&
+           call->isPrimitive(PRIM_PTR_NOTEQUAL) == false &&
+           call->isPrimitive(PRIM_EQUAL)        == false &&
+           call->isPrimitive(PRIM_NOTEQUAL)     == false;
+
+  // the super class part of the instance, or a reference to a field
+  } else if ((call->isPrimitive(PRIM_GET_MEMBER_VALUE) == true &&
+              toSymExpr(call->get(2))->symbol()->hasFlag(FLAG_SUPER_CLASS)) ||
+             call->isPrimitive(PRIM_GET_MEMBER)        == true) {
+    if (move != NULL) {
+      return addAlias(toSymExpr(move->get(1))->symbol(), se, state);
+    }
+
+    return true;
+
+  } else {
+    return call->isPrimitive(PRIM_GET_MEMBER_VALUE) == false &&
+           call->isPrimitive(PRIM_SET_MEMBER)       == false &&
+           call->isPrimitive(PRIM_SETCID)           == false &&
+           call->isPrimitive(PRIM_GETCID)           == false &&
+           call->isPrimitive(PRIM_TESTCID)          == false &&
+           call->isPrimitive(PRIM_CHECK_NIL)        == false &&
+           call->isPrimitive(PRIM_PTR_EQUAL)        == false &&
+           call->isPrimitive(PRIM_PTR_NOTEQUAL)     == false &&
+           call->isPrimitive(PRIM_EQUAL)            == false &&
+           call->isPrimitive(PRIM_NOTEQUAL)         == false;
+  }
+}
+
+//
+// A reference to a field of the instance may be read, written through, or
+// passed on by reference, but must not outlive it either.
+//
+static bool interiorRefMayEscape(SymExpr*         se,
+                                 EscapeState&     state,
+                                 FormalEscapeMap& formals) {
+  CallExpr* call = toCallExpr(se->parentExpr);
+  CallExpr* move = (call != NULL) ? toCallExpr(call->parentExpr) : NULL;
+
+  if (call == NULL) {
+    return true;
+
+  // a store through the reference
+  } else if (call->isPrimitive(PRIM_MOVE) == true && call->get(1) == se) {
+    return false;
+
+  } else if (call->isPrimitive(PRIM_MOVE) == true) {
+    Symbol* lhs = toSymExpr(call->get(1))->symbol();
+
+    // a load of the field's value
+    if (lhs->isRef() == false) {
+      return false;
+    }
+
+    return addAlias(lhs, se, state);
+
+  } else if ((call->isPrimitive(PRIM_GET_MEMBER)    == true ||
+              call->isPrimitive(PRIM_ADDR_OF)       == true ||
+              call->isPrimitive(PRIM_SET_REFERENCE) == true) &&
+             call->get(1)                           == se &&
+             move                                   != NULL &&
+             move->isPrimitive(PRIM_MOVE)           == true) {
+    return addAlias(toSymExpr(move->get(1))->symbol(), se, state);
+
+  } else if (FnSymbol* fn = call->resolvedFunction()) {
+    ArgSymbol* formal = actual_to_formal(se);
+
+    return formal->isRef()                                    == true &&
+           formalEscape(fn, formal, formals, state.depth + 1) != FORMAL_KEPT;
+
+  } else if (call->get(1) != se) {
+    return true;
+
+  } else {
+    switch (call->primitive != NULL ? call->primitive->tag : PRIM_UNKNOWN) {
+    case PRIM_DEREF:
+    case PRIM_GET_MEMBER_VALUE:
+    case PRIM_SET_MEMBER:
+    case PRIM_ASSIGN:
+    case PRIM_ADD_ASSIGN:
+    case PRIM_SUBTRACT_ASSIGN:
+    case PRIM_MULT_ASSIGN:
+    case PRIM_DIV_ASSIGN:
+    case PRIM_MOD_ASSIGN:
+    case PRIM_LSH_ASSIGN:
+    case PRIM_RSH_ASSIGN:
+    case PRIM_AND_ASSIGN:
+    case PRIM_OR_ASSIGN:
+    case PRIM_XOR_ASSIGN:
+      return false;
+
+    default:
+      return true;
+    }
+  }
+}
+
+// Returns true if 'sym' cannot be tracked as another alias
+static bool addAlias(Symbol* sym, Expr* use, EscapeState& state) {
+  if (isVarSymbol(sym)                 == false ||
+      sym->defPoint->parentSymbol      != use->parentSymbol) {
+    return true;
+  }
+
+  if (state.aliases.count(sym) == 0) {
+    state.aliases.insert(sym);
+    state.worklist.push_back(sym);
+  }
+
+  return false;
+}
+
+//
+// What a callee can do with the instance passed for 'formal'
+//
+static FormalEscape formalEscape(FnSymbol*        fn,
+                                 ArgSymbol*       formal,
+                                 FormalEscapeMap& formals,
+                                 int              depth) {
+  FormalEscapeMap::iterator it = formals.find(formal);
+
+  if (it != formals.end()) {
+    return it->second;
+  }
+
+  FormalEscape retval = FORMAL_ESCAPES;
+
+  // assume it escapes while this is being computed, for recursion
+  formals[formal] = FORMAL_ESCAPES;
+
+  if (depth                                       <= maxCalleeDepth &&
+      fn->hasFlag(FLAG_EXTERN)                    == false &&
+      fn->hasFlag(FLAG_VIRTUAL)                   == false &&
+      isTaskFun(fn)                               == false) {
+    EscapeState state;
+
+    state.isFormal = true;
+    state.returned = false;
+    state.depth    = depth;
+
+    if (mayEscape(formal, state, formals) == false) {
+      retval = (state.returned == true) ? FORMAL_RETURNED : FORMAL_KEPT;
+    }
+  }
+
+  // results cut short by the depth limit are conservative, so keep them too
+  formals[formal] = retval;
+
+  return retval;
+}
+
+// Is 'expr' inside one of the statements from 'first' through 'last'?
+static bool isWithin(Expr* expr, CallExpr* first, CallExpr* last) {
+  Expr* stmt = expr;
+
+  while (stmt != NULL && stmt->parentExpr != first->parentExpr) {
+    stmt = stmt->parentExpr;
+  }
+
+  if (stmt == NULL) {
+    return false;
+  }
+
+  for (Expr* cur = first; cur != NULL; cur = cur->next) {
+    if (cur == stmt) {
+      return true;
+    } else if (cur == last) {
+      break;
+    }
+  }
+
+  return false;
+}
+
+static void convertToStack(StackAllocSite& site) {
+  SymExpr*  tmp  = toSymExpr(site.alloc->get(1));
+  CallExpr* cast = toCallExpr(site.cast->get(2));
+  Symbol*   var  = toSymExpr(site.cast->get(1))->symbol();
+
+  SET_LINENO(site.cast);
+
+  cast->replace(new CallExpr(PRIM_STACK_ALLOCATE_CLASS, var->type->symbol));
+
+  site.alloc->remove();
+  tmp->symbol()->defPoint->remove();
+
+  site.free->remove();
+}
@@ -0,0 +1,2266 @@
+/*
+ * Copyright 2004-2017 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "moduleCache.h"
+
+#include "AggregateType.h"
+#include "astutil.h"
+#include "build.h"
+#include "CatchStmt.h"
+#include "CForLoop.h"
+#include "config.h"
+#include "DeferStmt.h"
+#include "docsDriver.h"
+#include "DoWhileStmt.h"
+#include "driver.h"
+#include "expr.h"
+#include "ForallStmt.h"
+#include "foralls.h"
+#include "ForLoop.h"
+#include "misc.h"
+#include "ParamForLoop.h"
+#include "parser.h"
+#include "primitive.h"
+#include "stmt.h"
+#include "stringutil.h"
+#include "symbol.h"
+#include "TryStmt.h"
+#include "type.h"
+#include "UseStmt.h"
+#include "version.h"
+#include "WhileDoStmt.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+/************************************* | **************************************
+*                                                                             *
+* File format                                                                 *
+*                                                                             *
+* A cache file is a CacheHeader followed by a payload of 32-bit words:        *
+*                                                                             *
+*   name counters consumed by the parse                                       *
+*   string table                                                              *
+*   names of the config variables declared in the file                        *
+*   the string literals the parse created, in order                           *
+*   external references (builtins in the root module, literals)               *
+*   node table: one entry per AST node, in id order, with the arguments       *
+*               needed to construct it                                        *
+*   node data:  the remaining fields of every node, in the same order         *
+*   the 'use' statements that queued modules for parsing                      *
+*   the top-level modules                                                     *
+*                                                                             *
+* Node references are 0 for NULL, i + 1 for node i of the file and -(i + 1)   *
+* for external reference i.                                                   *
+*                                                                             *
+************************************** | *************************************/
+
+static const char     kMagic[8]      = { 'C','H','P','L','M','O','D','\n' };
+static const uint32_t kFormatVersion = 1;
+
+struct CacheHeader {
+  char     magic[8];
+  uint32_t formatVersion;
+  uint32_t payloadSize;                // in words
+  uint64_t configKey;
+  uint64_t sourceHash;
+  uint64_t payloadHash;
+};
+
+// BlockStmt and its subclasses all have the tag E_BlockStmt
+enum BlockKind {
+  BK_BLOCK,
+  BK_WHILE_DO,
+  BK_DO_WHILE,
+  BK_FOR,
+  BK_C_FOR,
+  BK_PARAM_FOR
+};
+
+enum ExternKind {
+  EXT_ROOT_SYMBOL,
+  EXT_ROOT_TYPE,
+  EXT_NEW_LITERAL,                     // a string literal the parse created
+  EXT_LITERAL
+};
+
+// variant bits for FnSymbol/CatchStmt and AggregateType entries
+static const int kReuseCtorBlock = 1;  // next node is the ctor's BlockStmt
+static const int kIsStringType   = 2;  // the AggregateType becomes dtString
+
+//
+// The parser names some functions by appending the value of one of
+// parseNameCounters to a prefix.  Such names are stored relative to the
+// counter's value at the start of the parse.
+//
+struct GeneratedName {
+  const char*      prefix;
+  ParseNameCounter counter;
+};
+
+static const GeneratedName sGeneratedNames[] = {
+  { "_if_fn",                 PNC_IF_FN      },
+  { "_let_fn",                PNC_LET_FN     },
+  { "_seqloopexpr",           PNC_LOOPEXPR   },
+  { "_parloopexpr",           PNC_LOOPEXPR   },
+  { "_iterator_for_loopexpr", PNC_LOOPEXPR   },
+  { "chpl__reduce",           PNC_REDUCE     },
+  { "chpl__scan",             PNC_SCAN       },
+  { "forwarding_expr",        PNC_FORWARDING }
+};
+
+static const int kNumGeneratedNames =
+  sizeof(sGeneratedNames) / sizeof(sGeneratedNames[0]);
+
+// state for the parse of a file that will be written to the cache
+static bool                                        sRecording     = false;
+static bool                                        sUncacheable   = false;
+static int                                         sErrorsAtStart = 0;
+static Expr*                                       sLastLiteralDef = NULL;
+static int                   sCountersAtStart[NUM_PARSE_NAME_COUNTERS];
+static std::vector<std::pair<const char*, UseStmt*> > sUses;
+
+/************************************* | **************************************
+*                                                                             *
+* Hashing                                                                     *
+*                                                                             *
+************************************** | *************************************/
+
+static const uint64_t kHashSeed = 14695981039346656037ULL;
+
+static uint64_t hashBytes(uint64_t hash, const void* data, size_t size) {
+  const unsigned char* bytes = (const unsigned char*) data;
+
+  for (size_t i = 0; i < size; i++) {
+    hash = (hash ^ bytes[i]) * 1099511628211ULL;
+  }
+
+  return hash;
+}
+
+static uint64_t hashInt(uint64_t hash, int64_t value) {
+  return hashBytes(hash, &value, sizeof(value));
+}
+
+static uint64_t hashString(uint64_t hash, const char* str) {
+  if (str == NULL) {
+    return hashInt(hash, -1);
+  } else {
+    return hashBytes(hash, str, strlen(str) + 1);
+  }
+}
+
+static bool hashFile(const char* path, uint64_t& hash) {
+  FILE* fp     = fopen(path, "rb");
+  char  buf[8192];
+  bool  retval = false;
+
+  if (fp != NULL) {
+    size_t n = 0;
+
+    hash = kHashSeed;
+
+    while ((n = fread(buf, 1, sizeof(buf), fp)) > 0) {
+      hash = hashBytes(hash, buf, n);
+    }
+
+    retval = ferror(fp) == 0;
+
+    fclose(fp);
+  }
+
+  return retval;
+}
+
+//
+// Everything other than the module source that can change the AST the
+// parser builds for a module, or the meaning of the cached encoding of
+// it.  Returns 0 if the compiler executable cannot be found, in which
+// case caching is disabled since a rebuilt compiler could not be told
+// apart from this one.
+//
+static uint64_t configKey() {
+  static bool     computed = false;
+  static uint64_t key      = 0;
+
+  if (computed == false) {
+    uint64_t    hash = kHashSeed;
+    char        version[128];
+    struct stat sb;
+
+    computed = true;
+
+    hash = hashInt(hash, kFormatVersion);
+
+    get_major_minor_version(version);
+    hash = hashString(hash, version);
+
+#define symbolFlag(NAME, PRAGMA, MAPNAME, COMMENT) \
+    hash = hashString(hash, #NAME);
+#include "flags_list.h"
+#undef symbolFlag
+
+    for (int i = 0; i < NUM_KNOWN_PRIMS; i++) {
+      hash = hashString(hash, primitives[i] ? primitives[i]->name : NULL);
+    }
+
+#define hash_size(type) hash = hashInt(hash, sizeof(type))
+    foreach_ast(hash_size);
+#undef hash_size
+
+    for (std::map<std::string, const char*>::iterator it = envMap.begin();
+         it != envMap.end();
+         it++) {
+      hash = hashString(hash, it->first.c_str());
+      hash = hashString(hash, it->second);
+    }
+
+    hash = hashInt(hash, fMinimalModules);
+    hash = hashInt(hash, fUseIPE);
+    hash = hashInt(hash, fEnableTaskTracking);
+    hash = hashInt(hash, fNoFastFollowers);
+    hash = hashInt(hash, externC);
+    hash = hashInt(hash, fUserDefaultInitializers);
+
+    if (compilerExecutable != NULL && stat(compilerExecutable, &sb) == 0) {
+      hash = hashInt(hash, sb.st_size);
+      hash = hashInt(hash, sb.st_mtime);
+
+      key  = (hash != 0) ? hash : 1;
+    }
+  }
+
+  return key;
+}
+
+static const char* cacheFileName(const char* path) {
+  const char* base = strrchr(path, '/');
+  char        hex[32];
+
+  snprintf(hex, sizeof(hex), "%016llx",
+           (unsigned long long) hashString(kHashSeed, path));
+
+  return astr(moduleCacheDir, "/", (base != NULL) ? base + 1 : path,
+              "-", hex, ".ast");
+}
+
+/************************************* | **************************************
+*                                                                             *
+*                                                                             *
+*                                                                             *
+************************************** | *************************************/
+
+class ModuleCache {
+public:
+                              ModuleCache();
+
+  bool                        save(const char*                       path,
+                                   const std::vector<ModuleSymbol*>& modules);
+
+  bool                        load(const char*                 path,
+                                   std::vector<ModuleSymbol*>& modules);
+
+  const char*                 failure()                                  const;
+
+private:
+  // writing
+  void                        fail(BaseAST* ast, const char* why);
+  void                        check(bool ok, BaseAST* ast, const char* why);
+
+  void                        put(int32_t value);
+  void                        put64(uint64_t value);
+  void                        putRaw(const char* str);
+  void                        putString(const char* str);
+  void                        putRef(BaseAST* ast);
+  void                        putList(AList& list);
+  void                        putNames(const std::vector<const char*>& names);
+  void                        putRenames(
+                                 const std::map<const char*,
+                                                const char*>& renames);
+
+  int                         stringId(const char* str);
+  int                         ref(BaseAST* ast);
+  int                         externId(BaseAST* ast);
+  bool                        putLiteral(VarSymbol* var);
+
+  void                        putEntry(BaseAST* ast, int index);
+  void                        putNode(BaseAST* ast);
+  void                        putSymbol(Symbol* sym);
+  void                        putType(Type* type);
+  void                        putBlock(BlockStmt* block);
+
+  // reading
+  int32_t                     get();
+  uint64_t                    get64();
+  std::string                 getRaw();
+  const char*                 getString();
+  BaseAST*                    getRef();
+  void                        getList(AList& list);
+  void                        getNames(std::vector<const char*>& names);
+  void                        getRenames(
+                                 std::map<const char*, const char*>& renames);
+
+  void                        readString();
+  BaseAST*                    readExtern();
+  void                        createNode(int index);
+  void                        getNode(BaseAST* ast);
+  void                        getSymbol(Symbol* sym);
+  void                        getType(Type* type);
+  void                        getBlock(BlockStmt* block);
+
+  // both
+  void                        collectBuiltins();
+
+  std::vector<Symbol*>        mBuiltins;
+  std::map<Symbol*, int>      mBuiltinIds;
+
+  std::vector<BaseAST*>       mNodes;
+  std::map<BaseAST*, int>     mNodeIds;
+
+  std::map<BaseAST*, int>     mExternIds;
+  std::vector<BaseAST*>       mExterns;
+
+  std::map<std::string, int>  mStringIds;
+  std::vector<const char*>    mStrings;
+
+  std::vector<const char*>    mConfigs;
+  std::vector<int>            mStringLiterals;
+  std::map<VarSymbol*, int>   mStringLiteralIds;
+  std::vector<VarSymbol*>     mNewLiterals;
+
+  std::vector<int32_t>        mStringWords;
+  std::vector<int32_t>        mExternWords;
+  std::vector<int32_t>        mTableWords;
+  std::vector<int32_t>        mBodyWords;
+  std::vector<int32_t>*       mOut;
+
+  const int32_t*              mIn;
+  size_t                      mPos;
+  size_t                      mEnd;
+
+  UnresolvedSymExpr*          mPlaceholderExpr;
+  BlockStmt*                  mPlaceholderBlock;
+
+  const char*                 mFailure;
+};
+
+ModuleCache::ModuleCache() {
+  mOut              = &mBodyWords;
+
+  mIn               = NULL;
+  mPos              = 0;
+  mEnd              = 0;
+
+  mPlaceholderExpr  = NULL;
+  mPlaceholderBlock = NULL;
+
+  mFailure          = NULL;
+}
+
+const char* ModuleCache::failure() const {
+  return mFailure;
+}
+
+//
+// The builtin symbols in the root module: everything except literals,
+// which are created as the parser finds them and so differ from one
+// compile to the next.
+//
+void ModuleCache::collectBuiltins() {
+  for_alist(expr, rootModule->block->body) {
+    if (DefExpr* def = toDefExpr(expr)) {
+      Symbol* sym = def->sym;
+
+      if (strncmp(sym->name, "_literal_",      9) != 0 &&
+          strncmp(sym->name, "_cstr_literal_", 14) != 0) {
+        mBuiltinIds[sym] = (int) mBuiltins.size();
+        mBuiltins.push_back(sym);
+      }
+    }
+  }
+}
+
+/************************************* | **************************************
+*                                                                             *
+* Writing                                                                     *
+*                                                                             *
+************************************** | *************************************/
+
+void ModuleCache::fail(BaseAST* ast, const char* why) {
+  if (mFailure == NULL) {
+    if (ast != NULL) {
+      mFailure = astr(why, " (", astr(istr(ast->id)), ")");
+    } else {
+      mFailure = why;
+    }
+  }
+}
+
+void ModuleCache::check(bool ok, BaseAST* ast, const char* why) {
+  if (ok == false) {
+    fail(ast, why);
+  }
+}
+
+void ModuleCache::put(int32_t value) {
+  mOut->push_back(value);
+}
+
+void ModuleCache::put64(uint64_t value) {
+  put((int32_t) (value & 0xffffffff));
+  put((int32_t) (value >> 32));
+}
+
+void ModuleCache::putRaw(const char* str) {
+  size_t len   = strlen(str);
+  size_t words = (len + 3) / 4;
+  size_t start = mOut->size();
+
+  put((int32_t) len);
+
+  mOut->resize(start + 1 + words, 0);
+
+  memcpy(&(*mOut)[start + 1], str, len);
+}
+
+void ModuleCache::putString(const char* str) {
+  put(stringId(str));
+}
+
+void ModuleCache::putRef(BaseAST* ast) {
+  put(ref(ast));
+}
+
+void ModuleCache::putList(AList& list) {
+  put(list.length);
+
+  for_alist(expr, list) {
+    putRef(expr);
+  }
+}
+
+void ModuleCache::putNames(const std::vector<const char*>& names) {
+  put((int32_t) names.size());
+
+  for (size_t i = 0; i < names.size(); i++) {
+    putString(names[i]);
+  }
+}
+
+void ModuleCache::putRenames(const std::map<const char*,
+                                            const char*>& renames) {
+  put((int32_t) renames.size());
+
+  for (std::map<const char*, const char*>::const_iterator
+         it = renames.begin(); it != renames.end(); it++) {
+    putString(it->first);
+    putString(it->second);
+  }
+}
+
+int ModuleCache::stringId(const char* str) {
+  int retval = 0;
+
+  if (str != NULL) {
+    std::map<std::string, int>::iterator it = mStringIds.find(str);
+
+    if (it != mStringIds.end()) {
+      retval = it->second;
+
+    } else {
+      std::vector<int32_t>* saved   = mOut;
+      bool                  written = false;
+
+      mOut = &mStringWords;
+
+      for (int i = 0; i < kNumGeneratedNames && written == false; i++) {
+        const GeneratedName& gen = sGeneratedNames[i];
+        size_t               len = strlen(gen.prefix);
+
+        if (strncmp(str, gen.prefix, len) == 0 && isdigit(str[len])) {
+          char* rest   = NULL;
+          long  number = strtol(str + len, &rest, 10);
+
+          if (number >= sCountersAtStart[gen.counter] &&
+              number <  parseNameCounters[gen.counter]) {
+            put(1);
+            put(gen.counter);
+            put((int32_t) (number - sCountersAtStart[gen.counter]));
+            putRaw(gen.prefix);
+            putRaw(rest);
+
+            written = true;
+          }
+        }
+      }
+
+      if (written == false) {
+        put(0);
+        putRaw(str);
+      }
+
+      mOut = saved;
+
+      retval          = (int) mStrings.size() + 1;
+      mStringIds[str] = retval;
+
+      mStrings.push_back(str);
+    }
+  }
+
+  return retval;
+}
+
+int ModuleCache::ref(BaseAST* ast) {
+  int retval = 0;
+
+  if (ast != NULL) {
+    std::map<BaseAST*, int>::iterator it = mNodeIds.find(ast);
+
+    if (it != mNodeIds.end()) {
+      retval = it->second + 1;
+
+    } else {
+      int ext = externId(ast);
+
+      if (ext >= 0) {
+        retval = -(ext + 1);
+      }
+    }
+  }
+
+  return retval;
+}
+
+int ModuleCache::externId(BaseAST* ast) {
+  std::map<BaseAST*, int>::iterator it     = mExternIds.find(ast);
+  int                               retval = -1;
+
+  if (it != mExternIds.end()) {
+    retval = it->second;
+
+  } else {
+    std::vector<int32_t>* saved = mOut;
+    bool                  ok    = true;
+
+    mOut = &mExternWords;
+
+    if (Symbol* sym = toSymbol(ast)) {
+      VarSymbol* var = toVarSymbol(sym);
+
+      if (mBuiltinIds.count(sym) != 0) {
+        put(EXT_ROOT_SYMBOL);
+        put(mBuiltinIds[sym]);
+        putString(sym->name);
+
+      } else if (var != NULL && mStringLiteralIds.count(var) != 0) {
+        put(EXT_NEW_LITERAL);
+        put(mStringLiteralIds[var]);
+
+      } else if (var != NULL && var->immediate != NULL) {
+        ok = putLiteral(var);
+
+      } else {
+        ok = false;
+      }
+
+    } else if (Type* type = toType(ast)) {
+      if (type->symbol != NULL && mBuiltinIds.count(type->symbol) != 0) {
+        put(EXT_ROOT_TYPE);
+        put(mBuiltinIds[type->symbol]);
+        putString(type->symbol->name);
+
+      } else {
+        ok = false;
+      }
+
+    } else {
+      ok = false;
+    }
+
+    mOut = saved;
+
+    if (ok == true) {
+      retval          = (int) mExterns.size();
+      mExternIds[ast] = retval;
+
+      mExterns.push_back(ast);
+
+    } else {
+      fail(ast, "reference to a node outside the file");
+    }
+  }
+
+  return retval;
+}
+
+bool ModuleCache::putLiteral(VarSymbol* var) {
+  Immediate* imm    = var->immediate;
+  bool       retval = true;
+
+  switch (imm->const_kind) {
+    case CONST_KIND_STRING:
+      if (imm->string_kind == STRING_KIND_STRING ||
+          imm->string_kind == STRING_KIND_C_STRING) {
+        put(EXT_LITERAL);
+        put(imm->const_kind);
+        put(imm->string_kind);
+        putString(imm->v_string);
+
+      } else {
+        retval = false;
+      }
+      break;
+
+    case NUM_KIND_INT:
+      put(EXT_LITERAL);
+      put(imm->const_kind);
+      put(imm->num_index);
+      put64((uint64_t) imm->int_value());
+      break;
+
+    case NUM_KIND_UINT:
+      put(EXT_LITERAL);
+      put(imm->const_kind);
+      put(imm->num_index);
+      put64(imm->uint_value());
+      break;
+
+    case NUM_KIND_REAL:
+    case NUM_KIND_IMAG:
+      put(EXT_LITERAL);
+      put(imm->const_kind);
+      put(imm->num_index);
+      putString(var->cname);
+      break;
+
+    default:
+      retval = false;
+      break;
+  }
+
+  return retval;
+}
+
+//
+// The node table entry holds what is needed to construct the node.
+//
+void ModuleCache::putEntry(BaseAST* ast, int index) {
+  int variant = 0;
+  int a       = 0;
+  int b       = 0;
+  int c       = 0;
+
+  switch (ast->astTag) {
+    case E_PrimitiveType:
+    case E_EnumType:
+      break;
+
+    case E_AggregateType:
+      a = toAggregateType(ast)->aggregateTag;
+
+      if (ast == dtString) {
+        variant = kIsStringType;
+      }
+      break;
+
+    case E_ModuleSymbol: {
+      ModuleSymbol* mod = toModuleSymbol(ast);
+
+      a = mod->modTag;
+      b = ref(mod->block);
+      c = stringId(mod->name);
+
+      check(b > 0 && b - 1 < index, ast, "module block follows module");
+      break;
+    }
+
+    case E_TypeSymbol:
+      a = stringId(toTypeSymbol(ast)->name);
+      b = ref(toTypeSymbol(ast)->type);
+
+      check(b != 0 && b - 1 < index, ast, "type follows its symbol");
+      break;
+
+    case E_ArgSymbol:
+      a = toArgSymbol(ast)->intent;
+      b = stringId(toArgSymbol(ast)->name);
+      break;
+
+    case E_FnSymbol: {
+      FnSymbol* fn = toFnSymbol(ast);
+
+      a = stringId(fn->name);
+
+      if (index + 1 < (int) mNodes.size() &&
+          mNodes[index + 1] == fn->body &&
+          fn->body->id == fn->id + 1) {
+        variant = kReuseCtorBlock;
+      }
+      break;
+    }
+
+    case E_VarSymbol:
+    case E_EnumSymbol:
+    case E_LabelSymbol:
+      a = stringId(toSymbol(ast)->name);
+      break;
+
+    case E_SymExpr:
+    case E_DefExpr:
+    case E_CallExpr:
+    case E_ForallExpr:
+    case E_UseStmt:
+    case E_CondStmt:
+    case E_DeferStmt:
+    case E_ForwardingStmt:
+      break;
+
+    case E_UnresolvedSymExpr:
+      a = stringId(toUnresolvedSymExpr(ast)->unresolved);
+      break;
+
+    case E_NamedExpr:
+      a = stringId(toNamedExpr(ast)->name);
+      break;
+
+    case E_BlockStmt: {
+      BlockStmt* block = toBlockStmt(ast);
+
+      if (block->isWhileDoStmt() == true) {
+        variant = BK_WHILE_DO;
+
+      } else if (block->isDoWhileStmt() == true) {
+        variant = BK_DO_WHILE;
+
+      } else if (block->isForLoop()      == true ||
+                 block->isCoforallLoop() == true) {
+        variant = BK_FOR;
+
+      } else if (block->isCForLoop() == true) {
+        variant = BK_C_FOR;
+
+      } else if (block->isParamForLoop() == true) {
+        variant = BK_PARAM_FOR;
+
+      } else {
+        check(block->isLoopStmt() == false, ast, "unknown loop statement");
+
+        variant = BK_BLOCK;
+      }
+      break;
+    }
+
+    case E_GotoStmt:
+      a = toGotoStmt(ast)->gotoTag;
+      break;
+
+    case E_ForallIntent:
+      a = toForallIntent(ast)->fiIntent;
+      break;
+
+    case E_ForallStmt:
+      a = toForallStmt(ast)->fZippered;
+      break;
+
+    case E_TryStmt:
+      a = toTryStmt(ast)->_tryBang;
+      break;
+
+    case E_CatchStmt: {
+      CatchStmt* cs = toCatchStmt(ast);
+
+      if (index + 1 < (int) mNodes.size() &&
+          mNodes[index + 1] == cs->_body &&
+          cs->_body->id == cs->id + 1) {
+        variant = kReuseCtorBlock;
+      }
+      break;
+    }
+
+    case E_ExternBlockStmt:
+      a = stringId(toExternBlockStmt(ast)->c_code);
+      break;
+
+    default:
+      fail(ast, "unsupported node type");
+      break;
+  }
+
+  mOut = &mTableWords;
+
+  put(ast->astTag);
+  put(variant);
+  put(ast->astloc.lineno);
+  putString(ast->astloc.filename);
+  put(a);
+  put(b);
+  put(c);
+
+  mOut = &mBodyWords;
+}
+
+void ModuleCache::putSymbol(Symbol* sym) {
+  int numFlags = 0;
+
+  check(sym->fieldQualifiers == NULL, sym, "field qualifiers");
+
+  putString(sym->name);
+  putString(sym->cname);
+  put(sym->qual);
+  putRef(sym->type);
+
+  for (int flag = FLAG_FIRST; flag <= FLAG_LAST; flag++) {
+    if (sym->flags[flag] == true) {
+      numFlags++;
+    }
+  }
+
+  put(numFlags);
+
+  for (int flag = FLAG_FIRST; flag <= FLAG_LAST; flag++) {
+    if (sym->flags[flag] == true) {
+      put(flag);
+    }
+  }
+
+  if (sym->hasFlag(FLAG_CONFIG) == true) {
+    mConfigs.push_back(sym->name);
+  }
+}
+
+void ModuleCache::putType(Type* type) {
+  check(type->refType             == NULL &&
+        type->scalarPromotionType == NULL &&
+        type->substitutions.n     == 0    &&
+        type->dispatchChildren.n  == 0    &&
+        type->dispatchParents.n   == 0    &&
+        type->getDestructor()     == NULL,
+        type,
+        "type state set after parsing");
+
+  putRef(type->defaultValue);
+  put(type->isInternalType);
+  put(type->hasGenericDefaults);
+
+  put(type->methods.n);
+
+  forv_Vec(FnSymbol, method, type->methods) {
+    putRef(method);
+  }
+}
+
+void ModuleCache::putBlock(BlockStmt* block) {
+  ForallIntents* fi = block->forallIntents;
+
+  put(block->blockTag);
+  putList(block->body);
+  putString(block->userLabel);
+  putRef(block->BlockStmt::blockInfoGet());
+  putRef(block->useList);
+  putRef(block->byrefVars);
+
+  put(fi != NULL);
+
+  if (fi != NULL) {
+    put(fi->numVars());
+
+    for (int i = 0; i < fi->numVars(); i++) {
+      putRef(fi->fiVars[i]);
+      put(fi->fIntents[i]);
+      putRef(fi->riSpecs[i]);
+    }
+
+    putRef(fi->iterRec);
+    putRef(fi->leadIdx);
+    putRef(fi->leadIdxCopy);
+  }
+
+  if (LoopStmt* loop = toLoopStmt(block)) {
+    putRef(loop->breakLabelGet());
+    putRef(loop->continueLabelGet());
+    put(loop->isOrderIndependent());
+  }
+
+  if (WhileStmt* loop = toWhileStmt(block)) {
+    putRef(loop->mCondExpr);
+
+  } else if (ForLoop* loop = toForLoop(block)) {
+    putRef(loop->mIndex);
+    putRef(loop->mIterator);
+    put(loop->mZippered);
+
+  } else if (CForLoop* loop = toCForLoop(block)) {
+    putRef(loop->mInitClause);
+    putRef(loop->mTestClause);
+    putRef(loop->mIncrClause);
+
+  } else if (ParamForLoop* loop = toParamForLoop(block)) {
+    putRef(loop->mResolveInfo);
+  }
+}
+
+void ModuleCache::putNode(BaseAST* ast) {
+  switch (ast->astTag) {
+    case E_PrimitiveType:
+      putType(toType(ast));
+      break;
+
+    case E_EnumType: {
+      EnumType* et = toEnumType(ast);
+
+      check(et->integerType == NULL, ast, "enum integer type");
+
+      putType(et);
+      putList(et->constants);
+      putString(et->doc);
+      break;
+    }
+
+    case E_AggregateType: {
+      AggregateType* at = toAggregateType(ast);
+
+      check(at->defaultTypeConstructor == NULL &&
+            at->defaultInitializer     == NULL &&
+            at->instantiatedFrom       == NULL &&
+            at->iteratorInfo           == NULL,
+            ast,
+            "aggregate type state set after parsing");
+
+      putType(at);
+      put(at->initializerStyle);
+      putList(at->fields);
+      putList(at->inherits);
+      putList(at->forwardingTo);
+      putRef(at->outer);
+      putString(at->doc);
+      put(at->isGeneric());
+      break;
+    }
+
+    case E_ModuleSymbol: {
+      ModuleSymbol* mod = toModuleSymbol(ast);
+
+      check(mod->initFn       == NULL &&
+            mod->deinitFn     == NULL &&
+            mod->modUseList.n == 0    &&
+            mod->extern_info  == NULL,
+            ast,
+            "module state set after parsing");
+
+      putSymbol(mod);
+      putString(mod->filename);
+      putString(mod->doc);
+      break;
+    }
+
+    case E_VarSymbol: {
+      VarSymbol* var = toVarSymbol(ast);
+
+      check(var->immediate == NULL, ast, "immediate");
+
+      putSymbol(var);
+      putString(var->doc);
+      break;
+    }
+
+    case E_ArgSymbol: {
+      ArgSymbol* arg = toArgSymbol(ast);
+
+      check(arg->instantiatedFrom == NULL, ast, "instantiated argument");
+
+      putSymbol(arg);
+      put(arg->intent);
+      putRef(arg->typeExpr);
+      putRef(arg->defaultExpr);
+      putRef(arg->variableExpr);
+      break;
+    }
+
+    case E_TypeSymbol:
+      putSymbol(toSymbol(ast));
+      putString(toTypeSymbol(ast)->doc);
+      break;
+
+    case E_FnSymbol: {
+      FnSymbol* fn = toFnSymbol(ast);
+
+      check(fn->iteratorInfo       == NULL &&
+            fn->instantiatedFrom   == NULL &&
+            fn->instantiationPoint == NULL &&
+            fn->basicBlocks        == NULL &&
+            fn->calledBy           == NULL &&
+            fn->valueFunction      == NULL &&
+            fn->retSymbol          == NULL &&
+            fn->substitutions.n    == 0,
+            ast,
+            "function state set after parsing");
+
+      putSymbol(fn);
+      putList(fn->formals);
+      putRef(fn->retType);
+      putRef(fn->where);
+      putRef(fn->retExprType);
+      putRef(fn->body);
+      put(fn->thisTag);
+      put(fn->retTag);
+      putRef(fn->_this);
+      putRef(fn->_outer);
+      putString(fn->userString);
+      putString(fn->doc);
+      put(fn->numPreTupleFormals);
+      put(fn->throwsError());
+      break;
+    }
+
+    case E_EnumSymbol:
+      putSymbol(toSymbol(ast));
+      break;
+
+    case E_LabelSymbol:
+      check(toLabelSymbol(ast)->iterResumeGoto == NULL, ast, "resume goto");
+
+      putSymbol(toSymbol(ast));
+      break;
+
+    case E_SymExpr:
+      putRef(toSymExpr(ast)->symbol());
+      break;
+
+    case E_UnresolvedSymExpr:
+      break;
+
+    case E_DefExpr: {
+      DefExpr* def = toDefExpr(ast);
+
+      putRef(def->sym);
+      putRef(def->init);
+      putRef(def->exprType);
+      break;
+    }
+
+    case E_CallExpr: {
+      CallExpr* call = toCallExpr(ast);
+
+      putString(call->primitive != NULL ? call->primitive->name : NULL);
+      putRef(call->baseExpr);
+      putList(call->argList);
+      put(call->partialTag);
+      put(call->methodTag);
+      put(call->square);
+      break;
+    }
+
+    case E_ForallExpr: {
+      ForallExpr* fe = toForallExpr(ast);
+
+      putRef(fe->indices);
+      putRef(fe->iteratorExpr);
+      putRef(fe->expr);
+      putRef(fe->cond);
+      put(fe->maybeArrayType);
+      put(fe->zippered);
+      break;
+    }
+
+    case E_NamedExpr:
+      putRef(toNamedExpr(ast)->actual);
+      break;
+
+    case E_UseStmt: {
+      UseStmt* use = toUseStmt(ast);
+
+      check(use->relatedNames.size() == 0, ast, "use related names");
+
+      putRef(use->src);
+      putNames(use->named);
+      putRenames(use->renamed);
+      put(use->except);
+      break;
+    }
+
+    case E_BlockStmt:
+      putBlock(toBlockStmt(ast));
+      break;
+
+    case E_CondStmt: {
+      CondStmt* cond = toCondStmt(ast);
+
+      putRef(cond->condExpr);
+      putRef(cond->thenStmt);
+      putRef(cond->elseStmt);
+      break;
+    }
+
+    case E_GotoStmt:
+      putRef(toGotoStmt(ast)->label);
+      break;
+
+    case E_DeferStmt:
+      putRef(toDeferStmt(ast)->_body);
+      break;
+
+    case E_ForallIntent:
+      putRef(toForallIntent(ast)->fiVar);
+      putRef(toForallIntent(ast)->riSpec);
+      break;
+
+    case E_ForallStmt: {
+      ForallStmt* fs = toForallStmt(ast);
+
+      putList(fs->fIterVars);
+      putList(fs->fIterExprs);
+      putList(fs->fIntentVars);
+      putList(fs->fFIntents);
+      putRef(fs->fLoopBody);
+      break;
+    }
+
+    case E_TryStmt:
+      putRef(toTryStmt(ast)->_body);
+      putList(toTryStmt(ast)->_catches);
+      break;
+
+    case E_ForwardingStmt: {
+      ForwardingStmt*          fs = toForwardingStmt(ast);
+      std::vector<const char*> named(fs->named.begin(), fs->named.end());
+
+      putRef(fs->toFnDef);
+      putString(fs->fnReturningForwarding);
+      putRef(fs->type);
+      putNames(named);
+      putRenames(fs->renamed);
+      put(fs->except);
+      break;
+    }
+
+    case E_CatchStmt:
+      putRef(toCatchStmt(ast)->_body);
+      break;
+
+    case E_ExternBlockStmt:
+      break;
+
+    default:
+      fail(ast, "unsupported node type");
+      break;
+  }
+}
+
+static bool compareIds(BaseAST* a, BaseAST* b) {
+  return a->id < b->id;
+}
+
+bool ModuleCache::save(const char*                       path,
+                       const std::vector<ModuleSymbol*>& modules) {
+  std::vector<int32_t> payload;
+  CacheHeader          header;
+  uint64_t             sourceHash = 0;
+
+  for (size_t i = 0; i < modules.size(); i++) {
+    collect_asts(modules[i], mNodes);
+  }
+
+  std::sort(mNodes.begin(), mNodes.end(), compareIds);
+
+  for (size_t i = 0; i < mNodes.size(); i++) {
+    check(mNodeIds.count(mNodes[i]) == 0, mNodes[i], "shared node");
+
+    mNodeIds[mNodes[i]] = (int) i;
+  }
+
+  collectBuiltins();
+
+  // new_StringSymbol() adds each new literal to the end of the module
+  for (Expr* expr = (sLastLiteralDef != NULL) ?
+                    sLastLiteralDef->next   :
+                    stringLiteralModule->block->body.head;
+       expr != NULL;
+       expr = expr->next) {
+    DefExpr*   def = toDefExpr(expr);
+    VarSymbol* var = (def != NULL) ? toVarSymbol(def->sym) : NULL;
+
+    if (var != NULL && var->hasFlag(FLAG_CHAPEL_STRING_LITERAL) == true) {
+      mStringLiteralIds[var] = (int) mStringLiterals.size();
+
+      mStringLiterals.push_back(stringId(var->immediate->v_string));
+    }
+  }
+
+  for (size_t i = 0; i < mNodes.size(); i++) {
+    Type* type = toType(mNodes[i]);
+
+    check(type == NULL || type->symbol == NULL ||
+          mBuiltinIds.count(type->symbol) == 0,
+          mNodes[i],
+          "builtin type in the file");
+  }
+
+  for (size_t i = 0; i < mNodes.size(); i++) {
+    putEntry(mNodes[i], (int) i);
+  }
+
+  for (size_t i = 0; i < mNodes.size(); i++) {
+    putNode(mNodes[i]);
+  }
+
+  put((int32_t) sUses.size());
+
+  for (size_t i = 0; i < sUses.size(); i++) {
+    putString(sUses[i].first);
+    putRef(sUses[i].second);
+
+    check(sUses[i].second == NULL || mNodeIds.count(sUses[i].second) != 0,
+          sUses[i].second,
+          "use statement outside the file");
+  }
+
+  put((int32_t) modules.size());
+
+  for (size_t i = 0; i < modules.size(); i++) {
+    putRef(modules[i]);
+  }
+
+  for (size_t i = 0; i < mConfigs.size(); i++) {
+    check(getCmdLineConfig(mConfigs[i]) == NULL, NULL, "config set with -s");
+  }
+
+  check(hashFile(path, sourceHash), NULL, "unable to read source");
+
+  if (mFailure != NULL) {
+    return false;
+  }
+
+  // Assemble the payload
+  mOut = &payload;
+
+  for (int i = 0; i < NUM_PARSE_NAME_COUNTERS; i++) {
+    put(parseNameCounters[i] - sCountersAtStart[i]);
+  }
+
+  put((int32_t) mStrings.size());
+  payload.insert(payload.end(), mStringWords.begin(), mStringWords.end());
+
+  // The config names were interned while writing the nodes
+  put((int32_t) mConfigs.size());
+
+  for (size_t i = 0; i < mConfigs.size(); i++) {
+    put(mStringIds[mConfigs[i]]);
+  }
+
+  // Literals that the parse created but the AST no longer refers to
+  // must still be created when loading, so that they exist for later
+  // passes and are initialized in the same order.
+  put((int32_t) mStringLiterals.size());
+
+  for (size_t i = 0; i < mStringLiterals.size(); i++) {
+    put(mStringLiterals[i]);
+  }
+
+  put((int32_t) mExterns.size());
+  payload.insert(payload.end(), mExternWords.begin(), mExternWords.end());
+
+  put((int32_t) mNodes.size());
+  payload.insert(payload.end(), mTableWords.begin(), mTableWords.end());
+
+  payload.insert(payload.end(), mBodyWords.begin(), mBodyWords.end());
+
+  memcpy(header.magic, kMagic, sizeof(kMagic));
+
+  header.formatVersion = kFormatVersion;
+  header.payloadSize   = (uint32_t) payload.size();
+  header.configKey     = configKey();
+  header.sourceHash    = sourceHash;
+  header.payloadHash   = hashBytes(kHashSeed,
+                                   &payload[0],
+                                   payload.size() * sizeof(int32_t));
+
+  // Write to a temporary file and rename it so that a concurrent
+  // compile never sees a partial file.
+  const char* fileName = cacheFileName(path);
+  const char* tmpName  = astr(fileName, ".", istr((int) getpid()));
+  FILE*       fp       = NULL;
+  bool        ok       = false;
+
+  if (mkdir(moduleCacheDir, 0777) != 0 && errno != EEXIST) {
+    fail(NULL, "unable to create cache directory");
+
+  } else if ((fp = fopen(tmpName, "wb")) == NULL) {
+    fail(NULL, "unable to create cache file");
+
+  } else {
+    ok = fwrite(&header, sizeof(header), 1, fp) == 1 &&
+         fwrite(&payload[0], sizeof(int32_t), payload.size(), fp) ==
+           payload.size();
+
+    if (fclose(fp) != 0) {
+      ok = false;
+    }
+
+    if (ok == true) {
+      ok = rename(tmpName, fileName) == 0;
+    }
+
+    if (ok == false) {
+      unlink(tmpName);
+
+      fail(NULL, "unable to write cache file");
+    }
+  }
+
+  return ok;
+}
+
+/************************************* | **************************************
+*                                                                             *
+* Reading                                                                     *
+*                                                                             *
+************************************** | *************************************/
+
+int32_t ModuleCache::get() {
+  INT_ASSERT(mPos < mEnd);
+
+  return mIn[mPos++];
+}
+
+uint64_t ModuleCache::get64() {
+  uint64_t lo = (uint32_t) get();
+  uint64_t hi = (uint32_t) get();
+
+  return lo | (hi << 32);
+}
+
+std::string ModuleCache::getRaw() {
+  size_t len   = (size_t) get();
+  size_t words = (len + 3) / 4;
+
+  INT_ASSERT(mPos + words <= mEnd);
+
+  std::string retval((const char*) &mIn[mPos], len);
+
+  mPos = mPos + words;
+
+  return retval;
+}
+
+const char* ModuleCache::getString() {
+  int id = get();
+
+  INT_ASSERT(id >= 0 && id < (int) mStrings.size());
+
+  return mStrings[id];
+}
+
+BaseAST* ModuleCache::getRef() {
+  int      id     = get();
+  BaseAST* retval = NULL;
+
+  if (id > 0) {
+    INT_ASSERT(id <= (int) mNodes.size());
+
+    retval = mNodes[id - 1];
+
+  } else if (id < 0) {
+    INT_ASSERT(-id <= (int) mExterns.size());
+
+    retval = mExterns[-id - 1];
+  }
+
+  return retval;
+}
+
+void ModuleCache::getList(AList& list) {
+  int length = get();
+
+  for (int i = 0; i < length; i++) {
+    Expr* expr = toExpr(getRef());
+
+    INT_ASSERT(expr != NULL && expr->list == NULL);
+
+    // Link the node directly; AList::insertAtTail would flatten any
+    // PRIM_ACTUALS_LIST call that the parser left in the list.
+    expr->list = &list;
+    expr->prev = list.tail;
+    expr->next = NULL;
+
+    if (list.tail != NULL) {
+      list.tail->next = expr;
+    } else {
+      list.head = expr;
+    }
+
+    list.tail = expr;
+    list.length++;
+  }
+}
+
+void ModuleCache::getNames(std::vector<const char*>& names) {
+  int count = get();
+
+  for (int i = 0; i < count; i++) {
+    names.push_back(getString());
+  }
+}
+
+void ModuleCache::getRenames(std::map<const char*, const char*>& renames) {
+  int count = get();
+
+  for (int i = 0; i < count; i++) {
+    const char* from = getString();
+
+    renames[from] = getString();
+  }
+}
+
+void ModuleCache::readString() {
+  int kind = get();
+
+  if (kind == 0) {
+    mStrings.push_back(astr(getRaw()));
+
+  } else {
+    int         counter = get();
+    int         delta   = get();
+    std::string prefix  = getRaw();
+    std::string rest    = getRaw();
+
+    INT_ASSERT(counter >= 0 && counter < NUM_PARSE_NAME_COUNTERS);
+
+    mStrings.push_back(astr(prefix.c_str(),
+                            istr(parseNameCounters[counter] + delta),
+                            rest.c_str()));
+  }
+}
+
+BaseAST* ModuleCache::readExtern() {
+  int      kind   = get();
+  BaseAST* retval = NULL;
+
+  if (kind == EXT_ROOT_SYMBOL || kind == EXT_ROOT_TYPE) {
+    int         index = get();
+    const char* name  = getString();
+
+    if (index < (int) mBuiltins.size() &&
+        strcmp(mBuiltins[index]->name, name) == 0) {
+      if (kind == EXT_ROOT_SYMBOL) {
+        retval = mBuiltins[index];
+      } else {
+        retval = mBuiltins[index]->type;
+      }
+    }
+
+  } else if (kind == EXT_NEW_LITERAL) {
+    int index = get();
+
+    INT_ASSERT(index >= 0 && index < (int) mNewLiterals.size());
+
+    retval = mNewLiterals[index];
+
+  } else {
+    int constKind = get();
+
+    if (constKind == CONST_KIND_STRING) {
+      int         stringKind = get();
+      const char* str        = getString();
+
+      if (stringKind == STRING_KIND_STRING) {
+        retval = new_StringSymbol(str);
+      } else {
+        retval = new_CStringSymbol(str);
+      }
+
+    } else {
+      int numIndex = get();
+
+      switch (constKind) {
+        case NUM_KIND_INT:
+          retval = new_IntSymbol((int64_t) get64(), (IF1_int_type) numIndex);
+          break;
+
+        case NUM_KIND_UINT:
+          retval = new_UIntSymbol(get64(), (IF1_int_type) numIndex);
+          break;
+
+        case NUM_KIND_REAL:
+          retval = new_RealSymbol(getString(), (IF1_float_type) numIndex);
+          break;
+
+        case NUM_KIND_IMAG:
+          retval = new_ImagSymbol(getString(), (IF1_float_type) numIndex);
+          break;
+
+        default:
+          INT_FATAL("unexpected literal in module cache");
+          break;
+      }
+    }
+  }
+
+  return retval;
+}
+
+//
+// Construct node 'index' from its table entry.  Fields that the
+// constructor requires are filled with placeholders that getNode()
+// overwrites.
+//
+void ModuleCache::createNode(int index) {
+  int         tag      = get();
+  int         variant  = get();
+  int         lineno   = get();
+  const char* filename = getString();
+  int         a        = get();
+  int         b        = get();
+  int         c        = get();
+  BaseAST*    ast      = mNodes[index];
+
+  if (ast == NULL) {
+    switch (tag) {
+      case E_PrimitiveType:
+        ast = new PrimitiveType(NULL);
+        break;
+
+      case E_EnumType:
+        ast = new EnumType();
+        break;
+
+      case E_AggregateType: {
+        AggregateType* at = new AggregateType((AggregateTag) a);
+
+        if ((variant & kIsStringType) != 0) {
+          at = adoptStringType(at);
+        }
+
+        ast = at;
+        break;
+      }
+
+      case E_ModuleSymbol:
+        INT_ASSERT(b > 0 && b - 1 < index);
+
+        ast = new ModuleSymbol(mStrings[c],
+                               (ModTag) a,
+                               toBlockStmt(mNodes[b - 1]));
+        break;
+
+      case E_VarSymbol:
+        ast = new VarSymbol(mStrings[a]);
+        break;
+
+      case E_ArgSymbol:
+        ast = new ArgSymbol((IntentTag) a, mStrings[b], dtUnknown);
+        break;
+
+      case E_TypeSymbol: {
+        Type* type = NULL;
+
+        if (b > 0) {
+          INT_ASSERT(b - 1 < index);
+
+          type = toType(mNodes[b - 1]);
+        } else {
+          type = toType(mExterns[-b - 1]);
+        }
+
+        ast = new TypeSymbol(mStrings[a], type);
+        break;
+      }
+
+      case E_FnSymbol: {
+        FnSymbol* fn = new FnSymbol(mStrings[a]);
+
+        if ((variant & kReuseCtorBlock) != 0) {
+          mNodes[index + 1] = fn->body;
+        }
+
+        ast = fn;
+        break;
+      }
+
+      case E_EnumSymbol:
+        ast = new EnumSymbol(mStrings[a]);
+        break;
+
+      case E_LabelSymbol:
+        ast = new LabelSymbol(mStrings[a]);
+        break;
+
+      case E_SymExpr:
+        ast = new SymExpr(gNil);
+        break;
+
+      case E_UnresolvedSymExpr:
+        ast = new UnresolvedSymExpr(mStrings[a]);
+        break;
+
+      case E_DefExpr:
+        ast = new DefExpr();
+        break;
+
+      case E_CallExpr:
+        ast = new CallExpr(PRIM_NOOP);
+        break;
+
+      case E_ForallExpr:
+        ast = new ForallExpr(NULL, NULL, NULL, NULL, false, false);
+        break;
+
+      case E_NamedExpr:
+        ast = new NamedExpr(mStrings[a], NULL);
+        break;
+
+      case E_UseStmt:
+        ast = new UseStmt(mPlaceholderExpr);
+        break;
+
+      case E_BlockStmt:
+        switch (variant) {
+          case BK_BLOCK:
+            ast = new BlockStmt();
+            break;
+
+          case BK_WHILE_DO:
+            ast = new WhileDoStmt((Expr*) NULL, NULL);
+            break;
+
+          case BK_DO_WHILE:
+            ast = new DoWhileStmt((Expr*) NULL, NULL);
+            break;
+
+          case BK_FOR:
+            ast = new ForLoop();
+            break;
+
+          case BK_C_FOR:
+            ast = new CForLoop();
+            break;
+
+          case BK_PARAM_FOR:
+            ast = new ParamForLoop();
+            break;
+
+          default:
+            INT_FATAL("unexpected block kind in module cache");
+            break;
+        }
+        break;
+
+      case E_CondStmt:
+        ast = new CondStmt(mPlaceholderExpr, mPlaceholderBlock);
+        break;
+
+      case E_GotoStmt:
+        ast = new GotoStmt((GotoTag) a, mPlaceholderExpr);
+        break;
+
+      case E_DeferStmt:
+        ast = new DeferStmt(NULL);
+        break;
+
+      case E_ForallIntent:
+        ast = new ForallIntent((TFITag) a, mPlaceholderExpr);
+        break;
+
+      case E_ForallStmt:
+        ast = new ForallStmt(a != 0, NULL);
+        break;
+
+      case E_TryStmt:
+        ast = new TryStmt(a != 0, NULL, NULL);
+        break;
+
+      case E_ForwardingStmt:
+        ast = new ForwardingStmt(NULL);
+        break;
+
+      case E_CatchStmt: {
+        CatchStmt* cs = new CatchStmt(NULL, mPlaceholderBlock);
+
+        mPlaceholderBlock->remove();
+
+        if ((variant & kReuseCtorBlock) != 0) {
+          mNodes[index + 1] = cs->_body;
+        }
+
+        ast = cs;
+        break;
+      }
+
+      case E_ExternBlockStmt:
+        ast = new ExternBlockStmt(mStrings[a]);
+        break;
+
+      default:
+        INT_FATAL("unexpected node type in module cache");
+        break;
+    }
+
+    mNodes[index] = ast;
+  }
+
+  INT_ASSERT(ast->astTag == tag);
+
+  ast->astloc.lineno   = lineno;
+  ast->astloc.filename = filename;
+}
+
+void ModuleCache::getSymbol(Symbol* sym) {
+  int numFlags = 0;
+
+  sym->name  = getString();
+  sym->cname = getString();
+  sym->qual  = (Qualifier) get();
+  sym->type  = toType(getRef());
+
+  sym->flags.reset();
+
+  numFlags = get();
+
+  for (int i = 0; i < numFlags; i++) {
+    sym->flags.set(get());
+  }
+}
+
+void ModuleCache::getType(Type* type) {
+  int numMethods = 0;
+
+  type->defaultValue       = toSymbol(getRef());
+  type->isInternalType     = get() != 0;
+  type->hasGenericDefaults = get() != 0;
+
+  numMethods = get();
+
+  for (int i = 0; i < numMethods; i++) {
+    type->methods.add(toFnSymbol(getRef()));
+  }
+}
+
+void ModuleCache::getBlock(BlockStmt* block) {
+  block->blockTag  = (BlockTag) get();
+
+  getList(block->body);
+
+  block->userLabel = getString();
+
+  block->BlockStmt::blockInfoSet(toCallExpr(getRef()));
+
+  block->useList   = toCallExpr(getRef());
+  block->byrefVars = toCallExpr(getRef());
+
+  if (get() != 0) {
+    ForallIntents* fi      = new ForallIntents();
+    int            numVars = get();
+
+    for (int i = 0; i < numVars; i++) {
+      fi->fiVars.push_back(toExpr(getRef()));
+      fi->fIntents.push_back((TFITag) get());
+      fi->riSpecs.push_back(toExpr(getRef()));
+    }
+
+    fi->iterRec     = toSymExpr(getRef());
+    fi->leadIdx     = toSymExpr(getRef());
+    fi->leadIdxCopy = toSymExpr(getRef());
+
+    block->forallIntents = fi;
+  }
+
+  if (LoopStmt* loop = toLoopStmt(block)) {
+    loop->breakLabelSet(toLabelSymbol(getRef()));
+    loop->continueLabelSet(toLabelSymbol(getRef()));
+    loop->orderIndependentSet(get() != 0);
+  }
+
+  if (WhileStmt* loop = toWhileStmt(block)) {
+    loop->mCondExpr    = toExpr(getRef());
+
+  } else if (ForLoop* loop = toForLoop(block)) {
+    loop->mIndex       = toSymExpr(getRef());
+    loop->mIterator    = toSymExpr(getRef());
+    loop->mZippered    = get() != 0;
+
+  } else if (CForLoop* loop = toCForLoop(block)) {
+    loop->mInitClause  = toBlockStmt(getRef());
+    loop->mTestClause  = toBlockStmt(getRef());
+    loop->mIncrClause  = toBlockStmt(getRef());
+
+  } else if (ParamForLoop* loop = toParamForLoop(block)) {
+    loop->mResolveInfo = toCallExpr(getRef());
+  }
+}
+
+void ModuleCache::getNode(BaseAST* ast) {
+  switch (ast->astTag) {
+    case E_PrimitiveType:
+      getType(toType(ast));
+      break;
+
+    case E_EnumType: {
+      EnumType* et = toEnumType(ast);
+
+      getType(et);
+      getList(et->constants);
+
+      et->doc = getString();
+      break;
+    }
+
+    case E_AggregateType: {
+      AggregateType* at = toAggregateType(ast);
+
+      getType(at);
+
+      at->initializerStyle = (InitializerStyle) get();
+
+      getList(at->fields);
+      getList(at->inherits);
+      getList(at->forwardingTo);
+
+      at->outer = toSymbol(getRef());
+      at->doc   = getString();
+
+      if (get() != 0) {
+        at->markAsGeneric();
+      }
+      break;
+    }
+
+    case E_ModuleSymbol: {
+      ModuleSymbol* mod = toModuleSymbol(ast);
+
+      getSymbol(mod);
+
+      mod->filename = getString();
+      mod->doc      = getString();
+      break;
+    }
+
+    case E_VarSymbol: {
+      VarSymbol* var = toVarSymbol(ast);
+
+      getSymbol(var);
+
+      var->doc = getString();
+      break;
+    }
+
+    case E_ArgSymbol: {
+      ArgSymbol* arg = toArgSymbol(ast);
+
+      getSymbol(arg);
+
+      arg->intent       = (IntentTag) get();
+      arg->typeExpr     = toBlockStmt(getRef());
+      arg->defaultExpr  = toBlockStmt(getRef());
+      arg->variableExpr = toBlockStmt(getRef());
+      break;
+    }
+
+    case E_TypeSymbol:
+      getSymbol(toSymbol(ast));
+
+      toTypeSymbol(ast)->doc = getString();
+      break;
+
+    case E_FnSymbol: {
+      FnSymbol* fn = toFnSymbol(ast);
+
+      getSymbol(fn);
+      getList(fn->formals);
+
+      fn->retType            = toType(getRef());
+      fn->where              = toBlockStmt(getRef());
+      fn->retExprType        = toBlockStmt(getRef());
+      fn->body               = toBlockStmt(getRef());
+      fn->thisTag            = (IntentTag) get();
+      fn->retTag             = (RetTag) get();
+      fn->_this              = toSymbol(getRef());
+      fn->_outer             = toSymbol(getRef());
+      fn->userString         = getString();
+      fn->doc                = getString();
+      fn->numPreTupleFormals = get();
+
+      if (get() != 0) {
+        fn->throwsErrorInit();
+      }
+      break;
+    }
+
+    case E_EnumSymbol:
+    case E_LabelSymbol:
+      getSymbol(toSymbol(ast));
+      break;
+
+    case E_SymExpr:
+      toSymExpr(ast)->setSymbol(toSymbol(getRef()));
+      break;
+
+    case E_UnresolvedSymExpr:
+      break;
+
+    case E_DefExpr: {
+      DefExpr* def = toDefExpr(ast);
+
+      def->sym      = toSymbol(getRef());
+      def->init     = toExpr(getRef());
+      def->exprType = toExpr(getRef());
+
+      if (def->sym != NULL) {
+        def->sym->defPoint = def;
+      }
+      break;
+    }
+
+    case E_CallExpr: {
+      CallExpr*   call     = toCallExpr(ast);
+      const char* primName = getString();
+
+      call->primitive  = NULL;
+
+      if (primName != NULL) {
+        call->primitive = primitives_map.get(primName);
+
+        INT_ASSERT(call->primitive != NULL);
+      }
+
+      call->baseExpr   = toExpr(getRef());
+
+      getList(call->argList);
+
+      call->partialTag = get() != 0;
+      call->methodTag  = get() != 0;
+      call->square     = get() != 0;
+      break;
+    }
+
+    case E_ForallExpr: {
+      ForallExpr* fe = toForallExpr(ast);
+
+      fe->indices        = toExpr(getRef());
+      fe->iteratorExpr   = toExpr(getRef());
+      fe->expr           = toExpr(getRef());
+      fe->cond           = toExpr(getRef());
+      fe->maybeArrayType = get() != 0;
+      fe->zippered       = get() != 0;
+      break;
+    }
+
+    case E_NamedExpr:
+      toNamedExpr(ast)->actual = toExpr(getRef());
+      break;
+
+    case E_UseStmt: {
+      UseStmt* use = toUseStmt(ast);
+
+      use->src = toExpr(getRef());
+
+      getNames(use->named);
+      getRenames(use->renamed);
+
+      use->except = get() != 0;
+      break;
+    }
+
+    case E_BlockStmt:
+      getBlock(toBlockStmt(ast));
+      break;
+
+    case E_CondStmt: {
+      CondStmt* cond = toCondStmt(ast);
+
+      cond->condExpr = toExpr(getRef());
+      cond->thenStmt = toBlockStmt(getRef());
+      cond->elseStmt = toBlockStmt(getRef());
+      break;
+    }
+
+    case E_GotoStmt:
+      toGotoStmt(ast)->label = toExpr(getRef());
+      break;
+
+    case E_DeferStmt:
+      toDeferStmt(ast)->_body = toBlockStmt(getRef());
+      break;
+
+    case E_ForallIntent:
+      toForallIntent(ast)->fiVar  = toExpr(getRef());
+      toForallIntent(ast)->riSpec = toExpr(getRef());
+      break;
+
+    case E_ForallStmt: {
+      ForallStmt* fs = toForallStmt(ast);
+
+      getList(fs->fIterVars);
+      getList(fs->fIterExprs);
+      getList(fs->fIntentVars);
+      getList(fs->fFIntents);
+
+      fs->fLoopBody = toBlockStmt(getRef());
+      break;
+    }
+
+    case E_TryStmt:
+      toTryStmt(ast)->_body = toBlockStmt(getRef());
+
+      getList(toTryStmt(ast)->_catches);
+      break;
+
+    case E_ForwardingStmt: {
+      ForwardingStmt*          fs = toForwardingStmt(ast);
+      std::vector<const char*> named;
+
+      fs->toFnDef               = toDefExpr(getRef());
+      fs->fnReturningForwarding = getString();
+      fs->type                  = toType(getRef());
+
+      getNames(named);
+      getRenames(fs->renamed);
+
+      fs->named.insert(named.begin(), named.end());
+
+      fs->except                = get() != 0;
+      break;
+    }
+
+    case E_CatchStmt:
+      toCatchStmt(ast)->_body = toBlockStmt(getRef());
+      break;
+
+    case E_ExternBlockStmt:
+      break;
+
+    default:
+      INT_FATAL(ast, "unexpected node type in module cache");
+      break;
+  }
+}
+
+bool ModuleCache::load(const char*                 path,
+                       std::vector<ModuleSymbol*>& modules) {
+  const char*          fileName = cacheFileName(path);
+  FILE*                fp       = fopen(fileName, "rb");
+  CacheHeader          header;
+  std::vector<int32_t> payload;
+  uint64_t             sourceHash = 0;
+  int                  consumed[NUM_PARSE_NAME_COUNTERS];
+  int                  count    = 0;
+
+  if (fp == NULL) {
+    return false;
+  }
+
+  if (fread(&header, sizeof(header), 1, fp) != 1 ||
+      memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 ||
+      header.formatVersion != kFormatVersion ||
+      header.configKey     != configKey()) {
+    fclose(fp);
+    return false;
+  }
+
+  payload.resize(header.payloadSize);
+
+  if (header.payloadSize == 0 ||
+      fread(&payload[0], sizeof(int32_t), payload.size(), fp) !=
+        payload.size()) {
+    fclose(fp);
+    return false;
+  }
+
+  fclose(fp);
+
+  if (hashBytes(kHashSeed, &payload[0], payload.size() * sizeof(int32_t)) !=
+        header.payloadHash ||
+      hashFile(path, sourceHash) == false ||
+      sourceHash != header.sourceHash) {
+    return false;
+  }
+
+  mIn  = &payload[0];
+  mPos = 0;
+  mEnd = payload.size();
+
+  for (int i = 0; i < NUM_PARSE_NAME_COUNTERS; i++) {
+    consumed[i] = get();
+  }
+
+  count = get();
+
+  mStrings.push_back(NULL);
+
+  for (int i = 0; i < count; i++) {
+    readString();
+  }
+
+  // A config variable that is set on the command line changes the AST
+  count = get();
+
+  for (int i = 0; i < count; i++) {
+    if (getCmdLineConfig(getString()) != NULL) {
+      return false;
+    }
+  }
+
+  count = get();
+
+  for (int i = 0; i < count; i++) {
+    mNewLiterals.push_back(new_StringSymbol(getString()));
+  }
+
+  collectBuiltins();
+
+  count = get();
+
+  for (int i = 0; i < count; i++) {
+    BaseAST* ext = readExtern();
+
+    if (ext == NULL) {
+      return false;
+    }
+
+    mExterns.push_back(ext);
+  }
+
+  // From here on the file is known to be usable
+  mPlaceholderExpr  = new UnresolvedSymExpr("");
+  mPlaceholderBlock = new BlockStmt();
+
+  count = get();
+
+  mNodes.resize(count, NULL);
+
+  for (int i = 0; i < count; i++) {
+    createNode(i);
+  }
+
+  for (int i = 0; i < count; i++) {
+    getNode(mNodes[i]);
+  }
+
+  // AggregateType::addDeclaration() marks the fields of a type
+  for (int i = 0; i < count; i++) {
+    if (AggregateType* at = toAggregateType(mNodes[i])) {
+      for_alist(field, at->fields) {
+        if (DefExpr* def = toDefExpr(field)) {
+          if (VarSymbol* var = toVarSymbol(def->sym)) {
+            var->makeField();
+          }
+        }
+      }
+    }
+  }
+
+  count = get();
+
+  for (int i = 0; i < count; i++) {
+    const char* modName = getString();
+    UseStmt*    use     = toUseStmt(getRef());
+
+    addModuleToParseList(modName, use);
+  }
+
+  count = get();
+
+  for (int i = 0; i < count; i++) {
+    modules.push_back(toModuleSymbol(getRef()));
+  }
+
+  INT_ASSERT(mPos == mEnd);
+
+  for (int i = 0; i < NUM_PARSE_NAME_COUNTERS; i++) {
+    parseNameCounters[i] += consumed[i];
+  }
+
+  return true;
+}
+
+/************************************* | **************************************
+*                                                                             *
+* Entry points                                                                *
+*                                                                             *
+************************************** | *************************************/
+
+bool moduleCacheEnabled(ModTag modTag, bool namedOnCommandLine) {
+  return moduleCacheDir[0]  != '\0'                          &&
+         (modTag == MOD_INTERNAL || modTag == MOD_STANDARD) &&
+         namedOnCommandLine == false                         &&
+         fDocs              == false                         &&
+         configKey()        != 0;
+}
+
+bool moduleCacheLoad(const char*                 path,
+                     ModTag                      modTag,
+                     std::vector<ModuleSymbol*>& modules) {
+  ModuleCache cache;
+
+  INT_ASSERT(currentModuleType == modTag);
+
+  return cache.load(path, modules);
+}
+
+void moduleCacheBeginParse() {
+  sRecording     = true;
+  sUncacheable   = false;
+  sErrorsAtStart = numErrorsReported();
+
+  sLastLiteralDef = stringLiteralModule->block->body.tail;
+
+  sUses.clear();
+
+  for (int i = 0; i < NUM_PARSE_NAME_COUNTERS; i++) {
+    sCountersAtStart[i] = parseNameCounters[i];
+  }
+}
+
+void moduleCacheEndParse(const char*                       path,
+                         const std::vector<ModuleSymbol*>& modules) {
+  if (sRecording == true) {
+    sRecording = false;
+
+    if (sUncacheable == false && numErrorsReported() == sErrorsAtStart) {
+      ModuleCache cache;
+
+      if (cache.save(path, modules) == false && developer == true) {
+        fprintf(stderr, "module cache: not saving %s: %s\n",
+                cleanFilename(path), cache.failure());
+      }
+    }
+
+    sUses.clear();
+  }
+}
+
+void moduleCacheNoteUse(const char* modName, UseStmt* use) {
+  if (sRecording == true) {
+    sUses.push_back(std::make_pair(modName, use));
+  }
+}
+
+void moduleCacheNoteUncacheable() {
+  if (sRecording == true) {
+    sUncacheable = true;
+  }
+}
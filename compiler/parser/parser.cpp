@@ -29,6 +29,7 @@
 #include "files.h"
 #include "flex-chapel.h"
 #include "insertLineNumbers.h"
+#include "moduleCache.h"
 #include "stringutil.h"
 #include "symbol.h"
 #include "wellknown.h"
@@ -238,6 +239,8 @@ void addModuleToParseList(const char* name, UseStmt* useExpr) {
     sModNameSet.set_add(modName);
     sModNameList.add(modName);
   }
+
+  moduleCacheNoteUse(modName, useExpr);
 }
 
 /************************************* | **************************************
@@ -498,6 +501,8 @@ static ModuleSymbol* parseMod(const char* modName, bool isInternal) {
 
 static bool containsOnlyModules(BlockStmt* block, const char* path);
 static void addModuleToDoneList(ModuleSymbol* module);
+static void parseFileContents(FILE* fp, const char* path,
+                              bool namedOnCommandLine);
 
 static ModuleSymbol* parseFile(const char* path,
                                ModTag      modTag,
@@ -505,16 +510,11 @@ static ModuleSymbol* parseFile(const char* path,
   ModuleSymbol* retval = NULL;
 
   if (FILE* fp = openInputFile(path)) {
-    gFilenameLookup.push_back(path);
+    std::vector<ModuleSymbol*> modules;
+    bool                       useCache  = false;
+    bool                       fromCache = false;
 
-    // State for the lexer
-    int           lexerStatus  = 100;
-
-    // State for the parser
-    yypstate*     parser       = yypstate_new();
-    int           parserStatus = YYPUSH_MORE;
-    YYLTYPE       yylloc;
-    ParserContext context;
+    gFilenameLookup.push_back(path);
 
     currentFileNamedOnCommandLine = namedOnCommandLine;
 
@@ -524,11 +524,6 @@ static ModuleSymbol* parseFile(const char* path,
     yyfilename                    = path;
     yystartlineno                 = 1;
 
-    yylloc.first_line             = 1;
-    yylloc.first_column           = 0;
-    yylloc.last_line              = 1;
-    yylloc.last_column            = 0;
-
     chplLineno                    = 1;
 
     if (printModuleFiles && (modTag != MOD_INTERNAL || developer)) {
@@ -541,103 +536,134 @@ static ModuleSymbol* parseFile(const char* path,
       fprintf(stderr, "  %s\n", cleanFilename(path));
     }
 
-    if (namedOnCommandLine == true) {
-      startCountingFileTokens(path);
-    }
+    useCache  = moduleCacheEnabled(modTag, namedOnCommandLine);
+    fromCache = useCache && moduleCacheLoad(path, modTag, modules);
+
+    if (fromCache == true) {
+      closeInputFile(fp);
+
+    } else {
+      if (useCache == true) {
+        moduleCacheBeginParse();
+      }
 
-    yylex_init(&context.scanner);
+      parseFileContents(fp, path, namedOnCommandLine);
 
-    stringBufferInit();
+      if (yyblock == NULL) {
+        INT_FATAL("yyblock should always be non-NULL after yyparse()");
 
-    yyset_in(fp, context.scanner);
+      } else if (containsOnlyModules(yyblock, path) == true) {
+        for_alist(stmt, yyblock->body) {
+          if (DefExpr* defExpr = toDefExpr(stmt)) {
+            if (ModuleSymbol* modSym = toModuleSymbol(defExpr->sym)) {
+              defExpr->remove();
 
-    while (lexerStatus != 0 && parserStatus == YYPUSH_MORE) {
-      YYSTYPE yylval;
+              modules.push_back(modSym);
+            }
+          }
+        }
 
-      lexerStatus = yylex(&yylval, &yylloc, context.scanner);
+      } else {
+        const char*   modName = filenameToModulename(path);
+        ModuleSymbol* mod     = buildModule(modName,
+                                            modTag,
+                                            yyblock,
+                                            yyfilename,
+                                            false,
+                                            NULL);
 
-      if        (lexerStatus >= 0) {
-        parserStatus          = yypush_parse(parser,
-                                             lexerStatus,
-                                             &yylval,
-                                             &yylloc,
-                                             &context);
+        mod->addFlag(FLAG_IMPLICIT_MODULE);
 
-      } else if (lexerStatus == YYLEX_BLOCK_COMMENT) {
-        context.latestComment = yylval.pch;
+        modules.push_back(mod);
       }
     }
 
-    if (namedOnCommandLine == true) {
-      stopCountingFileTokens(context.scanner);
+    for_vector(ModuleSymbol, mod, modules) {
+      ModuleSymbol::addTopLevelModule(mod);
+
+      addModuleToDoneList(mod);
     }
 
-    // Cleanup after the parser
-    yypstate_delete(parser);
+    if (modules.size() == 1) {
+      retval = modules[0];
+    }
 
-    // Cleanup after the lexer
-    yylex_destroy(context.scanner);
+    if (useCache == true && fromCache == false) {
+      moduleCacheEndParse(path, modules);
+    }
 
-    closeInputFile(fp);
+    yyfilename                    =  NULL;
 
-    if (yyblock == NULL) {
-      INT_FATAL("yyblock should always be non-NULL after yyparse()");
+    yystartlineno                 =    -1;
+    chplLineno                    =    -1;
 
-    } else if (containsOnlyModules(yyblock, path) == true) {
-      ModuleSymbol* moduleLast  = 0;
-      int           moduleCount = 0;
+    currentFileNamedOnCommandLine = false;
 
-      for_alist(stmt, yyblock->body) {
-        if (DefExpr* defExpr = toDefExpr(stmt)) {
-          if (ModuleSymbol* modSym = toModuleSymbol(defExpr->sym)) {
+  } else {
+    fprintf(stderr,
+            "ParseFile: Unable to open \"%s\" for reading\n",
+            path);
+  }
 
-            defExpr->remove();
+  return retval;
+}
 
-            ModuleSymbol::addTopLevelModule(modSym);
+// Lex and parse 'fp' into yyblock, then close it
+static void parseFileContents(FILE*       fp,
+                              const char* path,
+                              bool        namedOnCommandLine) {
+  // State for the lexer
+  int           lexerStatus  = 100;
 
-            addModuleToDoneList(modSym);
+  // State for the parser
+  yypstate*     parser       = yypstate_new();
+  int           parserStatus = YYPUSH_MORE;
+  YYLTYPE       yylloc;
+  ParserContext context;
+
+  yylloc.first_line             = 1;
+  yylloc.first_column           = 0;
+  yylloc.last_line              = 1;
+  yylloc.last_column            = 0;
+
+  if (namedOnCommandLine == true) {
+    startCountingFileTokens(path);
+  }
 
-            moduleLast  = modSym;
-            moduleCount = moduleCount + 1;
-          }
-        }
-      }
+  yylex_init(&context.scanner);
 
-      if (moduleCount == 1) {
-        retval = moduleLast;
-      }
+  stringBufferInit();
 
-    } else {
-      const char* modName = filenameToModulename(path);
+  yyset_in(fp, context.scanner);
 
-      retval = buildModule(modName, modTag, yyblock, yyfilename, false, NULL);
+  while (lexerStatus != 0 && parserStatus == YYPUSH_MORE) {
+    YYSTYPE yylval;
 
-      ModuleSymbol::addTopLevelModule(retval);
+    lexerStatus = yylex(&yylval, &yylloc, context.scanner);
 
-      retval->addFlag(FLAG_IMPLICIT_MODULE);
+    if        (lexerStatus >= 0) {
+      parserStatus          = yypush_parse(parser,
+                                           lexerStatus,
+                                           &yylval,
+                                           &yylloc,
+                                           &context);
 
-      addModuleToDoneList(retval);
+    } else if (lexerStatus == YYLEX_BLOCK_COMMENT) {
+      context.latestComment = yylval.pch;
     }
+  }
 
-    yyfilename                    =  NULL;
-
-    yylloc.first_line             =    -1;
-    yylloc.first_column           =     0;
-    yylloc.last_line              =    -1;
-    yylloc.last_column            =     0;
-
-    yystartlineno                 =    -1;
-    chplLineno                    =    -1;
+  if (namedOnCommandLine == true) {
+    stopCountingFileTokens(context.scanner);
+  }
 
-    currentFileNamedOnCommandLine = false;
+  // Cleanup after the parser
+  yypstate_delete(parser);
 
-  } else {
-    fprintf(stderr,
-            "ParseFile: Unable to open \"%s\" for reading\n",
-            path);
-  }
+  // Cleanup after the lexer
+  yylex_destroy(context.scanner);
 
-  return retval;
+  closeInputFile(fp);
 }
 
 static bool containsOnlyModules(BlockStmt* block, const char* path) {
@@ -29,6 +29,7 @@
 #include "driver.h"
 #include "ForallStmt.h"
 #include "initializerRules.h"
+#include "optimizations.h"
 #include "stlUtil.h"
 #include "stringutil.h"
 #include "TransformLogicalShortCircuit.h"
@@ -133,6 +134,8 @@ void normalize() {
 
   handleReduceAssign();
 
+  autoLocalAccess();
+
   forv_Vec(AggregateType, at, gAggregateTypes) {
     if (isClassWithInitializers(at)  == true ||
         isRecordWithInitializers(at) == true) {
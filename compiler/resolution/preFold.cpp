@@ -781,8 +781,12 @@ Expr* preFold(CallExpr* call) {
       result = new SymExpr(gFalse);
     }
 
-    // remove the call from the AST
-    tryCall->remove();
+    // remove the call from the AST, along with the ContextCallExpr that
+    // resolution moves it into when it has ref and value overloads
+    if (ContextCallExpr* contextCall = toContextCallExpr(tryCall->parentExpr))
+      contextCall->remove();
+    else
+      tryCall->remove();
 
     call->replace(result);
 
@@ -1249,6 +1249,19 @@ void runClang(const char* just_parse_filename) {
   compileline += " COMP_GEN_OPT="; compileline += istr(optimizeCCode);
   compileline += " COMP_GEN_SPECIALIZE="; compileline += istr(specializeCCode);
   compileline += " COMP_GEN_FLOAT_OPT="; compileline += istr(ffloatOpt);
+  compileline += " COMP_GEN_LTO="; compileline += istr(fLinkTimeOpt);
+  if (fPgoGenerate) {
+    compileline += " COMP_GEN_PGO_GEN_DIR="; compileline += pgoGenerateDir();
+  }
+  if (fPgoUseDir[0]) {
+    compileline += " COMP_GEN_PGO_USE_DIR="; compileline += fPgoUseDir;
+  }
+
+  if (llvmCodegen && fPgoUseDir[0] && !just_parse_filename) {
+    // clang reads a single merged profile, so merge the locales' ones now
+    std::string merge = compileline + " --llvm --pgo-merge";
+    mysystem(merge.c_str(), "merging PGO profiles");
+  }
 
   std::string readargsfrom;
 
@@ -2094,6 +2107,11 @@ void makeBinaryLLVM(void) {
     llvm::cl::ParseCommandLineOptions(Args.size()-1, &Args[0]);
   }
 
+  // With --lto, leave bitcode in the module's .o file so that the
+  // linker can optimize it together with the runtime's bitcode.
+  BackendAction backendAction = fLinkTimeOpt ? Backend_EmitBC
+                                             : Backend_EmitObj;
+
   // Note that EmitBackendOutput, when creating a .bc file,
   // does *not* run vectorization. We confirmed this with clang 3.7
   // with --save-temps (the resulting .bc file does not contain vector IR
@@ -2116,7 +2134,7 @@ void makeBinaryLLVM(void) {
                     info->Ctx->getTargetInfo().getTargetDescription(),
 #endif
 #endif
-                    info->module, Backend_EmitObj,
+                    info->module, backendAction,
 #if HAVE_LLVM_VER >= 39
                     llvm::make_unique<llvm::raw_fd_ostream>(
                                                  moduleFilename,
@@ -2218,10 +2236,12 @@ void makeBinaryLLVM(void) {
   options += " ";
   options += ldflags;
 
-  // We may need to add the -pthread flag here for the link step
-  // if we start doing link-time optimization.  For now, leave it
-  // out because its unnecessary inclusion causes a warning message
-  // on Macs.
+  // Link-time optimization compiles the runtime's bitcode during this
+  // step, so it needs the -pthread flag the runtime was compiled with.
+  // Otherwise leave it out because its unnecessary inclusion causes a
+  // warning message on Macs.
+  if (fLinkTimeOpt)
+    options += " -pthread";
 
   // Now, if we're doing a multilocale build, we have to make a launcher.
   // For this reason, we create a makefile. codegen_makefile
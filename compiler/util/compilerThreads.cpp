@@ -0,0 +1,131 @@
+/*
+ * Copyright 2004-2017 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "compilerThreads.h"
+
+#include "baseAST.h"
+#include "driver.h"
+#include "misc.h"
+#include "stmt.h"
+
+#include <vector>
+
+bool inParallelRegion = false;
+
+CompilerMutex::CompilerMutex() {
+  pthread_mutex_init(&mMutex, NULL);
+}
+
+CompilerMutex::~CompilerMutex() {
+  pthread_mutex_destroy(&mMutex);
+}
+
+void CompilerMutex::lock() {
+  pthread_mutex_lock(&mMutex);
+}
+
+void CompilerMutex::unlock() {
+  pthread_mutex_unlock(&mMutex);
+}
+
+#ifdef HAVE_COMPILER_THREADS
+
+//
+// Functions are handed out one at a time from a shared index, since
+// the cost of a pass varies widely from function to function.
+//
+struct FnWorkList {
+  FnWorkList(Vec<FnSymbol*>& fnsArg, void (*bodyArg)(FnSymbol*)) :
+    fns(fnsArg), body(bodyArg), next(0), astloc(currentAstLoc) { }
+
+  Vec<FnSymbol*>&   fns;
+  void            (*body)(FnSymbol*);
+
+  CompilerMutex     mutex;
+  int               next;
+
+  astlocT           astloc;
+  Vec<LabelSymbol*> removedLabels;
+};
+
+static void runFnWorkList(FnWorkList* work) {
+  while (true) {
+    int i = 0;
+
+    work->mutex.lock();
+    i = work->next++;
+    work->mutex.unlock();
+
+    if (i >= work->fns.n)
+      break;
+
+    work->body(work->fns.v[i]);
+  }
+}
+
+static void* fnWorker(void* arg) {
+  FnWorkList* work = (FnWorkList*) arg;
+
+  currentAstLoc = work->astloc;
+
+  runFnWorkList(work);
+
+  // leave any labels this thread removed for the main thread
+  work->mutex.lock();
+  work->removedLabels.append(removedIterResumeLabels);
+  work->mutex.unlock();
+
+  return NULL;
+}
+
+#endif
+
+void forEachFnInParallel(Vec<FnSymbol*>& fns, void (*body)(FnSymbol* fn)) {
+#ifdef HAVE_COMPILER_THREADS
+  int numThreads = (fCompilerThreads < fns.n) ? fCompilerThreads : fns.n;
+
+  if (numThreads > 1 && inParallelRegion == false) {
+    FnWorkList             work(fns, body);
+    std::vector<pthread_t> workers(numThreads - 1);
+
+    inParallelRegion = true;
+
+    for (size_t i = 0; i < workers.size(); i++) {
+      if (pthread_create(&workers[i], NULL, fnWorker, &work) != 0)
+        INT_FATAL("unable to start compiler thread");
+    }
+
+    runFnWorkList(&work);
+
+    for (size_t i = 0; i < workers.size(); i++) {
+      pthread_join(workers[i], NULL);
+    }
+
+    inParallelRegion = false;
+
+    removedIterResumeLabels.append(work.removedLabels);
+
+    return;
+  }
+#endif
+
+  forv_Vec(FnSymbol, fn, fns) {
+    body(fn);
+  }
+}
@@ -570,6 +570,19 @@ void genIncludeCommandLineHeaders(FILE* outfile) {
 }
 
 
+// Directory that a --pgo-generate executable writes its profile to:
+// <executable>.pgo, made absolute so that the program can be run from
+// any directory and on every locale.
+const char* pgoGenerateDir() {
+  const char* dir = astr(executableFilename, ".pgo");
+
+  if (dir[0] != '/')
+    dir = astr(getCwd(), "/", dir);
+
+  return dir;
+}
+
+
 void codegen_makefile(fileinfo* mainfile, const char** tmpbinname, bool skip_compile_link, const std::vector<const char*>& splitFiles) {
   fileinfo makefile;
   openCFile(&makefile, "Makefile");
@@ -626,6 +639,11 @@ void codegen_makefile(fileinfo* mainfile, const char** tmpbinname, bool skip_com
   fprintf(makefile.fptr, "COMP_GEN_OPT = %i\n", optimizeCCode);
   fprintf(makefile.fptr, "COMP_GEN_SPECIALIZE = %i\n", specializeCCode);
   fprintf(makefile.fptr, "COMP_GEN_FLOAT_OPT = %i\n", ffloatOpt);
+  fprintf(makefile.fptr, "COMP_GEN_LTO = %i\n", fLinkTimeOpt);
+  if (fPgoGenerate)
+    fprintf(makefile.fptr, "COMP_GEN_PGO_GEN_DIR = %s\n", pgoGenerateDir());
+  if (fPgoUseDir[0])
+    fprintf(makefile.fptr, "COMP_GEN_PGO_USE_DIR = %s\n", fPgoUseDir);
 
   fprintf(makefile.fptr, "COMP_GEN_USER_CFLAGS =");
 
@@ -50,6 +50,7 @@ static int         err_fatal        =    0;
 static int         err_user         =    0;
 static int         err_print        =    0;
 static int         err_ignore       =    0;
+static int         err_reported     =    0;
 
 static FnSymbol*   err_fn           = NULL;
 
@@ -70,6 +71,12 @@ void setupError(const char* filename, int lineno, int tag) {
 
   exit_immediately  = tag == 1 || tag == 2;
   exit_eventually  |= tag == 3;
+
+  err_reported++;
+}
+
+int numErrorsReported() {
+  return err_reported;
 }
 
 bool forceWidePtrsForLocal() {
@@ -587,6 +594,10 @@ void clean_exit(int status) {
 
   cleanup_for_exit();
 
+  if (status == 0) {
+    astrBenchmarkFinish();
+  }
+
   deleteStrings();
 
   exit(status);
@@ -23,88 +23,260 @@
 
 #include "stringutil.h"
 
+#include "compilerThreads.h"
+#include "driver.h"
 #include "map.h"
 #include "misc.h"
+#include "timer.h"
 
 #include <algorithm>
 #include <climits>
+#include <cstring>
 #include <functional>
+#include <set>
 #include <sstream>
+#include <vector>
 
 #include <inttypes.h>
 
-static ChainHashMap<const char*, StringHashFns, const char*> chapelStringsTable;
+//
+// The astr() table
+// ----------------
+//
+// Interned strings are kept in an open-addressing (linear probing)
+// hash table that is split into shards by the top bits of each
+// string's hash.  A shard has its own lock, which is only taken while
+// compiler threads are running, and its own arena of string storage,
+// so interning a new string costs a probe and a bump allocation.
+//
+// The shards are plain structs that are valid when zero-filled, so the
+// table works no matter when astr() is first called.
+//
 
-static const char*
-canonicalize_string(const char *s) {
-  const char* ss = chapelStringsTable.get(s);
-  if (!ss) {
-    chapelStringsTable.put(s, s);
-    return s;
+static const int          kAstrShardBits  = 4;
+static const int          kAstrNumShards  = 1 << kAstrShardBits;
+static const size_t       kAstrMinSlots   = 256;
+static const size_t       kAstrChunkSize  = 64 * 1024;
+
+struct AstrSlot {
+  unsigned int hash;
+  unsigned int length;
+  const char*  str;                    // NULL for an empty slot
+};
+
+struct AstrChunk {
+  AstrChunk*   next;
+  size_t       used;
+  size_t       size;
+};
+
+struct AstrShard {
+  AstrSlot*    slots;
+  size_t       numSlots;               // 0 or a power of 2
+  size_t       numStrings;
+  AstrChunk*   chunks;                 // the first chunk is being filled
+};
+
+static AstrShard                 astrShards[kAstrNumShards];
+static CompilerMutex             astrShardMutexes[kAstrNumShards];
+
+// --astr-benchmark records every string that astr() returns
+static std::vector<const char*>* astrTrace = NULL;
+static CompilerMutex             astrTraceMutex;
+
+// FNV-1a
+static inline unsigned int astrHash(const char* s, size_t len) {
+  unsigned int hash = 2166136261u;
+
+  for (size_t i = 0; i < len; i++) {
+    hash ^= (unsigned char) s[i];
+    hash *= 16777619u;
   }
-  return ss;
+
+  return hash;
+}
+
+static inline int astrShardIndex(unsigned int hash) {
+  return hash >> (32 - kAstrShardBits);
+}
+
+static char* astrAllocate(AstrShard* shard, size_t size) {
+  AstrChunk* chunk = shard->chunks;
+
+  if (chunk == NULL || chunk->used + size > chunk->size) {
+    // long strings get a chunk of their own behind the current one
+    bool   own       = size > kAstrChunkSize / 4;
+    size_t chunkSize = own ? size : kAstrChunkSize;
+
+    AstrChunk* fresh = (AstrChunk*) malloc(sizeof(AstrChunk) + chunkSize);
+
+    if (fresh == NULL)
+      INT_FATAL("out of memory interning a string");
+
+    fresh->used = 0;
+    fresh->size = chunkSize;
+
+    if (own == true && chunk != NULL) {
+      fresh->next = chunk->next;
+      chunk->next = fresh;
+    } else {
+      fresh->next   = chunk;
+      shard->chunks = fresh;
+    }
+
+    chunk = fresh;
+  }
+
+  char* retval = (char*) (chunk + 1) + chunk->used;
+
+  chunk->used += size;
+
+  return retval;
+}
+
+static void astrGrow(AstrShard* shard) {
+  size_t    numSlots = (shard->numSlots == 0) ? kAstrMinSlots :
+                                                shard->numSlots * 2;
+  size_t    mask     = numSlots - 1;
+  AstrSlot* slots    = (AstrSlot*) calloc(numSlots, sizeof(AstrSlot));
+
+  if (slots == NULL)
+    INT_FATAL("out of memory interning a string");
+
+  for (size_t i = 0; i < shard->numSlots; i++) {
+    AstrSlot& slot = shard->slots[i];
+
+    if (slot.str != NULL) {
+      size_t j = slot.hash & mask;
+
+      while (slots[j].str != NULL)
+        j = (j + 1) & mask;
+
+      slots[j] = slot;
+    }
+  }
+
+  free(shard->slots);
+
+  shard->slots    = slots;
+  shard->numSlots = numSlots;
+}
+
+static const char* astrShardIntern(AstrShard*   shard,
+                                   const char*  s,
+                                   size_t       len,
+                                   unsigned int hash) {
+  // keep the load factor at or below 3/4
+  if ((shard->numStrings + 1) * 4 > shard->numSlots * 3)
+    astrGrow(shard);
+
+  size_t mask = shard->numSlots - 1;
+  size_t i    = hash & mask;
+
+  while (shard->slots[i].str != NULL) {
+    AstrSlot& slot = shard->slots[i];
+
+    if (slot.hash                    == hash &&
+        slot.length                  == len  &&
+        memcmp(slot.str, s, len)     == 0)
+      return slot.str;
+
+    i = (i + 1) & mask;
+  }
+
+  char* copy = astrAllocate(shard, len + 1);
+
+  memcpy(copy, s, len);
+  copy[len] = '\0';
+
+  shard->slots[i].hash   = hash;
+  shard->slots[i].length = (unsigned int) len;
+  shard->slots[i].str    = copy;
+
+  shard->numStrings++;
+
+  return copy;
+}
+
+static void astrShardDestroy(AstrShard* shard) {
+  AstrChunk* chunk = shard->chunks;
+
+  while (chunk != NULL) {
+    AstrChunk* next = chunk->next;
+
+    free(chunk);
+
+    chunk = next;
+  }
+
+  free(shard->slots);
+
+  memset(shard, 0, sizeof(AstrShard));
+}
+
+static const char* internString(AstrShard*     shards,
+                                CompilerMutex* mutexes,
+                                const char*    s,
+                                size_t         len) {
+  unsigned int hash  = astrHash(s, len);
+  int          index = astrShardIndex(hash);
+
+  ParallelLockGuard guard(mutexes[index]);
+
+  return astrShardIntern(&shards[index], s, len, hash);
+}
+
+static const char* internString(const char* s, size_t len) {
+  const char* retval = internString(astrShards, astrShardMutexes, s, len);
+
+  if (astrTrace != NULL) {
+    ParallelLockGuard guard(astrTraceMutex);
+
+    astrTrace->push_back(retval);
+  }
+
+  return retval;
 }
 
 const char*
 astr(const char* s1, const char* s2, const char* s3, const char* s4,
      const char* s5, const char* s6, const char* s7, const char* s8) {
-  int len;
-  len = strlen(s1);
-  if (s2)
-    len += strlen(s2);
-  if (s3)
-    len += strlen(s3);
-  if (s4)
-    len += strlen(s4);
-  if (s5)
-    len += strlen(s5);
-  if (s6)
-    len += strlen(s6);
-  if (s7)
-    len += strlen(s7);
-  if (s8)
-    len += strlen(s8);
-  char* s = (char*)malloc(len+1);
-  strcpy(s, s1);
-  if (s2)
-    strcat(s, s2);
-  if (s3)
-    strcat(s, s3);
-  if (s4)
-    strcat(s, s4);
-  if (s5)
-    strcat(s, s5);
-  if (s6)
-    strcat(s, s6);
-  if (s7)
-    strcat(s, s7);
-  if (s8)
-    strcat(s, s8);
-  const char* t = canonicalize_string(s);
-  if (s != t)
+  const char* parts[8] = { s1, s2, s3, s4, s5, s6, s7, s8 };
+  size_t      lens[8]  = { 0 };
+  size_t      len      = 0;
+
+  for (int i = 0; i < 8 && parts[i] != NULL; i++) {
+    lens[i]  = strlen(parts[i]);
+    len     += lens[i];
+  }
+
+  char  buffer[256];
+  char* s   = (len < sizeof(buffer)) ? buffer : (char*) malloc(len + 1);
+  char* end = s;
+
+  for (int i = 0; i < 8 && parts[i] != NULL; i++) {
+    memcpy(end, parts[i], lens[i]);
+    end += lens[i];
+  }
+
+  *end = '\0';
+
+  const char* t = internString(s, len);
+
+  if (s != buffer)
     free(s);
+
   return t;
 }
 
 const char* astr(const char* s1)
 {
-  const char* ss = chapelStringsTable.get(s1);
-  if (ss)
-    // return an existing entry
-    return ss;
-
-  // add a new entry - always a fresh malloc
-  int len;
-  len = strlen(s1);
-  char* s = (char*)malloc(len+1);
-  strcpy(s, s1);
-  chapelStringsTable.put(s,s);
-  return s;
+  return internString(s1, strlen(s1));
 }
 
 const char* astr(const std::string& s)
 {
-  return astr(s.c_str());
+  return internString(s.c_str(), s.length());
 }
 
 const char*
@@ -121,21 +293,206 @@ istr(int i) {
 // note: e must be in s
 //
 const char* asubstr(const char* s, const char* e) {
-  char* ss = (char*)malloc(e-s+1);
-  strncpy(ss, s, e-s);
-  ss[e-s] = '\0';
-  const char* t = canonicalize_string(ss);
-  if (ss != t)
-    free(ss);
-  return t;
+  return internString(s, e - s);
 }
 
 
 void deleteStrings() {
-  Vec<const char*> keys;
-  chapelStringsTable.get_keys(keys);
-  forv_Vec(const char, key, keys) {
-    free(const_cast<char*>(key));
+  for (int i = 0; i < kAstrNumShards; i++) {
+    astrShardDestroy(&astrShards[i]);
+  }
+}
+
+
+/************************************* | **************************************
+*                                                                             *
+* --astr-benchmark                                                            *
+*                                                                             *
+* Record the strings interned by this compilation, then time interning the   *
+* same stream into an empty table and looking it up again, both for the      *
+* astr() table and for the chained hash table that astr() used to use.      *
+*                                                                             *
+************************************** | *************************************/
+
+static const int kAstrLookupPasses = 10;
+
+void astrBenchmarkStart() {
+  astrTrace = new std::vector<const char*>();
+}
+
+static double mstringsPerSec(size_t count, const Timer& timer) {
+  double secs = timer.elapsedSecs();
+
+  return (secs > 0.0) ? (count / secs) / 1.0e6 : 0.0;
+}
+
+static void benchmarkChainedTable(const std::vector<const char*>& stream,
+                                  Timer&                          insert,
+                                  Timer&                          lookup) {
+  ChainHashMap<const char*, StringHashFns, const char*> table;
+  Vec<const char*>                                       copies;
+
+  insert.start();
+
+  for (size_t i = 0; i < stream.size(); i++) {
+    if (table.get(stream[i]) == NULL) {
+      char* copy = strdup(stream[i]);
+
+      table.put(copy, copy);
+      copies.add(copy);
+    }
+  }
+
+  insert.stop();
+
+  lookup.start();
+
+  for (int pass = 0; pass < kAstrLookupPasses; pass++) {
+    for (size_t i = 0; i < stream.size(); i++) {
+      table.get(stream[i]);
+    }
+  }
+
+  lookup.stop();
+
+  forv_Vec(const char, copy, copies) {
+    free(const_cast<char*>(copy));
+  }
+}
+
+struct AstrBenchmarkTable {
+  AstrShard     shards[kAstrNumShards];
+  CompilerMutex mutexes[kAstrNumShards];
+
+  AstrBenchmarkTable() {
+    memset(shards, 0, sizeof(shards));
+  }
+
+  ~AstrBenchmarkTable() {
+    for (int i = 0; i < kAstrNumShards; i++)
+      astrShardDestroy(&shards[i]);
+  }
+
+  void internAll(const std::vector<const char*>& stream, size_t first) {
+    size_t n = stream.size();
+
+    for (size_t k = 0; k < n; k++) {
+      const char* s = stream[(first + k) % n];
+
+      internString(shards, mutexes, s, strlen(s));
+    }
+  }
+};
+
+static void benchmarkShardedTable(const std::vector<const char*>& stream,
+                                  Timer&                          insert,
+                                  Timer&                          lookup) {
+  AstrBenchmarkTable table;
+
+  insert.start();
+  table.internAll(stream, 0);
+  insert.stop();
+
+  lookup.start();
+
+  for (int pass = 0; pass < kAstrLookupPasses; pass++)
+    table.internAll(stream, 0);
+
+  lookup.stop();
+}
+
+struct AstrBenchmarkThread {
+  AstrBenchmarkTable*             table;
+  const std::vector<const char*>* stream;
+  size_t                          first;
+};
+
+static void* benchmarkThread(void* arg) {
+  AstrBenchmarkThread* thread = (AstrBenchmarkThread*) arg;
+
+  thread->table->internAll(*thread->stream, thread->first);
+
+  return NULL;
+}
+
+// each thread interns the whole stream, starting at a different place
+static void benchmarkConcurrent(const std::vector<const char*>& stream,
+                                int                             numThreads,
+                                Timer&                          timer) {
+  AstrBenchmarkTable               table;
+  std::vector<pthread_t>           threads(numThreads);
+  std::vector<AstrBenchmarkThread> args(numThreads);
+
+  inParallelRegion = true;
+
+  timer.start();
+
+  for (int i = 0; i < numThreads; i++) {
+    args[i].table  = &table;
+    args[i].stream = &stream;
+    args[i].first  = (stream.size() * i) / numThreads;
+
+    if (pthread_create(&threads[i], NULL, benchmarkThread, &args[i]) != 0)
+      INT_FATAL("unable to start benchmark thread");
+  }
+
+  for (int i = 0; i < numThreads; i++)
+    pthread_join(threads[i], NULL);
+
+  timer.stop();
+
+  inParallelRegion = false;
+}
+
+void astrBenchmarkFinish() {
+  if (astrTrace == NULL)
+    return;
+
+  std::vector<const char*> stream;
+  std::set<const char*>    distinct;
+  size_t                   chars = 0;
+
+  stream.swap(*astrTrace);
+
+  delete astrTrace;
+  astrTrace = NULL;
+
+  for (size_t i = 0; i < stream.size(); i++) {
+    distinct.insert(stream[i]);
+    chars += strlen(stream[i]);
+  }
+
+  size_t lookups = stream.size() * kAstrLookupPasses;
+
+  Timer  chainedInsert, chainedLookup, shardedInsert, shardedLookup;
+
+  benchmarkChainedTable(stream, chainedInsert, chainedLookup);
+  benchmarkShardedTable(stream, shardedInsert, shardedLookup);
+
+  fprintf(stderr, "astr benchmark: %lu calls, %lu distinct strings, "
+                  "%.1f chars per call\n",
+          (unsigned long) stream.size(),
+          (unsigned long) distinct.size(),
+          stream.size() > 0 ? (double) chars / stream.size() : 0.0);
+
+  fprintf(stderr, "  %-24s %12s %12s\n", "table", "intern M/s", "lookup M/s");
+
+  fprintf(stderr, "  %-24s %12.2f %12.2f\n", "chained (old)",
+          mstringsPerSec(stream.size(), chainedInsert),
+          mstringsPerSec(lookups,       chainedLookup));
+
+  fprintf(stderr, "  %-24s %12.2f %12.2f\n", "open addressing",
+          mstringsPerSec(stream.size(), shardedInsert),
+          mstringsPerSec(lookups,       shardedLookup));
+
+  if (fCompilerThreads > 1) {
+    Timer concurrent;
+
+    benchmarkConcurrent(stream, fCompilerThreads, concurrent);
+
+    fprintf(stderr, "  open addressing, %2d threads %8.2f\n",
+            fCompilerThreads,
+            mstringsPerSec(stream.size() * fCompilerThreads, concurrent));
   }
 }
 
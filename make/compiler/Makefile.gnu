@@ -37,6 +37,10 @@ DEPEND_CFLAGS = -MMD -MP
 OPT_CFLAGS = -O3
 PROFILE_CFLAGS = -pg
 PROFILE_LFLAGS = -pg
+# Fat LTO objects keep machine code alongside the IR, so a runtime built
+# with LTO=1 still links into programs compiled without --lto.
+LTO_CFLAGS = -flto -ffat-lto-objects
+LTO_LFLAGS = -flto
 
 ifdef CHPL_GCOV
 CFLAGS += -fprofile-arcs -ftest-coverage
@@ -82,6 +86,21 @@ endif
 FAST_FLOAT_GEN_CFLAGS = -ffast-math
 IEEE_FLOAT_GEN_CFLAGS = -fno-fast-math
 
+# Profile-guided optimization of generated code.  An empty dump
+# directory names each .gcda after its object file's basename rather
+# than the temporary directory it was compiled in, and libgcov merges
+# the counts from all locales.
+# Link-time optimization of generated code together with the runtime
+LTO_GEN_CFLAGS = -flto
+LTO_GEN_LFLAGS = -flto=auto
+# use the machine code in a fat LTO=1 runtime when not linking with --lto
+NO_LTO_GEN_LFLAGS = -fno-lto
+
+PGO_NAME_CFLAGS = -dumpdir '' -fprofile-prefix-path=$(CURDIR)
+PGO_GEN_CFLAGS = -fprofile-generate=$(COMP_GEN_PGO_GEN_DIR) -fprofile-update=prefer-atomic $(PGO_NAME_CFLAGS)
+PGO_GEN_LFLAGS = -fprofile-generate=$(COMP_GEN_PGO_GEN_DIR)
+PGO_USE_CFLAGS = -fprofile-use=$(COMP_GEN_PGO_USE_DIR) $(PGO_NAME_CFLAGS) -Wno-missing-profile -Wno-coverage-mismatch
+
 ifeq ($(CHPL_MAKE_PLATFORM), darwin)
 # build 64-bit binaries when on a 64-bit capable PowerPC
 ARCH := $(shell test -x /usr/bin/machine -a `/usr/bin/machine` = ppc970 && echo -arch ppc64)
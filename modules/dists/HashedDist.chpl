@@ -0,0 +1,579 @@
+/*
+ * Copyright 2004-2017 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//
+// The Hashed distribution is defined with five classes:
+//
+//   Hashed       : distribution class
+//   HashedDom    : domain class
+//   HashedArr    : array class
+//   LocHashedDom : local domain class (per-locale instances)
+//   LocHashedArr : local array class (per-locale instances)
+//
+// Each locale stores the indices it owns in an ordinary associative
+// domain, and its part of each array in an ordinary associative array
+// over that domain.
+//
+
+config param debugHashed = false;
+
+/*
+  The default mapper for the :class:`Hashed` distribution.  It mixes the
+  bits of the index's hash before choosing a locale, so that the indices
+  a locale owns do not all share the low bits that the locale's own hash
+  table uses to place them.
+*/
+record DefaultMapper {
+  /* Return the position in ``targetLocales`` of the locale owning ``ind``. */
+  proc indexToLocaleIndex(ind, targetLocales: [] locale) : int {
+    const hash = chpl__defaultHashWrapper(ind);
+    const mixed = (_gen_key(hash) & max(int)): int;
+    return mixed % targetLocales.numElements;
+  }
+}
+
+/*
+  The Hashed distribution spreads the indices of an associative domain,
+  and the elements of the arrays over it, across a set of locales.  Each
+  index is owned by the locale that a *mapper* chooses for it, by default
+  one picked by the index's hash.
+
+  .. code-block:: chapel
+
+    use HashedDist;
+
+    var D: domain(string) dmapped Hashed(idxType=string);
+    var counts: [D] int;
+
+    D += "apple";
+    forall word in D do
+      counts[word] += 1;     // runs on the locale owning 'word'
+
+  Adding, removing or looking up a single index makes one trip to the
+  owning locale.  Adding an array of indices at once, with
+  ``D.bulkAdd(inds)`` or ``D += inds``, sorts them by owner on the
+  calling locale and sends each locale its indices in one transfer.
+
+  Parallel loops over a Hashed domain or array run on every target
+  locale at once, and each locale's tasks only visit the indices and
+  elements that it stores.  Zippered loops over arrays declared over the
+  same domain stay local as well.
+
+  A mapper is a record with the method
+  ``indexToLocaleIndex(ind, targetLocales: [] locale): int``
+  that returns a position in ``targetLocales``.  The same index must
+  always map to the same position.
+
+  **Constructor Arguments**
+
+  The ``Hashed`` class constructor is defined as follows:
+
+    .. code-block:: chapel
+
+      proc Hashed(type idxType = int(64),
+                  mapper = new DefaultMapper(),
+                  targetLocales: [] locale = Locales)
+
+  The domains created with this distribution have index type ``idxType``.
+*/
+class Hashed : BaseDist {
+
+  // the distribution's index type and domain's global index type
+  type idxType = int(64);
+
+  // chooses the locale of each index
+  const mapper;
+
+  // the target locales, 0-based for simplicity
+  const targetLocDom: domain(1);
+  const targetLocales: [targetLocDom] locale;
+
+  // privatized object id
+  var pid: int = -1;
+
+  proc Hashed(type idxType = int(64),
+              mapper:?t = new DefaultMapper(),
+              targetLocales: [] locale = Locales) {
+    targetLocDom = {0..#targetLocales.numElements};
+    this.targetLocales = targetLocales;
+
+    if debugHashed {
+      writeln("Creating new Hashed distribution:");
+      dsiDisplayRepresentation();
+    }
+  }
+
+  //
+  // builds up a privatized (replicated copy)
+  //
+  proc Hashed(type idxType = int(64),
+              mapper,
+              other: Hashed(idxType, mapper.type)) {
+    this.mapper = mapper;
+    targetLocDom = other.targetLocDom;
+    this.targetLocales = other.targetLocales;
+  }
+
+  proc dsiClone() {
+    return new Hashed(idxType, mapper, targetLocales);
+  }
+
+  proc dsiSupportsPrivatization() param return true;
+
+  proc dsiGetPrivatizeData() return 0;
+
+  proc dsiPrivatize(privatizeData) {
+    return new Hashed(idxType, mapper, this);
+  }
+
+  proc dsiGetReprivatizeData() return 0;
+
+  proc dsiReprivatize(other, reprivatizeData) { }
+
+  proc dsiNewAssociativeDom(type domIdxType, param parSafe: bool)
+  where domIdxType != idxType {
+    compilerError("Trying to create a domain whose index type does not match the distribution's");
+  }
+
+  proc dsiNewAssociativeDom(type idxType, param parSafe: bool) {
+    var dom = new HashedDom(idxType=idxType, mapperType=mapper.type,
+                            parSafe=parSafe, dist=this);
+    dom.setup();
+    return dom;
+  }
+
+  proc dsiDisplayRepresentation() {
+    writeln("targetLocDom = ", targetLocDom);
+    writeln("targetLocales = ", for tl in targetLocales do tl.id);
+  }
+
+  proc dsiIndexToLocale(ind: idxType) {
+    return targetLocales[indexToLocaleIndex(ind)];
+  }
+
+  proc indexToLocaleIndex(ind: idxType) {
+    const locIdx = mapper.indexToLocaleIndex(ind, targetLocales);
+    if boundsChecking then
+      if !targetLocDom.member(locIdx) then
+        halt("mapper provided invalid locale index: ", locIdx,
+             " is not in domain ", targetLocDom);
+    return locIdx;
+  }
+}
+
+//
+// Hashed Domain Class
+//
+// idxType:    generic domain index type
+// mapperType: the type of the distribution's mapper
+// parSafe:    generic parSafe parameter of the domain and its local domains
+// dist:       reference to distribution class
+// locDoms:    a non-distributed array of local domain classes
+//
+class HashedDom: BaseAssociativeDom {
+  type idxType;
+  type mapperType;
+  param parSafe: bool;
+
+  const dist: Hashed(idxType, mapperType);
+
+  var locDoms: [dist.targetLocDom] LocHashedDom(idxType, parSafe);
+
+  var pid: int = -1;
+
+  proc setup() {
+    coforall localeIdx in dist.targetLocDom do
+      on dist.targetLocales(localeIdx) do
+        if locDoms(localeIdx) == nil then
+          locDoms(localeIdx) = new LocHashedDom(idxType, parSafe);
+
+    if debugHashed then
+      for loc in dist.targetLocDom do
+        writeln(loc, " owns ", locDoms(loc));
+  }
+
+  proc dsiDestroyDom() {
+    coforall locDom in locDoms do
+      on locDom do
+        delete locDom;
+  }
+
+  proc dsiMyDist() return dist;
+
+  proc dsiSupportsPrivatization() param return true;
+
+  proc dsiGetPrivatizeData() return dist.pid;
+
+  proc dsiPrivatize(privatizeData) {
+    var privdist = chpl_getPrivatizedCopy(dist.type, privatizeData);
+    var c = new HashedDom(idxType=idxType, mapperType=mapperType,
+                          parSafe=parSafe, dist=privdist);
+    c.locDoms = locDoms;
+    return c;
+  }
+
+  proc dsiGetReprivatizeData() return 0;
+
+  proc dsiReprivatize(other, reprivatizeData) {
+    locDoms = other.locDoms;
+  }
+
+  //
+  // Each of these makes a single trip to the owner of the index
+  //
+  proc dsiAdd(i: idxType) {
+    var retval = 0;
+    const locDom = locDoms(dist.indexToLocaleIndex(i));
+    on locDom do
+      retval = locDom.myInds.add(i);
+    return retval;
+  }
+
+  proc dsiRemove(i: idxType) {
+    var retval = 0;
+    const locDom = locDoms(dist.indexToLocaleIndex(i));
+    on locDom do
+      retval = locDom.myInds.remove(i);
+    return retval;
+  }
+
+  proc dsiMember(i: idxType) {
+    var retval = false;
+    const locDom = locDoms(dist.indexToLocaleIndex(i));
+    on locDom do
+      retval = locDom.myInds.member(i);
+    return retval;
+  }
+
+  //
+  // Groups 'inds' by owning locale on this locale, then sends each
+  // locale its group in one transfer and adds it there in bulk.
+  //
+  proc dsiBulkAdd(inds: [] idxType): int {
+    var owners: [inds.domain] int;
+    forall (owner, i) in zip(owners, inds) do
+      owner = dist.indexToLocaleIndex(i);
+
+    var counts: [dist.targetLocDom] int;
+    for owner in owners do
+      counts[owner] += 1;
+
+    var starts: [dist.targetLocDom] int;
+    for loc in dist.targetLocDom.low+1..dist.targetLocDom.high do
+      starts[loc] = starts[loc-1] + counts[loc-1];
+
+    var grouped: [0..#inds.numElements] idxType;
+    var next = starts;
+    for (owner, i) in zip(owners, inds) {
+      grouped[next[owner]] = i;
+      next[owner] += 1;
+    }
+
+    var numAdded = 0;
+    coforall (locDom, start, count) in zip(locDoms, starts, counts)
+    with (+ reduce numAdded) do
+      on locDom {
+        if count > 0 {
+          const mine: [0..#count] idxType = grouped[start..#count];
+          numAdded += locDom.myInds.bulkAdd(mine);
+        }
+      }
+    return numAdded;
+  }
+
+  proc dsiClear() {
+    coforall locDom in locDoms do
+      on locDom do
+        locDom.myInds.clear();
+  }
+
+  proc dsiRequestCapacity(numKeys: int) {
+    const numLocs = dist.targetLocDom.numIndices;
+    const perLocale = (numKeys + numLocs - 1) / numLocs;
+    coforall locDom in locDoms do
+      on locDom do
+        locDom.myInds.requestCapacity(perLocale);
+  }
+
+  proc dsiAssignDomain(rhs: domain, lhsPrivate:bool) {
+    chpl_assignDomainWithIndsIterSafeForRemoving(this, rhs);
+  }
+
+  iter dsiIndsIterSafeForRemoving() {
+    for locDom in locDoms do
+      for ind in locDom.myInds._value.dsiIndsIterSafeForRemoving() do
+        yield ind;
+  }
+
+  proc dsiNumIndices {
+    var numIndices = 0;
+    coforall locDom in locDoms with (+ reduce numIndices) do
+      on locDom do
+        numIndices += locDom.myInds.numIndices;
+    return numIndices;
+  }
+
+  iter dsiSorted(comparator) {
+    use Sort;
+
+    var tableCopy: [0..#dsiNumIndices] idxType;
+    var idx = 0;
+    for ind in these() {
+      tableCopy[idx] = ind;
+      idx += 1;
+    }
+
+    sort(tableCopy, comparator);
+
+    for ind in tableCopy do
+      yield ind;
+  }
+
+  //
+  // Associative domains do not define their order of iteration, so
+  // visiting the indices locale by locale is fine.
+  //
+  iter these() {
+    for locDom in locDoms do
+      for ind in locDom.myInds do
+        yield ind;
+  }
+
+  //
+  // The leader starts a team of tasks on each locale, which divides
+  // that locale's own table among them.
+  //
+  iter these(param tag: iterKind) where tag == iterKind.leader {
+    coforall (locDom, localeIdx) in zip(locDoms, dist.targetLocDom) do
+      on locDom do
+        for followThis in locDom.myInds._value.these(tag) do
+          yield (followThis, localeIdx);
+  }
+
+  iter these(param tag: iterKind, followThis) where tag == iterKind.follower {
+    const (locFollowThis, localeIdx) = followThis;
+
+    for i in locDoms[localeIdx].myInds._value.these(tag, locFollowThis) do
+      yield i;
+  }
+
+  iter these(param tag: iterKind) where tag == iterKind.standalone {
+    coforall locDom in locDoms do
+      on locDom do
+        for i in locDom.myInds._value.these(tag) do
+          yield i;
+  }
+
+  proc dsiSerialWrite(x) {
+    x.write("{");
+    var first = true;
+    for ind in these() {
+      if first then first = false; else x.write(", ");
+      x.write(ind);
+    }
+    x.write("}");
+  }
+
+  proc dsiBuildArray(type eltType) {
+    var arr = new HashedArr(idxType=idxType, mapperType=mapperType,
+                            parSafe=parSafe, eltType=eltType, dom=this);
+    arr.setup();
+    return arr;
+  }
+}
+
+//
+// Local Hashed Domain Class
+//
+// idxType: generic domain index type
+// parSafe: generic parSafe parameter of the global domain
+// myInds:  a non-distributed domain holding the indices this locale owns
+//
+class LocHashedDom {
+  type idxType;
+  param parSafe: bool;
+
+  var myInds: domain(idxType, parSafe=parSafe);
+
+  proc writeThis(x) {
+    x.write(myInds);
+  }
+}
+
+//
+// Hashed Array Class
+//
+// idxType:    generic array index type
+// mapperType: the type of the distribution's mapper
+// parSafe:    generic parSafe parameter of the domain
+// eltType:    generic array element type
+// dom:        reference to domain class
+// locArrs:    a non-distributed array of local array classes
+//
+class HashedArr: BaseArr {
+  type idxType;
+  type mapperType;
+  param parSafe: bool;
+  type eltType;
+
+  var dom: HashedDom(idxType, mapperType, parSafe);
+
+  var locArrs: [dom.dist.targetLocDom] LocHashedArr(idxType, parSafe, eltType);
+
+  var pid: int = -1;
+
+  proc setup() {
+    coforall localeIdx in dom.dist.targetLocDom do
+      on dom.dist.targetLocales(localeIdx) do
+        locArrs(localeIdx) = new LocHashedArr(idxType, parSafe, eltType,
+                                              dom.locDoms(localeIdx));
+  }
+
+  proc dsiDestroyArr(isalias:bool) {
+    coforall locArr in locArrs do
+      on locArr do
+        delete locArr;
+  }
+
+  proc dsiGetBaseDom() return dom;
+
+  proc dsiSupportsPrivatization() param return true;
+
+  proc dsiGetPrivatizeData() return dom.pid;
+
+  proc dsiPrivatize(privatizeData) {
+    var privdom = chpl_getPrivatizedCopy(dom.type, privatizeData);
+    var c = new HashedArr(idxType=idxType, mapperType=mapperType,
+                          parSafe=parSafe, eltType=eltType, dom=privdom);
+    c.locArrs = locArrs;
+    return c;
+  }
+
+  //
+  // The owner of a remote index looks up its slot, so the element is
+  // reached with one trip for the lookup and one to read or write it,
+  // rather than one per probe of the owner's table.
+  //
+  proc dsiAccess(i: idxType) ref {
+    const locArr = locArrs[dom.dist.indexToLocaleIndex(i)];
+    if locArr.locale == here {
+      local {
+        return locArr.myElems(i);
+      }
+    }
+    return locArr.myElems._value.data[_ownerSlot(locArr, i)];
+  }
+
+  proc dsiAccess(i: idxType)
+  where shouldReturnRvalueByValue(eltType) {
+    const locArr = locArrs[dom.dist.indexToLocaleIndex(i)];
+    if locArr.locale == here {
+      local {
+        return locArr.myElems(i);
+      }
+    }
+    return locArr.myElems._value.data[_ownerSlot(locArr, i)];
+  }
+
+  proc dsiAccess(i: idxType) const ref
+  where shouldReturnRvalueByConstRef(eltType) {
+    const locArr = locArrs[dom.dist.indexToLocaleIndex(i)];
+    if locArr.locale == here {
+      local {
+        return locArr.myElems(i);
+      }
+    }
+    return locArr.myElems._value.data[_ownerSlot(locArr, i)];
+  }
+
+  proc _ownerSlot(locArr, i: idxType) {
+    var found = false, slot = 0;
+    on locArr {
+      (found, slot) = locArr.myElems._value.dom._findFilledSlot(i);
+    }
+    if !found then
+      halt("array index out of bounds: ", i);
+    return slot;
+  }
+
+  iter these() ref {
+    for locArr in locArrs do
+      for elem in locArr.myElems do
+        yield elem;
+  }
+
+  iter these(param tag: iterKind) where tag == iterKind.leader {
+    for followThis in dom.these(tag) do
+      yield followThis;
+  }
+
+  iter these(param tag: iterKind, followThis) ref where tag == iterKind.follower {
+    const (locFollowThis, localeIdx) = followThis;
+
+    for elem in locArrs[localeIdx].myElems._value.these(tag, locFollowThis) do
+      yield elem;
+  }
+
+  iter these(param tag: iterKind) ref where tag == iterKind.standalone {
+    coforall locArr in locArrs do
+      on locArr do
+        for elem in locArr.myElems._value.these(tag) do
+          yield elem;
+  }
+
+  proc dsiSerialWrite(x) {
+    var first = true;
+    for elem in these() {
+      if first then first = false; else x.write(" ");
+      x.write(elem);
+    }
+  }
+
+  proc dsiDisplayRepresentation() {
+    for locArr in locArrs do
+      writeln(locArr.locale, ": ", locArr);
+  }
+
+  proc dsiNumElements {
+    return dom.dsiNumIndices;
+  }
+}
+
+//
+// Local Hashed Array Class
+//
+// idxType: generic array index type
+// parSafe: generic parSafe parameter of the domain
+// eltType: generic array element type
+// locDom:  reference to local domain class
+// myElems: a non-distributed array of the elements this locale owns
+//
+class LocHashedArr {
+  type idxType;
+  param parSafe: bool;
+  type eltType;
+
+  const locDom: LocHashedDom(idxType, parSafe);
+
+  var myElems: [locDom.myInds] eltType;
+
+  proc writeThis(x) {
+    x.write(myElems);
+  }
+}
@@ -1290,13 +1290,22 @@ module ChapelArray {
 
     pragma "no doc"
     proc bulkAdd(inds: [] _value.idxType, dataSorted=false,
-        isUnique=false, preserveInds=true) where isSparseDom(this) && _value.rank==1 {
+        isUnique=false, preserveInds=true) where isSparseDom(this) && rank==1 {
 
       if inds.size == 0 then return 0;
 
       return _value.dsiBulkAdd(inds, dataSorted, isUnique, preserveInds);
     }
 
+    pragma "no doc"
+    proc bulkAdd(inds: [] _value.idxType, dataSorted=false,
+        isUnique=false, preserveInds=true) where isAssociativeDom(this) {
+
+      if inds.size == 0 then return 0;
+
+      return _value.dsiBulkAdd(inds);
+    }
+
     /*
        Adds indices in ``inds`` to this domain in bulk.
 
@@ -1310,8 +1319,9 @@ module ChapelArray {
        .. note::
 
          Right now, this method and the corresponding ``+=`` operator are
-         only available for sparse domains. In the future, we expect that
-         these methods will be available for all irregular domains.
+         only available for sparse and associative domains. Associative
+         domains ignore the three flags; they grow their table at most once
+         for the whole of ``inds`` and hash the indices in parallel.
 
        :arg inds: Indices to be added. ``inds`` can be an array of
                   ``rank*idxType`` or an array of ``idxType`` for
@@ -1329,8 +1339,8 @@ module ChapelArray {
        :returns: Number of indices added to the domain
        :rtype: int
     */
-    proc bulkAdd(inds: [] _value.rank*_value.idxType, dataSorted=false,
-        isUnique=false, preserveInds=true) where isSparseDom(this) && _value.rank>1 {
+    proc bulkAdd(inds: [] rank*_value.idxType, dataSorted=false,
+        isUnique=false, preserveInds=true) where isSparseDom(this) && rank>1 {
 
       if inds.size == 0 then return 0;
 
@@ -2095,7 +2105,9 @@ module ChapelArray {
     pragma "reference to const when const this"
     inline proc ref localAccess(i: rank*_value.dom.idxType) ref
     {
-      if isRectangularArr(this) || isSparseArr(this) then
+      if !chpl__hasDsiLocalAccess(i) then
+        return this(i);
+      else if isRectangularArr(this) || isSparseArr(this) then
         return _value.dsiLocalAccess(i);
       else
         return _value.dsiLocalAccess(i(1));
@@ -2104,7 +2116,9 @@ module ChapelArray {
     inline proc const localAccess(i: rank*_value.dom.idxType)
     where shouldReturnRvalueByValue(_value.eltType)
     {
-      if isRectangularArr(this) || isSparseArr(this) then
+      if !chpl__hasDsiLocalAccess(i) then
+        return this(i);
+      else if isRectangularArr(this) || isSparseArr(this) then
         return _value.dsiLocalAccess(i);
       else
         return _value.dsiLocalAccess(i(1));
@@ -2113,7 +2127,9 @@ module ChapelArray {
     inline proc const localAccess(i: rank*_value.dom.idxType) const ref
     where shouldReturnRvalueByConstRef(_value.eltType)
     {
-      if isRectangularArr(this) || isSparseArr(this) then
+      if !chpl__hasDsiLocalAccess(i) then
+        return this(i);
+      else if isRectangularArr(this) || isSparseArr(this) then
         return _value.dsiLocalAccess(i);
       else
         return _value.dsiLocalAccess(i(1));
@@ -2136,6 +2152,18 @@ module ChapelArray {
     where shouldReturnRvalueByConstRef(_value.eltType)
       return localAccess(i);
 
+    // Arrays whose implementation has no dsiLocalAccess() fall back on
+    // this(), so that the compiler can use localAccess() for any array.
+    pragma "no doc"
+    proc chpl__hasDsiLocalAccess(i: rank*_value.dom.idxType) param {
+      if isRectangularArr(this) || isSparseArr(this) then
+        return __primitive("method call resolves", _value,
+                           "dsiLocalAccess", i);
+      else
+        return __primitive("method call resolves", _value,
+                           "dsiLocalAccess", i(1));
+    }
+
 
     // array slicing by a domain
     //
@@ -3163,6 +3191,10 @@ module ChapelArray {
     a |= b;
   }
 
+  proc +=(ref a :domain, b: [] a.idxType) where isAssociativeDom(a) {
+    a.bulkAdd(b);
+  }
+
   /*
      We remove elements in the RHS domain from those in the LHS domain only if
      they exist. If an element in the RHS is not present in the LHS, no error
@@ -917,12 +917,16 @@ module ChapelBase {
     }
   }
 
+  extern proc chpl_comm_fast_nb_flush();
+
   // This function is called once by each newly initiated task.  No on
   // statement is needed because the call to sub() will do a remote
   // fork (on) if needed.
   pragma "dont disable remote value forwarding"
   pragma "down end count fn"
   proc _downEndCount(e: _EndCount) {
+    // finish any non-blocking fast ons this task started
+    chpl_comm_fast_nb_flush();
     // inform anybody waiting that we're done
     e.i.sub(1, memory_order_release);
   }
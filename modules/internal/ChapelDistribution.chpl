@@ -636,6 +636,13 @@ module ChapelDistribution {
       compilerError("Index addition is not supported by this domain");
       return 0;
     }
+
+    proc dsiBulkAdd(inds: []) {
+      var numAdded = 0;
+      for idx in inds do
+        numAdded += dsiAdd(idx);
+      return numAdded;
+    }
   
   }
   
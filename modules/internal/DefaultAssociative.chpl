@@ -39,17 +39,24 @@ module DefaultAssociative {
     var idx: idxType;
   }
 
-  proc chpl__primes return
-  (23, 53, 89, 191, 383, 761, 1531, 3067, 6143, 12281, 24571, 49139, 98299,
-   196597, 393209, 786431, 1572853, 3145721, 6291449, 12582893, 25165813,
-   50331599, 100663291, 201326557, 402653171, 805306357, 1610612711, 3221225461,
-   6442450939, 12884901877, 25769803751, 51539607551, 103079215087,
-   206158430183, 412316860387, 824633720831, 1649267441651, 3298534883309,
-   6597069766631, 13194139533299, 26388279066623, 52776558133177,
-   105553116266489, 211106232532969, 422212465065953, 844424930131963,
-   1688849860263901, 3377699720527861, 6755399441055731, 13510798882111483,
-   27021597764222939, 54043195528445869, 108086391056891903, 216172782113783773,
-   432345564227567561, 864691128455135207);
+  // Table sizes are powers of two, so that probing can wrap around with a
+  // mask instead of a modulus.  Size number 1 is the initial size.
+  param chpl__minTableSizeLog2 = 5;
+  param chpl__maxTableSizeLog2 = 59;
+  param chpl__maxTableSizeNum = chpl__maxTableSizeLog2 -
+                                chpl__minTableSizeLog2 + 1;
+
+  inline proc chpl__tableSize(sizeNum: int): int {
+    return 1 << (sizeNum + chpl__minTableSizeLog2 - 1);
+  }
+
+  // The number of locks that adds and removes on a parSafe domain are
+  // spread over
+  param chpl__assocLockStripes = 64;
+
+  // Rehashing a table or bulk adding fewer indices than this does not
+  // start any tasks
+  config param chpl__parallelRehashSize = 4096;
 
   class DefaultAssociativeDom: BaseAssociativeDom {
     type idxType;
@@ -64,17 +71,69 @@ module DefaultAssociative {
     var numEntries: atomic_int64;
     var tableLock: atomicbool; // do not access directly, use function below
     var tableSizeNum = 1;
-    var tableSize = chpl__primes(tableSizeNum);
+    var tableSize = chpl__tableSize(tableSizeNum);
     var tableDom = {0..tableSize-1};
     var table: [tableDom] chpl_TableEntry(idxType);
-  
+
+    // When parSafe, adds and removes of different indices proceed at the
+    // same time and lookups take no lock.  An index is only added or
+    // removed while holding the lock of its stripe, and an empty slot is
+    // only filled while holding the lock of the slot's stripe.  A removed
+    // index stays in its slot, since a lookup may still be comparing it,
+    // until the next resize reclaims the slot.  Operations that replace
+    // the table, like resizing, wait until no other operation is using it.
+    var indexLocks: chpl__assocLockStripes*atomicbool;
+    var slotLocks: chpl__assocLockStripes*atomicbool;
+    var numDeleted: atomic_int64;
+    var numUsers: atomic_int64;
+    var tableBusy: atomicbool;
+
+    // Gives the caller sole use of the table
     inline proc lockTable() {
       while tableLock.testAndSet() do chpl_task_yield();
+      tableBusy.write(true);
+      while numUsers.read() > 0 do chpl_task_yield();
     }
   
     inline proc unlockTable() {
+      tableBusy.write(false);
       tableLock.clear();
     }
+
+    // Shares the table with other adds, removes and lookups
+    inline proc _enterTable() {
+      while true {
+        while tableBusy.read() do chpl_task_yield();
+        numUsers.add(1);
+        if !tableBusy.read() then return;
+        numUsers.sub(1);
+      }
+    }
+
+    inline proc _leaveTable() {
+      numUsers.sub(1);
+    }
+
+    inline proc _indexStripe(idx: idxType) {
+      return chpl__defaultHashWrapper(idx) & (chpl__assocLockStripes-1);
+    }
+
+    inline proc _lockIndex(stripe: int) {
+      while indexLocks(stripe+1).testAndSet() do chpl_task_yield();
+    }
+
+    inline proc _unlockIndex(stripe: int) {
+      indexLocks(stripe+1).clear();
+    }
+
+    inline proc _lockSlot(slotNum: int) {
+      const stripe = slotNum & (chpl__assocLockStripes-1);
+      while slotLocks(stripe+1).testAndSet() do chpl_task_yield();
+    }
+
+    inline proc _unlockSlot(slotNum: int) {
+      slotLocks(slotNum & (chpl__assocLockStripes-1) + 1).clear();
+    }
   
     // TODO: An ugly [0..-1] domain appears several times in the code --
     //       replace with a named constant/param?
@@ -277,6 +336,7 @@ module DefaultAssociative {
           table[slot].status = chpl__hash_status.empty;
         }
         numEntries.write(0);
+        numDeleted.write(0);
         if parSafe then unlockTable();
       }
     }
@@ -309,31 +369,91 @@ module DefaultAssociative {
       const inSlot = slotNum;
       var retVal = 0;
       on this {
-        const shouldLock = needLock && parSafe;
-        if shouldLock then lockTable();
-        var findAgain = shouldLock;
-        if ((numEntries.read()+1)*2 > tableSize) {
-          _resize(grow=true);
-          findAgain = true;
+        if needLock && parSafe {
+          (slotNum, retVal) = _addConcurrent(idx);
+        } else {
+          var findAgain = false;
+          if ((numEntries.read()+1)*2 > tableSize) {
+            _resize(grow=true);
+            findAgain = true;
+          }
+          if findAgain then
+            (slotNum, retVal) = _add(idx, -1);
+          else
+            (_, retVal) = _add(idx, inSlot);
         }
-        if findAgain then
-          (slotNum, retVal) = _add(idx, -1);
-        else
-          (_, retVal) = _add(idx, inSlot);
-        if shouldLock then unlockTable();
       }
       return (slotNum, retVal);
     }
 
+    // Adds an index while other tasks may be adding, removing or looking
+    // up indices.  Returns the same tuple as _add().
+    proc _addConcurrent(idx: idxType) {
+      _enterTable();
+      if ((numEntries.read()+numDeleted.read()+1)*2 > tableSize) {
+        _leaveTable();
+        lockTable();
+        // another task may have resized the table in the meantime
+        if ((numEntries.read()+numDeleted.read()+1)*2 > tableSize) {
+          if ((numEntries.read()+1)*4 > tableSize) then
+            _resize(grow=true);
+          else
+            _rehash(tableSizeNum);
+        }
+        unlockTable();
+        _enterTable();
+      }
+
+      const stripe = _indexStripe(idx);
+      var retVal = (-1, 0);
+      _lockIndex(stripe);
+      const (foundSlot, slotNum) = _findFilledSlot(idx, needLock=false);
+      if foundSlot then
+        retVal = (slotNum, 0);
+      else
+        retVal = _claimEmptySlot(idx);
+      _unlockIndex(stripe);
+      _leaveTable();
+      return retVal;
+    }
+
+    // Stores 'idx' in the first empty slot along its probe sequence.
+    //
+    // NOTE: Calls to this routine assume that the lock of the stripe of
+    // 'idx' has been acquired.
+    //
+    proc _claimEmptySlot(idx: idxType) {
+      for slotNum in _lookForSlots(idx) {
+        if table[slotNum].status == chpl__hash_status.empty {
+          var claimed = false;
+          _lockSlot(slotNum);
+          if table[slotNum].status == chpl__hash_status.empty {
+            table[slotNum].idx = idx;
+            // lookups check the status before reading the index
+            atomic_fence(memory_order_release);
+            table[slotNum].status = chpl__hash_status.full;
+            claimed = true;
+          }
+          _unlockSlot(slotNum);
+          if claimed {
+            numEntries.add(1);
+            return (slotNum, 1);
+          }
+        }
+      }
+      halt("couldn't add ", idx, " -- ", numEntries.read(), " / ", tableSize, " taken");
+      return (-1, 0);
+    }
+
     // This routine adds new indices without checking the table size and
     //  is thus appropriate for use by routines like _resize().
     //
     // NOTE: Calls to this routine assume that the tableLock has been acquired.
     //
-    proc _add(idx: idxType, in slotNum : index(tableDom) = -1) {
+    proc _add(idx: idxType, in slotNum : index(tableDom) = -1, hash = -1) {
       var foundSlot : bool = (slotNum != -1);
       if !foundSlot then
-        (foundSlot, slotNum) = _findEmptySlot(idx);
+        (foundSlot, slotNum) = _findEmptySlot(idx, hash);
       if foundSlot {
         table[slotNum].status = chpl__hash_status.full;
         table[slotNum].idx = idx;
@@ -352,42 +472,83 @@ module DefaultAssociative {
     proc dsiRemove(idx: idxType) {
       var retval = 1;
       on this {
-        if parSafe then lockTable();
-        const (foundSlot, slotNum) = _findFilledSlot(idx, needLock=!parSafe);
-        if (foundSlot) {
-          for a in _arrs do
-            a.clearEntry(idx);
-          table[slotNum].status = chpl__hash_status.deleted;
-          numEntries.sub(1);
+        if parSafe {
+          const stripe = _indexStripe(idx);
+          _enterTable();
+          _lockIndex(stripe);
+          const (foundSlot, slotNum) = _findFilledSlot(idx, needLock=false);
+          if (foundSlot) {
+            for a in _arrs do
+              a.clearEntry(idx);
+            table[slotNum].status = chpl__hash_status.deleted;
+            numEntries.sub(1);
+            numDeleted.add(1);
+          } else {
+            retval = 0;
+          }
+          _unlockIndex(stripe);
+          _leaveTable();
+          if (numEntries.read()*8 < tableSize && tableSizeNum > 1) {
+            lockTable();
+            if (numEntries.read()*8 < tableSize && tableSizeNum > 1) {
+              _resize(grow=false);
+            }
+            unlockTable();
+          }
         } else {
-          retval = 0;
-        }
-        if (numEntries.read()*8 < tableSize && tableSizeNum > 1) {
-          _resize(grow=false);
+          const (foundSlot, slotNum) = _findFilledSlot(idx);
+          if (foundSlot) {
+            for a in _arrs do
+              a.clearEntry(idx);
+            table[slotNum].status = chpl__hash_status.deleted;
+            numEntries.sub(1);
+          } else {
+            retval = 0;
+          }
+          if (numEntries.read()*8 < tableSize && tableSizeNum > 1) {
+            _resize(grow=false);
+          }
         }
-        if parSafe then unlockTable();
       }
       return retval;
     }
   
-    proc findPrimeSizeIndex(numKeys:int) {
-      //Find the first suitable prime
+    proc findSizeIndex(numKeys:int) {
+      //Find the first suitable size
       var threshold = (numKeys + 1) * 2;
-      var prime = 0;
-      var primeLoc = 0;
-      for i in 1..chpl__primes.size {
-          if chpl__primes(i) > threshold {
-            prime = chpl__primes(i);
-            primeLoc = i;
-            break;
-          }
+      for i in 1..chpl__maxTableSizeNum {
+        if chpl__tableSize(i) > threshold then
+          return i;
       }
 
-      //No suitable prime found
-      if prime == 0 {
-        halt("Requested capacity (", numKeys, ") exceeds maximum size");
+      //No suitable size found
+      halt("Requested capacity (", numKeys, ") exceeds maximum size");
+      return 0;
+    }
+
+    // Adds the indices in 'inds', growing the table at most once.
+    // Returns the number of indices that were not in the domain yet.
+    proc dsiBulkAdd(inds: [] idxType): int {
+      var numAdded = 0;
+      on this {
+        if parSafe then lockTable();
+        const sizeNum = findSizeIndex(numEntries.read() + inds.size);
+        if sizeNum > tableSizeNum then
+          _rehash(sizeNum);
+
+        // as in _rehash(), hash in parallel but place the indices in order
+        var hashes: [inds.domain] int;
+        serial inds.size < chpl__parallelRehashSize do
+          forall (hash, idx) in zip(hashes, inds) do
+            hash = chpl__defaultHashWrapper(idx);
+
+        for (hash, idx) in zip(hashes, inds) {
+          const (_, added) = _add(idx, hash=hash);
+          numAdded += added;
+        }
+        if parSafe then unlockTable();
       }
-      return primeLoc;
+      return numAdded;
     }
 
     proc dsiRequestCapacity(numKeys:int) {
@@ -395,8 +556,7 @@ module DefaultAssociative {
 
       if entries < numKeys {
 
-        var primeLoc = findPrimeSizeIndex(numKeys);
-        var prime = chpl__primes(primeLoc);
+        var sizeNum = findSizeIndex(numKeys);
 
         //Changing underlying structure, time for locking
         if parSafe then lockTable();
@@ -411,12 +571,13 @@ module DefaultAssociative {
           // Do not preserve entries
           tableDom = {0..-1};
 
-          tableSizeNum = primeLoc;
-          tableSize = prime;
+          tableSizeNum = sizeNum;
+          tableSize = chpl__tableSize(sizeNum);
           tableDom = {0..tableSize-1};
 
           //numEntries will be reconstructed as keys are readded
           numEntries.write(0);
+          numDeleted.write(0);
 
           // insert old data into newly resized table
           for slot in _fullSlots(copyTable) {
@@ -427,8 +588,8 @@ module DefaultAssociative {
           _removeArrayBackups();
         } else {
           //Fast path, nothing to backup
-          tableSizeNum=primeLoc;
-          tableSize=prime;
+          tableSizeNum = sizeNum;
+          tableSize = chpl__tableSize(sizeNum);
           tableDom = {0..tableSize-1};
         }
 
@@ -459,6 +620,15 @@ module DefaultAssociative {
     // NOTE: Calls to this routine assume that the tableLock has been acquired.
     //
     proc _resize(grow:bool) {
+      _rehash(tableSizeNum + (if grow then 1 else -1));
+    }
+
+    // Moves the indices into a new table of size number 'newSizeNum',
+    // which drops the slots of removed indices.
+    //
+    // NOTE: Calls to this routine assume that the tableLock has been acquired.
+    //
+    proc _rehash(newSizeNum: int) {
       if postponeResize then return;
       // back up the arrays
       _backupArrays();
@@ -470,16 +640,30 @@ module DefaultAssociative {
       // grow original table
       tableDom = {0..(-1:chpl_table_index_type)}; // non-preserving resize
       numEntries.write(0); // reset, because the adds below will re-set this
-      tableSizeNum += if grow then 1 else -1;
-      if tableSizeNum > chpl__primes.size then halt("associative array exceeds maximum size");
-      tableSize = chpl__primes(tableSizeNum);
+      numDeleted.write(0);
+      tableSizeNum = newSizeNum;
+      if tableSizeNum > chpl__maxTableSizeNum then halt("associative array exceeds maximum size");
+      tableSize = chpl__tableSize(tableSizeNum);
       tableDom = {0..tableSize-1};
   
-      // insert old data into newly resized table
+      // Hash the indices with all of the local tasks.  They are placed in
+      // slot order so that the new table does not depend on timing, then
+      // the array elements follow them in parallel.
+      var hashes: [copyDom] int;
+      serial copyDom.size < chpl__parallelRehashSize do
+        forall slot in copyDom do
+          if copyTable[slot].status == chpl__hash_status.full then
+            hashes[slot] = chpl__defaultHashWrapper(copyTable[slot].idx);
+
+      var newSlots: [copyDom] int;
       for slot in _fullSlots(copyTable) {
-        const (newslot, _) = _add(copyTable[slot].idx);
-        _preserveArrayElements(oldslot=slot, newslot=newslot);
+        (newSlots[slot], _) = _add(copyTable[slot].idx, hash=hashes[slot]);
       }
+
+      serial copyDom.size < chpl__parallelRehashSize do
+        forall slot in copyDom do
+          if copyTable[slot].status == chpl__hash_status.full then
+            _preserveArrayElements(oldslot=slot, newslot=newSlots[slot]);
       
       _removeArrayBackups();
     }
@@ -489,7 +673,7 @@ module DefaultAssociative {
     // Returns true if found, along with the first open slot that may be
     // re-used for faster addition to the domain
     proc _findFilledSlot(idx: idxType, needLock = true) : (bool, index(tableDom)) {
-      if parSafe && needLock then lockTable();
+      if parSafe && needLock then _enterTable();
       var firstOpen = -1;
       for slotNum in _lookForSlots(idx, table.domain.high+1) {
         const slotStatus = table[slotNum].status;
@@ -497,26 +681,32 @@ module DefaultAssociative {
         // be found past this point.
         if (slotStatus == chpl__hash_status.empty) {
           if firstOpen == -1 then firstOpen = slotNum;
-          if parSafe && needLock then unlockTable();
+          if parSafe && needLock then _leaveTable();
           return (false, firstOpen);
         } else if (slotStatus == chpl__hash_status.full) {
+          // pairs with the fence in _claimEmptySlot()
+          if parSafe then atomic_fence(memory_order_acquire);
           if (table[slotNum].idx == idx) {
-            if parSafe && needLock then unlockTable();
+            if parSafe && needLock then _leaveTable();
             return (true, slotNum);
           }
         } else { // this entry was removed, but is the first slot we could use
           if firstOpen == -1 then firstOpen = slotNum;
         }
       }
-      if parSafe && needLock then unlockTable();
+      if parSafe && needLock then _leaveTable();
       return (false, -1);
     }
 
     //
     // NOTE: Calls to this routine assume that the tableLock has been acquired.
     //
-    proc _findEmptySlot(idx: idxType): (bool, index(tableDom)) {
-      for slotNum in _lookForSlots(idx) {
+    // 'hash' is the hash of 'idx' when the caller has already computed it.
+    //
+    proc _findEmptySlot(idx: idxType, hash = -1): (bool, index(tableDom)) {
+      const baseHash = if hash == -1 then chpl__defaultHashWrapper(idx)
+                       else hash;
+      for slotNum in _probeSlots(baseHash, tableSize) {
         const slotStatus = table[slotNum].status;
         if (slotStatus == chpl__hash_status.empty ||
             slotStatus == chpl__hash_status.deleted) {
@@ -529,18 +719,24 @@ module DefaultAssociative {
     }
       
     //
-    // NOTE: Calls to this routine assume that the tableLock has been acquired.
+    iter _lookForSlots(idx: idxType, numSlots = tableSize) {
+      for slot in _probeSlots(chpl__defaultHashWrapper(idx), numSlots) do
+        yield slot;
+    }
+
+    // Probing by triangular numbers visits every slot of a table whose
+    // size is a power of two.
     //
     // NOTE: A copy of this routine is tested in
     //    test/associative/ferguson/check-look-for-slots.chpl
     // So, when updating this routine, either refactor so the test
     // can use the below code - or update the test in a corresponding manner.
-    iter _lookForSlots(idx: idxType, numSlots = tableSize) {
-      const baseSlot = chpl__defaultHashWrapper(idx):uint;
-      for probe in 0..numSlots/2 {
-        var uprobe = probe:uint;
-        var n = numSlots:uint;
-        yield ((baseSlot + uprobe**2)%n):int;
+    iter _probeSlots(hash: int, numSlots: int) {
+      const mask = (numSlots-1):uint;
+      var slot = hash:uint & mask;
+      for probe in 1..numSlots {
+        yield slot:int;
+        slot = (slot + probe:uint) & mask;
       }
     }
   
@@ -38,7 +38,7 @@ module LocaleModelHelpFlat {
   //  if (chpl_doDirectExecuteOn(targetLocale))
   //         onStatementBodyFunction( args ... );
   //  else
-  //         chpl_executeOn / chpl_executeOnFast
+  //         chpl_executeOn / chpl_executeOnFast / chpl_executeOnFastNB
   //
   export
   proc chpl_doDirectExecuteOn(loc: chpl_localeID_t // target locale
@@ -95,6 +95,30 @@ module LocaleModelHelpFlat {
     }
   }
 
+  //
+  // fast "on" that is not waited for (the compiler only uses it when
+  // nothing later in the task depends on the body having finished,
+  // except through communication, which waits for it)
+  //
+  pragma "insert line file info"
+  export
+  proc chpl_executeOnFastNB(loc: chpl_localeID_t, // target locale
+                            fn: int,              // on-body function idx
+                            args: chpl_comm_on_bundle_p,     // function args
+                            args_size: size_t     // args size
+                           ) {
+    const node = chpl_nodeFromLocaleID(loc);
+    if (node == chpl_nodeID) {
+      // don't call the runtime fast execute_on function if we can stay local
+      chpl_ftable_call(fn, args);
+    } else {
+      var tls = chpl_task_getChapelData();
+      chpl_task_data_setup(chpl_comm_on_bundle_task_bundle(args), tls);
+      chpl_comm_execute_on_fast_nb(node, chpl_sublocFromLocaleID(loc),
+                                   fn, args, args_size);
+    }
+  }
+
   //
   // nonblocking "on" (doesn't wait for completion)
   //
@@ -53,7 +53,7 @@ module LocaleModelHelpNUMA {
   //  if (chpl_doDirectExecuteOn(targetLocale))
   //         onStatementBodyFunction( args ... );
   //  else
-  //         chpl_executeOn / chpl_executeOnFast
+  //         chpl_executeOn / chpl_executeOnFast / chpl_executeOnFastNB
   //
   export
   proc chpl_doDirectExecuteOn(loc: chpl_localeID_t // target locale
@@ -139,6 +139,29 @@ module LocaleModelHelpNUMA {
     }
   }
 
+  //
+  // fast "on" that is not waited for (the compiler only uses it when
+  // nothing later in the task depends on the body having finished,
+  // except through communication, which waits for it)
+  //
+  pragma "insert line file info"
+  export
+  proc chpl_executeOnFastNB(loc: chpl_localeID_t, // target locale
+                            fn: int,              // on-body function idx
+                            args: chpl_comm_on_bundle_p,     // function args
+                            args_size: size_t     // args size
+                           ) {
+    const dnode =  chpl_nodeFromLocaleID(loc);
+    const dsubloc =  chpl_sublocFromLocaleID(loc);
+    if dnode != chpl_nodeID {
+      var tls = chpl_task_getChapelData();
+      chpl_task_data_setup(chpl_comm_on_bundle_task_bundle(args), tls);
+      chpl_comm_execute_on_fast_nb(dnode, dsubloc, fn, args, args_size);
+    } else {
+      chpl_executeOnFast(loc, fn, args, args_size);
+    }
+  }
+
   //
   // nonblocking "on" (doesn't wait for completion)
   //
@@ -101,6 +101,8 @@ module LocaleModelHelpRuntime {
                                         args: chpl_comm_on_bundle_p, args_size: size_t);
   extern proc chpl_comm_execute_on_nb(loc_id: int, subloc_id: int, fn: int,
                                       args: chpl_comm_on_bundle_p, args_size: size_t);
+  extern proc chpl_comm_execute_on_fast_nb(loc_id: int, subloc_id: int, fn: int,
+                                           args: chpl_comm_on_bundle_p, args_size: size_t);
   pragma "insert line file info"
     extern proc chpl_comm_taskCallFTable(fn: int,
                                          args: chpl_comm_on_bundle_p, args_size: size_t,
@@ -391,6 +391,25 @@ void chpl_comm_execute_on_fast(c_nodeid_t node, c_sublocid_t subloc,
                          chpl_fn_int_t fid,
                          chpl_comm_on_bundle_t *arg, size_t arg_size);
 
+//
+// non-blocking fast execute_on (i.e., run in handler, no reply)
+// arg can be reused immediately after this call completes.
+//
+// The comm layer may hold the call back to send it together with
+// others to the same node.  Before any other communication by this
+// node, and in chpl_comm_fast_nb_flush(), every such call that was
+// made earlier is sent and waited for.
+//
+void chpl_comm_execute_on_fast_nb(c_nodeid_t node, c_sublocid_t subloc,
+                                  chpl_fn_int_t fid,
+                                  chpl_comm_on_bundle_t *arg, size_t arg_size);
+
+//
+// wait for all earlier chpl_comm_execute_on_fast_nb() calls by this
+// node to complete
+//
+void chpl_comm_fast_nb_flush(void);
+
 
 //
 // This call specifies the number of polling tasks that the
@@ -241,9 +241,11 @@ typedef enum {
   FORK_NB_LARGE,        // non-blocking fork with a huge argument
   FORK_FAST,            // run the function in the handler (use with care)
   FORK_FAST_SMALL,      // run the function in the handler (use with care)
+  FORK_FAST_NB,         // run several functions in the handler, reply once
 
   SIGNAL,               // ack to a done_t via gasnet_AMReplyShortM()
   SIGNAL_LONG,          // ack to a done_t via gasnet_AMReplyLongM()
+  FAST_NB_DONE,         // ack to a FORK_FAST_NB
   PRIV_BCAST,           // put data at addr (used for private broadcast)
   PRIV_BCAST_LARGE,     // put data at addr (used for private broadcast)
   FREE,                 // free data at addr
@@ -323,9 +325,116 @@ static void AM_fork_fast_small(gasnet_token_t token, void* buf, size_t nbytes) {
 }
 
 
+//
+// Non-blocking fast forks are collected in a buffer per target node
+// and sent as one FORK_FAST_NB message, which runs them in order in
+// the handler and then replies once.  Each entry in a buffer is the
+// size of the argument bundle followed by the bundle itself, padded
+// so the next entry stays aligned.
+//
+#define FAST_NB_BUF_SIZE 4096
+
+typedef struct {
+  gasnet_hsl_t lock;
+  size_t       used;
+  char         data[FAST_NB_BUF_SIZE];
+} fast_nb_buf_t;
+
+static fast_nb_buf_t* fast_nb_bufs;
+static size_t fast_nb_buf_size;
+
+// buffers that are not empty plus messages not yet replied to
+static atomic_uint_least32_t fast_nb_outstanding;
+
+static inline
+size_t fast_nb_entry_size(size_t arg_size) {
+  size_t size = sizeof(size_t) + arg_size;
+  return (size + sizeof(size_t) - 1) & ~(sizeof(size_t) - 1);
+}
+
+static void AM_fork_fast_nb(gasnet_token_t token, void* buf, size_t nbytes) {
+  char* entry = buf;
+  char* end = entry + nbytes;
+
+  while (entry < end) {
+    size_t arg_size = *(size_t*) entry;
+    chpl_comm_on_bundle_t *f = (chpl_comm_on_bundle_t*) (entry + sizeof(size_t));
+
+    // Run the function
+    chpl_ftable_call(f->task_bundle.requested_fid, f);
+
+    entry += fast_nb_entry_size(arg_size);
+  }
+
+  GASNET_Safe(gasnet_AMReplyShort0(token, FAST_NB_DONE));
+}
+
+static void AM_fast_nb_done(gasnet_token_t token) {
+  (void) atomic_fetch_sub_uint_least32_t(&fast_nb_outstanding, 1);
+}
+
+//
+// Move the buffered forks for one node into msg, which is sent once the
+// buffer's lock is released (GASNet may poll in a request, and that is
+// not allowed while holding a handler-safe lock).  The buffer stays
+// counted as outstanding until the message is replied to.
+//
+static inline
+size_t fast_nb_take(fast_nb_buf_t* b, char* msg) {
+  size_t used = b->used;
+
+  chpl_memcpy(msg, b->data, used);
+  b->used = 0;
+
+  return used;
+}
+
+static void fast_nb_send_all(void) {
+  char msg[FAST_NB_BUF_SIZE];
+  c_nodeid_t node;
+
+  for (node = 0; node < chpl_numNodes; node++) {
+    fast_nb_buf_t* b = &fast_nb_bufs[node];
+    size_t used;
+
+    if (b->used == 0)
+      continue;
+
+    gasnet_hsl_lock(&b->lock);
+    used = fast_nb_take(b, msg);
+    gasnet_hsl_unlock(&b->lock);
+
+    if (used > 0)
+      GASNET_Safe(gasnet_AMRequestMedium0(node, FORK_FAST_NB, msg, used));
+  }
+}
+
+//
+// Called before other communication, so that it cannot overtake the
+// non-blocking fast forks that were made before it.
+//
+static inline
+void fast_nb_wait(void) {
+  if (atomic_load_uint_least32_t(&fast_nb_outstanding) == 0)
+    return;
+
+  fast_nb_send_all();
+
+#ifndef CHPL_COMM_YIELD_TASK_WHILE_POLLING
+  GASNET_BLOCKUNTIL(atomic_load_uint_least32_t(&fast_nb_outstanding) == 0);
+#else
+  while (atomic_load_uint_least32_t(&fast_nb_outstanding) != 0) {
+    (void) gasnet_AMPoll();
+    chpl_task_yield();
+  }
+#endif
+}
+
 static void fork_wrapper(chpl_comm_on_bundle_t *f) {
   chpl_ftable_call(f->task_bundle.requested_fid, f);
 
+  fast_nb_wait();
+
   GASNET_Safe(gasnet_AMRequestShort2(f->comm.caller, SIGNAL,
                                      Arg0(f->comm.ack), Arg1(f->comm.ack)));
 }
@@ -381,6 +490,8 @@ static void fork_large_wrapper(large_fork_task_t* f) {
   // Call the on body function
   chpl_ftable_call(fid, arg);
 
+  fast_nb_wait();
+
   // Signal completion
   GASNET_Safe(gasnet_AMRequestShort2(caller, SIGNAL, Arg0(ack), Arg1(ack)));
 
@@ -585,8 +696,10 @@ static gasnet_handlerentry_t ftable[] = {
   {FORK_NB_LARGE, AM_fork_nb_large},
   {FORK_FAST,     AM_fork_fast},
   {FORK_FAST_SMALL, AM_fork_fast_small},
+  {FORK_FAST_NB,  AM_fork_fast_nb},
   {SIGNAL,        AM_signal},
   {SIGNAL_LONG,   AM_signal_long},
+  {FAST_NB_DONE,  AM_fast_nb_done},
   {PRIV_BCAST,    AM_priv_bcast},
   {PRIV_BCAST_LARGE, AM_priv_bcast_large},
   {FREE,          AM_free},
@@ -606,6 +719,8 @@ chpl_comm_nb_handle_t chpl_comm_put_nb(void *addr, c_nodeid_t node, void* raddr,
   gasnet_handle_t ret;
   int remote_in_segment;
 
+  fast_nb_wait();
+
   // Communication callbacks
   if (chpl_comm_have_callbacks(chpl_comm_cb_event_kind_put_nb)) {
     chpl_comm_cb_info_t cb_data = 
@@ -644,6 +759,8 @@ chpl_comm_nb_handle_t chpl_comm_get_nb(void* addr, c_nodeid_t node, void* raddr,
   gasnet_handle_t ret;
   int remote_in_segment;
 
+  fast_nb_wait();
+
   // Communications callback support
   if (chpl_comm_have_callbacks(chpl_comm_cb_event_kind_get_nb)) {
     chpl_comm_cb_info_t cb_data = 
@@ -738,6 +855,8 @@ static void polling(void* x) {
   pollingRunning = 1;
   while (!pollingQuit) {
     (void) gasnet_AMPoll();
+    if (atomic_load_uint_least32_t(&fast_nb_outstanding) != 0)
+      fast_nb_send_all();
     chpl_task_yield();
   }
   pollingRunning = 0;
@@ -878,7 +997,20 @@ void chpl_comm_init(int *argc_p, char ***argv_p) {
 
 }
 
-void chpl_comm_post_mem_init(void) { }
+void chpl_comm_post_mem_init(void) {
+  c_nodeid_t node;
+
+  fast_nb_bufs = chpl_mem_allocManyZero(chpl_numNodes, sizeof(fast_nb_buf_t),
+                                        CHPL_RT_MD_COMM_PER_LOC_INFO, 0, 0);
+  for (node = 0; node < chpl_numNodes; node++)
+    gasnet_hsl_init(&fast_nb_bufs[node].lock);
+
+  fast_nb_buf_size = FAST_NB_BUF_SIZE;
+  if (fast_nb_buf_size > gasnet_AMMaxMedium())
+    fast_nb_buf_size = gasnet_AMMaxMedium();
+
+  atomic_init_uint_least32_t(&fast_nb_outstanding, 0);
+}
 
 int chpl_comm_numPollingTasks(void) {
   return 1;
@@ -1004,6 +1136,8 @@ void chpl_comm_barrier(const char *msg) {
   chpl_msg(2, "%d: enter barrier for '%s'\n", chpl_nodeID, msg);
 #endif
 
+  fast_nb_wait();
+
   //
   // We don't want to just do a gasnet_barrier_wait() here, because
   // GASNet will put us to work polling, and we already have a polling
@@ -1104,6 +1238,8 @@ void  chpl_comm_put(void* addr, c_nodeid_t node, void* raddr,
   if (chpl_nodeID == node) {
     memmove(raddr, addr, size);
   } else {
+    fast_nb_wait();
+
     // Communications callback support
     if (chpl_comm_have_callbacks(chpl_comm_cb_event_kind_put)) {
       chpl_comm_cb_info_t cb_data =
@@ -1186,6 +1322,8 @@ void  chpl_comm_get(void* addr, c_nodeid_t node, void* raddr,
   if (chpl_nodeID == node) {
     memmove(addr, raddr, size);
   } else {
+    fast_nb_wait();
+
     // Communications callback support
     if (chpl_comm_have_callbacks(chpl_comm_cb_event_kind_get)) {
       chpl_comm_cb_info_t cb_data = 
@@ -1319,6 +1457,8 @@ void  chpl_comm_get_strd(void* dstaddr, size_t* dststrides, c_nodeid_t srcnode_i
   size_t srcstr[strlvls];
   size_t cnt[strlvls+1];
 
+  fast_nb_wait();
+
   // Only count[0] and strides are measured in number of bytes.
   cnt[0] = count[0] * elemSize;
 
@@ -1386,6 +1526,8 @@ void  chpl_comm_put_strd(void* dstaddr, size_t* dststrides, c_nodeid_t dstnode_i
   size_t srcstr[strlvls];
   size_t cnt[strlvls+1];
 
+  fast_nb_wait();
+
   // Only count[0] and strides are measured in number of bytes.
   cnt[0] = count[0] * elemSize;
   if (strlvls>0) {
@@ -1452,6 +1594,8 @@ void  execute_on_common(c_nodeid_t node, c_sublocid_t subloc,
 
   chpl_task_ChapelData_t state = *chpl_task_getChapelData();
 
+  fast_nb_wait();
+
   if (blocking)
     init_done_obj(&done, 1);
 
@@ -1642,6 +1786,71 @@ void  chpl_comm_execute_on_fast(c_nodeid_t node, c_sublocid_t subloc,
   }
 }
 
+void  chpl_comm_execute_on_fast_nb(c_nodeid_t node, c_sublocid_t subloc,
+                                   chpl_fn_int_t fid,
+                                   chpl_comm_on_bundle_t *arg, size_t arg_size) {
+  size_t entry_size = fast_nb_entry_size(arg_size);
+  char msg[FAST_NB_BUF_SIZE];
+  size_t full = 0;
+  fast_nb_buf_t* b;
+
+  if (chpl_nodeID == node) {
+    assert(0);
+    chpl_ftable_call(fid, arg);
+    return;
+  }
+
+  if (entry_size > fast_nb_buf_size) {
+    chpl_comm_execute_on_fast(node, subloc, fid, arg, arg_size);
+    return;
+  }
+
+  // Communications callback support
+  if (chpl_comm_have_callbacks(chpl_comm_cb_event_kind_executeOn_fast)) {
+    chpl_comm_cb_info_t cb_data = 
+      {chpl_comm_cb_event_kind_executeOn_fast, chpl_nodeID, node,
+       .iu.executeOn={subloc, fid, arg, arg_size}};
+    chpl_comm_do_callbacks (&cb_data);
+  }
+
+  if (chpl_verbose_comm && !chpl_comm_no_debug_private)
+    printf("%d: remote non-blocking (no-fork) task created on %d\n",
+           chpl_nodeID, node);
+  if (chpl_comm_diagnostics && !chpl_comm_no_debug_private) {
+    chpl_sync_lock(&chpl_comm_diagnostics_sync);
+    chpl_comm_commDiagnostics.execute_on_fast++;
+    chpl_sync_unlock(&chpl_comm_diagnostics_sync);
+  }
+
+  arg->task_bundle.state = *chpl_task_getChapelData();
+  arg->task_bundle.requestedSubloc = subloc;
+  arg->task_bundle.requested_fid = fid;
+  arg->comm.caller = chpl_nodeID;
+  arg->comm.ack = NULL;
+
+  b = &fast_nb_bufs[node];
+  gasnet_hsl_lock(&b->lock);
+
+  if (b->used + entry_size > fast_nb_buf_size)
+    full = fast_nb_take(b, msg);
+
+  if (b->used == 0)
+    (void) atomic_fetch_add_uint_least32_t(&fast_nb_outstanding, 1);
+
+  *(size_t*) (b->data + b->used) = arg_size;
+  chpl_memcpy(b->data + b->used + sizeof(size_t), arg, arg_size);
+  b->used += entry_size;
+
+  gasnet_hsl_unlock(&b->lock);
+
+  if (full > 0)
+    GASNET_Safe(gasnet_AMRequestMedium0(node, FORK_FAST_NB, msg, full));
+}
+
+void chpl_comm_fast_nb_flush(void) {
+  fast_nb_wait();
+}
+
 void chpl_comm_make_progress(void)
 {
   gasnet_AMPoll();
@@ -5529,6 +5529,23 @@ void chpl_comm_execute_on_fast(int locale, c_sublocid_t subloc,
 }
 
 
+void chpl_comm_execute_on_fast_nb(int locale, c_sublocid_t subloc,
+                                  chpl_fn_int_t fid,
+                                  chpl_comm_on_bundle_t* arg, size_t arg_size)
+{
+  //
+  // Since the rf_handler() only runs blocking fast forks, this is just
+  // a fast one for now.
+  //
+  chpl_comm_execute_on_fast(locale, subloc, fid, arg, arg_size);
+}
+
+
+void chpl_comm_fast_nb_flush(void)
+{
+}
+
+
 static
 void fork_call_common(int locale, c_sublocid_t subloc,
                       chpl_fn_int_t fid,
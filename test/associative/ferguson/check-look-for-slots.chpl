@@ -1,21 +1,22 @@
 config const verbose = false;
 
 iter lookForSlots(hash:int, numSlots:int) {
-  const baseSlot = hash:uint;
-  for probe in 0..numSlots/2 {
-    var uprobe = probe:uint;
-    var n = numSlots:uint;
-    yield ((baseSlot + uprobe**2)%n):int;
+  const mask = (numSlots-1):uint;
+  var slot = hash:uint & mask;
+  for probe in 1..numSlots {
+    yield slot:int;
+    slot = (slot + probe:uint) & mask;
   }
 }
 
 // How many buckets can lookForSlots check?
 // Let's find out.
-// Theoretically, quadratic probing should enumerate 1/2 of the slots.
+// Triangular probing should enumerate all of the slots of a table
+// whose size is a power of two.
 // It should always returns a value in 0..#numSlots
 
 for hash in (max(int)-3, max(int)-2, max(int)-1, max(int), 0, 1, 2, 3) {
-  for numSlots in (3, 7, 11, 19, 23, 31, 47, 83, 191, 383) {
+  for numSlots in (1, 2, 4, 8, 32, 64, 128, 1024, 4096) {
     var hits:[0..#numSlots] int;
     for i in lookForSlots(hash, numSlots) {
       if verbose then
@@ -32,7 +33,7 @@ for hash in (max(int)-3, max(int)-2, max(int)-1, max(int), 0, 1, 2, 3) {
     if verbose then
       writeln("lookForSlots(", hash, ",", numSlots, ") resulted in ", fullSlots,
               " full slots");
-    assert(fullSlots >= numSlots / 2);
+    assert(fullSlots == numSlots);
   }
 }
 
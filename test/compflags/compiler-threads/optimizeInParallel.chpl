@@ -0,0 +1,37 @@
+// Exercise the per-function optimization passes with several compiler
+// threads: loops for LICM, copies and refs for propagation, and dead code.
+
+proc sumOfSquares(n: int) {
+  var total = 0;
+  const scale = n / n;
+  for i in 1..n {
+    const s = scale * 2;
+    total += i * i * s / 2;
+  }
+  return total;
+}
+
+proc swapped((a, b): 2*int) {
+  var x = a, y = b;
+  ref rx = x;
+  const unused = x + y;
+  if false then rx = 0;
+  return (y, rx);
+}
+
+record R { var a, b: real; }
+
+proc scaled(r: R, f: real) {
+  var c = r;
+  c.a *= f;
+  c.b *= f;
+  return c;
+}
+
+writeln(sumOfSquares(10));
+writeln(swapped((1, 2)));
+writeln(scaled(new R(1.5, 2.5), 2.0));
+
+var A: [1..8] int;
+forall i in A.domain do A[i] = i * sumOfSquares(2);
+writeln(A);
@@ -0,0 +1 @@
+// This is not a real Chapel program
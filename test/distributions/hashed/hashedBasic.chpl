@@ -0,0 +1,42 @@
+use HashedDist;
+
+// Several target entries on the same locale still give each one its own
+// share of the indices.
+config const numTargets = 3;
+config const n = 1000;
+
+const targets: [1..numTargets] locale = Locales[numLocales-1];
+var D: domain(int) dmapped Hashed(idxType=int, targetLocales=targets);
+var A: [D] int;
+
+D += 7;
+A[7] = 70;
+
+// duplicates, and one index already in D
+var inds: [1..2*n] int;
+forall i in 1..2*n do
+  inds[i] = (i-1) % n + 1;
+writeln(D.bulkAdd(inds), " ", D.size);
+
+assert(A[7] == 70);
+for i in 1..n do
+  assert(D.member(i));
+assert(!D.member(0) && !D.member(n+1));
+
+// every target owns some of the indices
+const numOwned = [locDom in D._value.locDoms] locDom.myInds.size;
+writeln(+ reduce numOwned, " ", && reduce (numOwned > 0));
+
+forall i in D do
+  A[i] = i;
+forall (a, i) in zip(A, D) do
+  a += i;
+writeln(+ reduce A);
+
+for i in 1..n by 2 do
+  D -= i;
+const sorted = D.sorted();
+writeln(D.size, " ", + reduce A, " ", sorted[1..3]);
+
+D.clear();
+writeln(D.size);
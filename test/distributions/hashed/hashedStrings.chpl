@@ -0,0 +1,16 @@
+use HashedDist;
+
+// Counts words across all locales with a parSafe Hashed domain.
+var D: domain(string, parSafe=true) dmapped Hashed(idxType=string);
+var counts: [D] atomic int;
+
+const words = ["apple", "pear", "fig", "pear", "apple", "apple", "kiwi"];
+
+forall w in words with (ref D) do
+  D += w;
+
+forall w in words do
+  counts[w].add(1);
+
+for w in D.sorted() do
+  writeln(w, " ", counts[w].read(), " ", D.dist.idxToLocale(w) == counts[w].locale);
@@ -0,0 +1,38 @@
+// Adding many indices at once grows the table once and keeps the values
+// of arrays declared over the domain.
+
+config const n = 10000;
+
+var D: domain(int);
+var A: [D] int;
+
+D += [1, 2, 3];
+for i in D do
+  A[i] = -i;
+
+var inds: [1..n] int;
+forall i in 1..n do
+  inds[i] = (i * 7) % (n/2) + 1;     // every index twice
+
+const numAdded = D.bulkAdd(inds);
+writeln(numAdded, " ", D.size);
+
+for i in 1..3 do
+  assert(A[i] == -i);
+for i in 4..n/2 do
+  assert(D.member(i) && A[i] == 0);
+
+// the operator form, with nothing new
+D += [1, n/2];
+writeln(D.size);
+
+// strings on a parSafe domain
+var S: domain(string, parSafe=true);
+var strs: [1..100] string;
+for i in 1..100 do
+  strs[i] = "s" + (i % 10);
+writeln(S.bulkAdd(strs), " ", S.sorted());
+
+var E: domain(real);
+var none: [1..0] real;
+writeln(E.bulkAdd(none), " ", E.size);
@@ -0,0 +1,44 @@
+// Tasks add, remove and look up indices of a parSafe domain at the same
+// time, growing and shrinking the table as they go.
+
+config const n = 20000;
+config const numTasks = 8;
+
+var D: domain(int, parSafe=true);
+var A: [D] int;
+
+// overlapping adds from every task
+coforall t in 0..#numTasks with (ref D) {
+  for i in 1..n do
+    if i % numTasks == t || i % 3 == 0 then
+      D += i;
+}
+
+assert(D.size == n);
+
+for i in D do
+  A[i] = i;
+
+// remove the even indices while other tasks look up the odd ones
+coforall t in 0..#numTasks with (ref D) {
+  if t % 2 == 0 {
+    for i in 1..n do
+      if i % 2 == 0 && i % (numTasks/2) == t/2 then
+        D -= i;
+  } else {
+    for i in 1..n by 2 do
+      assert(D.member(i));
+  }
+}
+
+assert(D.size == n/2);
+
+for i in 1..n do
+  assert(D.member(i) == (i % 2 == 1));
+
+// values follow their indices through the resizes
+var sum = 0;
+for i in D do
+  sum += A[i] - i;
+
+writeln(D.size, " ", sum);
@@ -0,0 +1,43 @@
+// Accesses indexed by a forall's own index into arrays declared over the
+// iterated domain are rewritten to localAccess().
+use BlockDist, CyclicDist;
+
+config const n = 10;
+
+const D = {1..n} dmapped Block({1..n});
+var A, B, C: [D] real;
+
+forall i in D do B[i] = i;
+forall i in D do C[i] = 2*i;
+forall i in D do A[i] = B[i] + C[i];
+
+// Y is not known to be aligned with X
+proc f(X: [] real, Y: [] real) {
+  forall i in X.domain do X[i] = X[i] + Y[i];
+}
+
+f(A, B);
+writeln(A);
+
+// Cyclic arrays fall back on the regular accessor
+const D2 = {1..3, 1..3} dmapped Cyclic(startIdx=(1,1));
+var M: [D2] int;
+
+forall (i,j) in D2 do M[i,j] = i*10 + j;
+writeln(M);
+
+// and so do associative arrays
+var AD: domain(string);
+AD += "a";
+AD += "bb";
+var AA: [AD] int;
+
+forall k in AA.domain do AA[k] = k.length;
+writeln(+ reduce AA);
+
+// iterating over an array yields its elements, not its indices
+const P: [1..3] int = [3, 1, 2];
+var sum = 0;
+
+forall p in P with (+ reduce sum) do sum += P[p];
+writeln(sum);
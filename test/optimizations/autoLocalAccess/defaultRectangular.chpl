@@ -0,0 +1,9 @@
+// Local arrays have dsiLocalAccess() overloads for each return intent
+var A: [1..5] int;
+var B: [1..5] real = 0.5;
+
+forall i in A.domain do A[i] = i;
+forall i in B.domain do B[i] += A[i];
+
+writeln(A);
+writeln(B);
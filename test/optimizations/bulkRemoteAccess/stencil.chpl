@@ -0,0 +1,43 @@
+// Loops on another locale that access remote arrays at their index plus a
+// constant copy the elements they use in bulk.
+config const n = 8;
+
+var A: [0..n+1] int = [i in 0..n+1] i;
+var B, C: [1..n] int;
+var D: [1..n+3] int = 100;
+
+on Locales[numLocales-1] {
+  // read A, write B
+  for i in 1..n do B[i] = A[i-1] + A[i+1];
+
+  // read only
+  var sum = 0;
+  for i in 1..n do sum += A[i];
+  writeln(sum);
+
+  // read and write the same array
+  for i in 1..n do C[i] += B[i] * 2;
+
+  // writes with a gap: D[3] is not written when n is 2
+  for i in 1..2 {
+    D[i] = 1;
+    D[i+3] = 2;
+  }
+}
+
+writeln(B);
+writeln(C);
+writeln(D);
+
+// X and Y may be the same array
+proc shiftDown(X: [] int, Y: [] int) {
+  on Locales[numLocales-1] do
+    for i in 1..n-1 do X[i] = Y[i+1];
+}
+
+shiftDown(A, A);
+writeln(A);
+
+// a call in the body
+on Locales[numLocales-1] do
+  for i in 1..3 do writeln(A[i]);
@@ -0,0 +1,25 @@
+// Dead variable elimination uses each function's node index; --verify
+// checks that the index still matches the tree after every pass.
+
+proc outer(n: int) {
+  var unused = n * 2;
+
+  proc inner(x: int) {
+    var alsoUnused = x + 1;
+    return x * n;
+  }
+
+  var sum = 0;
+  for i in 1..n do
+    sum += inner(i);
+
+  return sum;
+}
+
+inline proc twice(x) {
+  var tmp = x;
+  return tmp + x;
+}
+
+writeln(outer(4));
+writeln(twice(21));
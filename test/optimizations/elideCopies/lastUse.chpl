@@ -0,0 +1,76 @@
+// Records initialized from a local that is not used again take over its
+// value; ones whose source is still needed, or whose copies can be
+// observed, are copied.
+
+record Pair {
+  var name: string;
+  var n:    int;
+}
+
+record Noisy {
+  var x: int;
+
+  proc init(x: int) {
+    this.x = x;
+  }
+
+  proc init(other: Noisy) {
+    this.x = other.x;
+    writeln("copy ", x);
+  }
+
+  proc deinit() {
+    writeln("deinit ", x);
+  }
+}
+
+proc itemName(i: int) {
+  var t = "item " + i:string;
+  var u = t;
+
+  return u;
+}
+
+proc stillUsed(i: int) {
+  var s = itemName(i);
+  var c = s;
+
+  c += "!";
+
+  return s.length + c.length;
+}
+
+proc refTaken(i: int) {
+  var s = itemName(i);
+  ref r = s;
+  var c = s;
+
+  c += "?";
+
+  return r.length + c.length;
+}
+
+proc pairs(i: int) {
+  var p = new Pair(itemName(i), i);
+  var q = p;
+
+  return q.name.length + q.n;
+}
+
+proc noisy() {
+  var a = new Noisy(1);
+  var b = a;
+}
+
+var total = 0;
+
+for i in 1..10 {
+  var s = itemName(i);
+  var c = s;
+
+  total += c.length + stillUsed(i) + refTaken(i) + pairs(i);
+}
+
+writeln(total);
+
+noisy();
@@ -0,0 +1,58 @@
+// Small functions that are not declared inline are inlined by the
+// compiler.  Inlining must keep the behavior of the call.
+
+record R {
+  var a, b: int;
+}
+
+// modifies its 'in' formal, which must not change the actual
+proc countDown(in n: int) {
+  var steps = 0;
+  while n > 0 {
+    n -= 1;
+    steps += 1;
+  }
+  return steps;
+}
+
+// modifies a field of a record passed by value
+proc swapped(in r: R) {
+  r.a <=> r.b;
+  return r;
+}
+
+// modifies its 'ref' formal, which must change the actual
+proc bump(ref x: int) {
+  x += 1;
+}
+
+// called from a single place
+proc sumOfSquares(n: int) {
+  var sum = 0;
+  for i in 1..n do
+    sum += i * i;
+  return sum;
+}
+
+// indexes a tuple with a value that is only known at run time
+proc pick(t: 3*int, i: int) {
+  return t(i);
+}
+
+var n = 5;
+writeln(countDown(n), " ", n);
+
+var r = new R(1, 2);
+writeln(swapped(r), " ", r);
+
+var total = 0;
+for i in 1..10 do
+  bump(total);
+writeln(total);
+
+writeln(sumOfSquares(n));
+
+const t = (10, 20, 30);
+for i in 1..3 do
+  write(pick(t, i), " ");
+writeln();
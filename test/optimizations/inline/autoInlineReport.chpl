@@ -0,0 +1,15 @@
+// --report-inlining lists the functions that were inlined automatically
+
+proc square(x: int) {
+  return x * x;
+}
+
+proc onlyCalledOnce(n: int) {
+  var sum = 0;
+  for i in 1..n do
+    sum += square(i);
+  return sum;
+}
+
+writeln(square(3));
+writeln(onlyCalledOnce(4));
@@ -0,0 +1,38 @@
+// Array metadata loads (A._instance, shiftedData, blk) can be hoisted
+// out of loops that cannot resize or reallocate the array.
+
+config const n = 4;
+
+var D = {1..n, 1..n};
+var A, B: [D] int;
+
+proc scale(ref A: [] int, const ref B: [] int) {
+  for i in 1..n do
+    for j in 1..n do
+      A[i,j] = B[i,j] * 2;
+}
+
+// storing through 'total' could change A's metadata as far as the
+// compiler knows, so nothing is hoisted here
+proc sum(const ref A: [] int, ref total: int) {
+  for i in 1..n do
+    for j in 1..n do
+      total += A[i,j];
+}
+
+for (i,j) in D do
+  B[i,j] = i*10 + j;
+
+scale(A, B);
+writeln(A);
+
+var total = 0;
+sum(A, total);
+writeln(total);
+
+// the domain changes inside this loop, so A's metadata does too
+for k in 1..2 {
+  D = {1..n+k, 1..n+k};
+  A[n+k, n+k] = k;
+}
+writeln(A);
@@ -0,0 +1,90 @@
+// Instances freed by the function that creates them go on the stack;
+// ones that are returned, stored or handed to a task stay on the heap.
+
+class Acc {
+  var sum:   int;
+  var count: int;
+
+  proc add(x: int) {
+    sum   += x;
+    count += 1;
+  }
+}
+
+class Node {
+  var val:  int;
+  var next: Node;
+}
+
+var keep: Acc;
+
+proc average(k: int) {
+  var a = new Acc();
+
+  for i in 1..k do
+    a.add(i);
+
+  const r = a.sum / a.count;
+
+  delete a;
+
+  return r;
+}
+
+proc makeAcc(k: int) {
+  var a = new Acc();
+
+  a.add(k);
+
+  return a;
+}
+
+proc keepAcc(k: int) {
+  var a = new Acc();
+
+  a.add(k);
+  keep = a;
+}
+
+proc linked(k: int) {
+  var head = new Node(k);
+  var tail = new Node(k + 1);
+
+  head.next = tail;
+
+  const r = head.val + head.next.val;
+
+  delete tail;
+  delete head;
+
+  return r;
+}
+
+proc inTask(k: int) {
+  var a = new Acc();
+
+  sync begin a.add(k);
+
+  const r = a.sum;
+
+  delete a;
+
+  return r;
+}
+
+var total = 0;
+
+for k in 1..100 do
+  total += average(k);
+
+const b = makeAcc(3);
+
+keepAcc(4);
+
+writeln(total);
+writeln(b.sum, " ", keep.sum);
+writeln(linked(5));
+writeln(inTask(6));
+
+delete b;
+delete keep;
@@ -0,0 +1,23 @@
+// Zippered iterators that are not inlined are run through iterator
+// classes, which only live for the duration of the loop.
+
+iter evens(n: int) {
+  for i in 1..n do
+    if i % 2 == 0 then yield i;
+}
+
+iter odds(n: int) {
+  for i in 1..n do
+    if i % 2 == 1 then yield i;
+}
+
+proc sumPairs(n: int) {
+  var total = 0;
+
+  for (e, o) in zip(evens(n), odds(n)) do
+    total += e * o;
+
+  return total;
+}
+
+writeln(sumPairs(10));
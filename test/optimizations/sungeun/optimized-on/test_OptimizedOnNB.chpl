@@ -0,0 +1,20 @@
+config const n = 10;
+
+var A: [1..n] int;
+
+// These on clauses return nothing, so they are not waited for
+on Locales[numLocales-1] {
+  for i in 1..n do
+    on Locales(0) do local { A(i) += i; }
+}
+
+writeln(A);
+
+// This one writes y, so its caller waits for it
+proc last() {
+  var y = 0;
+  on Locales(0) do local { y = A(n); }
+  return y;
+}
+
+writeln(last());
@@ -0,0 +1,32 @@
+//
+// Time a serial loop dominated by calls into small runtime functions
+// (allocation, task-private data, the node id) to compare programs
+// linked with and without link-time optimization.
+//
+
+use Time;
+
+config const n = 10000000;
+
+config param printTiming = true;
+
+class C {
+  var x: int;
+}
+
+var t: Timer;
+t.start();
+
+var sum = 0;
+for i in 1..n {
+  const c = new C(i);
+  sum += c.x + here.id;
+  delete c;
+}
+
+t.stop();
+
+writeln(sum == n*(n+1)/2);
+
+if printTiming then
+  writeln("Time: ", t.elapsed());
@@ -0,0 +1,21 @@
+// check which order independent loops are proven safe to vectorize
+
+config const n = 10;
+
+var A, B, C: [1..n] int;
+
+proc main() {
+  // each iteration touches its own elements
+  forall i in 1..n do A[i] = B[i] + 2 * C[i];
+  forall (a, b) in zip(A, B) do a = b + 1;
+  forall i in 1..n/2 do A[2*i] = A[2*i] + 1;
+
+  // reads an element that the first iteration writes
+  forall i in 1..n do A[i] = A[1];
+
+  // every iteration writes the same element
+  forall i in 1..n do B[1] = 7;
+
+  writeln(A);
+  writeln(B);
+}